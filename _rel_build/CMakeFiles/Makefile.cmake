@@ -0,0 +1,97 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/tests/CMakeLists.txt"
+  "/root/repo/tools/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tools/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "tests/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "tools/CMakeFiles/chronolog_decode.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_async.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_uart_dma.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_isr.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_policy.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_clock.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_line_write.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_transport.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_sinks.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_sinks_binary.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_registry.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_host_policies.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_file_sink.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_file_sink_pwrite.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_task_name.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_task_name_rtos.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_task_name_rtos_delete.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_printf.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_min_level.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_min_level_all.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_sample.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_suppress.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_ids.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_ids_collide.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_async.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_deferred.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_async_one_ring.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_format.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_printf.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_disabled.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_header.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_sinks.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_sample.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_suppress.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_time.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_file_sink.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_file_sink_pwrite.dir/DependInfo.cmake"
+  "tests/CMakeFiles/bench_writev.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_binary.dir/DependInfo.cmake"
+  "tests/CMakeFiles/test_binary_async.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_async_one_ring.dir/bench_async.o"
+  "CMakeFiles/bench_async_one_ring.dir/bench_async.o.d"
+  "bench_async_one_ring"
+  "bench_async_one_ring.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_async_one_ring.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_disabled.dir/bench_disabled.o"
+  "CMakeFiles/bench_disabled.dir/bench_disabled.o.d"
+  "bench_disabled"
+  "bench_disabled.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_disabled.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_file_sink_pwrite.dir/bench_file_sink.o"
+  "CMakeFiles/bench_file_sink_pwrite.dir/bench_file_sink.o.d"
+  "bench_file_sink_pwrite"
+  "bench_file_sink_pwrite.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_file_sink_pwrite.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
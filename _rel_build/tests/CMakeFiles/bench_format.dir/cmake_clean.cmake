@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_format.dir/bench_format.o"
+  "CMakeFiles/bench_format.dir/bench_format.o.d"
+  "bench_format"
+  "bench_format.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_format.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_header.dir/bench_header.o"
+  "CMakeFiles/bench_header.dir/bench_header.o.d"
+  "bench_header"
+  "bench_header.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_header.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_printf.dir/bench_format.o"
+  "CMakeFiles/bench_printf.dir/bench_format.o.d"
+  "bench_printf"
+  "bench_printf.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_printf.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_sample.dir/bench_sample.o"
+  "CMakeFiles/bench_sample.dir/bench_sample.o.d"
+  "bench_sample"
+  "bench_sample.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_sample.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
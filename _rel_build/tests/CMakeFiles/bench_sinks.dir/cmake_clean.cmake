@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_sinks.dir/bench_sinks.o"
+  "CMakeFiles/bench_sinks.dir/bench_sinks.o.d"
+  "bench_sinks"
+  "bench_sinks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_sinks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_suppress.dir/bench_suppress.o"
+  "CMakeFiles/bench_suppress.dir/bench_suppress.o.d"
+  "bench_suppress"
+  "bench_suppress.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_suppress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
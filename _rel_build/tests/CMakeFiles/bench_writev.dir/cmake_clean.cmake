@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/bench_writev.dir/bench_writev.o"
+  "CMakeFiles/bench_writev.dir/bench_writev.o.d"
+  "bench_writev"
+  "bench_writev.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench_writev.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
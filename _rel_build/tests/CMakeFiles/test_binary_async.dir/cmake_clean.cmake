@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_binary_async.dir/test_binary.o"
+  "CMakeFiles/test_binary_async.dir/test_binary.o.d"
+  "test_binary_async"
+  "test_binary_async.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_binary_async.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
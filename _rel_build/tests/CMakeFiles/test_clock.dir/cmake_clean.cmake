@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_clock.dir/test_clock.o"
+  "CMakeFiles/test_clock.dir/test_clock.o.d"
+  "test_clock"
+  "test_clock.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_clock.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
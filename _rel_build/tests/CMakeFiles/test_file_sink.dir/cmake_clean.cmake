@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_file_sink.dir/test_file_sink.o"
+  "CMakeFiles/test_file_sink.dir/test_file_sink.o.d"
+  "test_file_sink"
+  "test_file_sink.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_file_sink.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_file_sink_pwrite.dir/test_file_sink.o"
+  "CMakeFiles/test_file_sink_pwrite.dir/test_file_sink.o.d"
+  "test_file_sink_pwrite"
+  "test_file_sink_pwrite.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_file_sink_pwrite.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_host_policies.dir/test_host_policies.o"
+  "CMakeFiles/test_host_policies.dir/test_host_policies.o.d"
+  "test_host_policies"
+  "test_host_policies.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_host_policies.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
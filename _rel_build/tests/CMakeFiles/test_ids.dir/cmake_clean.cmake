@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_ids.dir/test_ids.o"
+  "CMakeFiles/test_ids.dir/test_ids.o.d"
+  "CMakeFiles/test_ids.dir/test_ids_peer.o"
+  "CMakeFiles/test_ids.dir/test_ids_peer.o.d"
+  "test_ids"
+  "test_ids.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_ids.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,20 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/test_ids.cpp" "tests/CMakeFiles/test_ids_collide.dir/test_ids.o" "gcc" "tests/CMakeFiles/test_ids_collide.dir/test_ids.o.d"
+  "/root/repo/tests/test_ids_peer.cpp" "tests/CMakeFiles/test_ids_collide.dir/test_ids_peer.o" "gcc" "tests/CMakeFiles/test_ids_collide.dir/test_ids_peer.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
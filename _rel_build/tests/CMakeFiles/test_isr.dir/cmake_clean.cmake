@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_isr.dir/test_isr.o"
+  "CMakeFiles/test_isr.dir/test_isr.o.d"
+  "test_isr"
+  "test_isr.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_isr.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
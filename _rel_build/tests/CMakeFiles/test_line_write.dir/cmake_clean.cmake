@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_line_write.dir/test_line_write.o"
+  "CMakeFiles/test_line_write.dir/test_line_write.o.d"
+  "test_line_write"
+  "test_line_write.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_line_write.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
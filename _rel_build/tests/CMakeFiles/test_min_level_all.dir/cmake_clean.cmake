@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_min_level_all.dir/test_min_level.o"
+  "CMakeFiles/test_min_level_all.dir/test_min_level.o.d"
+  "test_min_level_all"
+  "test_min_level_all.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_min_level_all.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
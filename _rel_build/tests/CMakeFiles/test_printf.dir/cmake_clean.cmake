@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_printf.dir/test_printf.o"
+  "CMakeFiles/test_printf.dir/test_printf.o.d"
+  "test_printf"
+  "test_printf.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_printf.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_registry.dir/test_registry.o"
+  "CMakeFiles/test_registry.dir/test_registry.o.d"
+  "test_registry"
+  "test_registry.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_registry.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_sinks.dir/test_sinks.o"
+  "CMakeFiles/test_sinks.dir/test_sinks.o.d"
+  "test_sinks"
+  "test_sinks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_sinks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
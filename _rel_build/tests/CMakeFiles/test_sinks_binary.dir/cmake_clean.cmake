@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_sinks_binary.dir/test_sinks.o"
+  "CMakeFiles/test_sinks_binary.dir/test_sinks.o.d"
+  "test_sinks_binary"
+  "test_sinks_binary.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_sinks_binary.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_suppress.dir/test_suppress.o"
+  "CMakeFiles/test_suppress.dir/test_suppress.o.d"
+  "test_suppress"
+  "test_suppress.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_suppress.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
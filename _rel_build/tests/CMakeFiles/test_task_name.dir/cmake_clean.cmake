@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_task_name.dir/test_task_name.o"
+  "CMakeFiles/test_task_name.dir/test_task_name.o.d"
+  "test_task_name"
+  "test_task_name.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_task_name.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
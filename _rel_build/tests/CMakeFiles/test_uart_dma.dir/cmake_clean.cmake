@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/test_uart_dma.dir/test_uart_dma.o"
+  "CMakeFiles/test_uart_dma.dir/test_uart_dma.o.d"
+  "test_uart_dma"
+  "test_uart_dma.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test_uart_dma.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
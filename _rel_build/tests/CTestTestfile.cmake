@@ -0,0 +1,90 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_rel_build/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(test_async "/root/repo/_rel_build/tests/test_async")
+set_tests_properties(test_async PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;30;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_uart_dma "/root/repo/_rel_build/tests/test_uart_dma")
+set_tests_properties(test_uart_dma PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;31;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_isr "/root/repo/_rel_build/tests/test_isr")
+set_tests_properties(test_isr PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;33;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_policy "/root/repo/_rel_build/tests/test_policy")
+set_tests_properties(test_policy PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;34;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_clock "/root/repo/_rel_build/tests/test_clock")
+set_tests_properties(test_clock PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;35;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_line_write "/root/repo/_rel_build/tests/test_line_write")
+set_tests_properties(test_line_write PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;36;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_transport "/root/repo/_rel_build/tests/test_transport")
+set_tests_properties(test_transport PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;37;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_sinks "/root/repo/_rel_build/tests/test_sinks")
+set_tests_properties(test_sinks PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;38;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_sinks_binary "/root/repo/_rel_build/tests/test_sinks_binary")
+set_tests_properties(test_sinks_binary PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;39;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_registry "/root/repo/_rel_build/tests/test_registry")
+set_tests_properties(test_registry PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;40;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_host_policies "/root/repo/_rel_build/tests/test_host_policies")
+set_tests_properties(test_host_policies PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;41;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_file_sink "/root/repo/_rel_build/tests/test_file_sink")
+set_tests_properties(test_file_sink PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;42;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_file_sink_pwrite "/root/repo/_rel_build/tests/test_file_sink_pwrite")
+set_tests_properties(test_file_sink_pwrite PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;43;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_task_name "/root/repo/_rel_build/tests/test_task_name")
+set_tests_properties(test_task_name PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;44;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_task_name_rtos "/root/repo/_rel_build/tests/test_task_name_rtos")
+set_tests_properties(test_task_name_rtos PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;51;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_task_name_rtos_delete "/root/repo/_rel_build/tests/test_task_name_rtos_delete")
+set_tests_properties(test_task_name_rtos_delete PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;51;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_printf "/root/repo/_rel_build/tests/test_printf")
+set_tests_properties(test_printf PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;55;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_min_level "/root/repo/_rel_build/tests/test_min_level")
+set_tests_properties(test_min_level PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;56;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_min_level_all "/root/repo/_rel_build/tests/test_min_level_all")
+set_tests_properties(test_min_level_all PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;57;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_min_level_size "/usr/bin/cmake" "-DFILTERED=/root/repo/_rel_build/tests/test_min_level" "-DFULL=/root/repo/_rel_build/tests/test_min_level_all" "-DOBJDUMP=/usr/bin/objdump" "-P" "/root/repo/tests/min_level_size.cmake")
+set_tests_properties(test_min_level_size PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;60;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_sample "/root/repo/_rel_build/tests/test_sample")
+set_tests_properties(test_sample PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;63;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_suppress "/root/repo/_rel_build/tests/test_suppress")
+set_tests_properties(test_suppress PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;64;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_ids "/root/repo/_rel_build/tests/test_ids")
+set_tests_properties(test_ids PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;65;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_ids_collide "/root/repo/_rel_build/tests/test_ids_collide")
+set_tests_properties(test_ids_collide PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;14;add_test;/root/repo/tests/CMakeLists.txt;66;chronolog_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_ids_check "/root/repo/_rel_build/tools/chronolog_decode" "--check-ids" "-e" "/root/repo/_rel_build/tests/test_ids")
+set_tests_properties(test_ids_check PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;68;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_ids_check_collide "/root/repo/_rel_build/tools/chronolog_decode" "--check-ids" "-e" "/root/repo/_rel_build/tests/test_ids_collide")
+set_tests_properties(test_ids_check_collide PROPERTIES  WILL_FAIL "TRUE" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;69;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_async "/root/repo/_rel_build/tests/bench_async")
+set_tests_properties(bench_async PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;73;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_deferred "/root/repo/_rel_build/tests/bench_deferred")
+set_tests_properties(bench_deferred PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;74;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_async_one_ring "/root/repo/_rel_build/tests/bench_async_one_ring")
+set_tests_properties(bench_async_one_ring PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;75;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_format "/root/repo/_rel_build/tests/bench_format")
+set_tests_properties(bench_format PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;76;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_printf "/root/repo/_rel_build/tests/bench_printf")
+set_tests_properties(bench_printf PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;77;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_disabled "/root/repo/_rel_build/tests/bench_disabled")
+set_tests_properties(bench_disabled PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;78;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_header "/root/repo/_rel_build/tests/bench_header")
+set_tests_properties(bench_header PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;79;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_sinks "/root/repo/_rel_build/tests/bench_sinks")
+set_tests_properties(bench_sinks PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;80;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_sample "/root/repo/_rel_build/tests/bench_sample")
+set_tests_properties(bench_sample PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;81;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_suppress "/root/repo/_rel_build/tests/bench_suppress")
+set_tests_properties(bench_suppress PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;82;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_time "/root/repo/_rel_build/tests/bench_time")
+set_tests_properties(bench_time PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;83;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_file_sink "/root/repo/_rel_build/tests/bench_file_sink")
+set_tests_properties(bench_file_sink PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;84;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_file_sink_pwrite "/root/repo/_rel_build/tests/bench_file_sink_pwrite")
+set_tests_properties(bench_file_sink_pwrite PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;85;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(bench_writev "/root/repo/_rel_build/tests/bench_writev")
+set_tests_properties(bench_writev PROPERTIES  LABELS "bench" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;26;add_test;/root/repo/tests/CMakeLists.txt;86;chronolog_bench;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_binary "/usr/bin/cmake" "-DENCODER=/root/repo/_rel_build/tests/test_binary" "-DDECODER=/root/repo/_rel_build/tools/chronolog_decode" "-DOBJDUMP=/usr/bin/objdump" "-DWORK=/root/repo/_rel_build/tests/test_binary.d" "-P" "/root/repo/tests/binary_roundtrip.cmake")
+set_tests_properties(test_binary PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;102;add_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test(test_binary_async "/usr/bin/cmake" "-DENCODER=/root/repo/_rel_build/tests/test_binary_async" "-DDECODER=/root/repo/_rel_build/tools/chronolog_decode" "-DOBJDUMP=/usr/bin/objdump" "-DWORK=/root/repo/_rel_build/tests/test_binary_async.d" "-P" "/root/repo/tests/binary_roundtrip.cmake")
+set_tests_properties(test_binary_async PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;102;add_test;/root/repo/tests/CMakeLists.txt;0;")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/chronolog_decode.dir/chronolog_decode.o"
+  "CMakeFiles/chronolog_decode.dir/chronolog_decode.o.d"
+  "chronolog_decode"
+  "chronolog_decode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/chronolog_decode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -49,6 +49,8 @@
       defined(STM32L0) || defined(STM32L1) || defined(STM32L4) || defined(STM32L5) || \
       defined(STM32WB) || defined(STM32WL)
   #define CHRONOLOG_PLATFORM_STM32_HAL
+#elif defined(__unix__) || defined(__APPLE__)
+  #define CHRONOLOG_PLATFORM_POSIX
 #endif
 
 #if defined(CHRONOLOG_PLATFORM_ARDUINO)
@@ -57,13 +59,17 @@
   #define CHRONOLOG_ESP
   #include <freertos/task.h>
   #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
 #endif
 #elif defined(CHRONOLOG_PLATFORM_ESP_IDF)
   #include <time.h>
+  #include <string.h>
   #include <esp_log.h>
+  #include <esp_timer.h>
   #include <sys/time.h>
   #include <freertos/task.h>
   #include <freertos/FreeRTOS.h>
+  #include <freertos/semphr.h>
 #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
   extern "C" {
     #include <time.h>
@@ -83,12 +89,230 @@
 #if defined(osCMSIS) || defined(FREERTOS)
   #define CHRONOLOG_STM32_FREERTOS
   #include "cmsis_os.h"
+  #include "semphr.h"
+#endif
+#elif defined(CHRONOLOG_PLATFORM_POSIX)
+  #include <time.h>
+  #include <stdio.h>
+  #include <stdlib.h>
+  #include <stdarg.h>
+  #include <string.h>
+  #include <errno.h>
+  #include <unistd.h>
+  #include <pthread.h>
+  #include <sys/uio.h>
+  #include <sys/time.h>
+  #include <fcntl.h>
+  #include <mutex>
+  #include <chrono>
+  #include <thread>
+  #include <condition_variable>
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #include <linux/io_uring.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+  #define CHRONOLOG_HAS_URING
+#endif
+#endif
+#endif
+#endif
+
+
+#ifndef CHRONOLOG_MODE
+  #define CHRONOLOG_MODE              1
+#endif
+#ifndef CHRONOLOG_MIN_LEVEL
+  #define CHRONOLOG_MIN_LEVEL         CHRONOLOG_LEVEL_DEBUG                                             // Floor for CHRONOLOG_DEBUG()..CHRONOLOG_FATAL(), read at each call
+#endif
+#ifndef CHRONOLOG_BUFFER_LEN
+  #define CHRONOLOG_BUFFER_LEN        256
+#endif
+
+#ifndef CHRONOLOG_UART_TIMEOUT_MS
+  #define CHRONOLOG_UART_TIMEOUT_MS   0xFFFFFFFFu                                                       // Blocking STM32 transmit, the default is HAL_MAX_DELAY
+#endif
+#ifndef CHRONOLOG_STM32_UART_DMA
+  #define CHRONOLOG_STM32_UART_DMA    0                                                                 // 1: non-blocking DMA/IT transmit on STM32
+#endif
+#ifndef CHRONOLOG_UART_TX_BUF_LEN
+  #define CHRONOLOG_UART_TX_BUF_LEN   256                                                               // Bytes per ping-pong buffer
+#endif
+#ifndef CHRONOLOG_UART_TX_PORTS
+  #define CHRONOLOG_UART_TX_PORTS     1                                                                 // Distinct UARTs served by the DMA transport
+#endif
+#ifndef CHRONOLOG_UART_TX_WAIT_MS
+  #define CHRONOLOG_UART_TX_WAIT_MS   1000                                                              // Longest a full DMA transport waits without progress
+#endif
+#ifndef CHRONOLOG_POSIX_FD
+  #define CHRONOLOG_POSIX_FD          1                                                                 // POSIX: descriptor written with writev(2); -1 goes through stdio
+#endif
+#ifndef CHRONOLOG_FILE_BUFFER_LEN
+  #define CHRONOLOG_FILE_BUFFER_LEN   (256 * 1024)                                                      // ChronoLogFileSink: bytes per write to the file
+#endif
+#ifndef CHRONOLOG_FILE_BUFFERS
+  #define CHRONOLOG_FILE_BUFFERS      4                                                                 // Buffers filling or in flight; lines are refused when all are busy
+#endif
+#ifndef CHRONOLOG_FILE_FLUSH_MS
+  #define CHRONOLOG_FILE_FLUSH_MS     250                                                               // A partly filled buffer goes out after this long
+#endif
+#ifndef CHRONOLOG_FILE_URING
+  #define CHRONOLOG_FILE_URING        1                                                                 // 0: always use the pwrite() writer thread
+#endif
+
+#ifndef CHRONOLOG_ASYNC
+  #define CHRONOLOG_ASYNC             0                                                                 // 1: queue lines, write them from a drain task
+#endif
+#ifndef CHRONOLOG_ASYNC_QUEUE_LEN
+  #define CHRONOLOG_ASYNC_QUEUE_LEN   32                                                                // Slots, must be a power of two
+#endif
+#ifndef CHRONOLOG_ASYNC_LINE_LEN
+  #define CHRONOLOG_ASYNC_LINE_LEN    160                                                               // Longer lines are truncated
+#endif
+#ifndef CHRONOLOG_ASYNC_POLICY
+  #define CHRONOLOG_ASYNC_POLICY      CHRONOLOG_POLICY_DROP_NEWEST                                      // What a full ring does, see ChronoLogPolicy
+#endif
+#ifndef CHRONOLOG_ASYNC_BLOCK_MS
+  #define CHRONOLOG_ASYNC_BLOCK_MS    10                                                                // Longest wait under CHRONOLOG_POLICY_BLOCK_TIMEOUT
+#endif
+#ifndef CHRONOLOG_ASYNC_KEEP_LEVEL
+  #define CHRONOLOG_ASYNC_KEEP_LEVEL  CHRONOLOG_LEVEL_WARN                                              // Least severe level kept by CHRONOLOG_POLICY_DROP_BELOW
+#endif
+#ifndef CHRONOLOG_ASYNC_BATCH                                                                          // Lines the drain hands to the transport at once
+#if defined(CHRONOLOG_PLATFORM_POSIX)
+  #define CHRONOLOG_ASYNC_BATCH       16                                                                // One writev(2) per batch
+#else
+  #define CHRONOLOG_ASYNC_BATCH       1                                                                 // Each line is copied to the drain task's stack
+#endif
+#endif
+#ifndef CHRONOLOG_ASYNC_CORES                                                                          // One ring per core, merged by timestamp when drained
+#if (defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(ESP32)) && defined(portNUM_PROCESSORS)
+  #define CHRONOLOG_ASYNC_CORES       portNUM_PROCESSORS
+#elif defined(CHRONOLOG_PLATFORM_POSIX) && defined(__linux__)
+  #define CHRONOLOG_ASYNC_CORES       4                                                                 // CPUs beyond this share rings
+#else
+  #define CHRONOLOG_ASYNC_CORES       1
+#endif
+#endif
+#ifndef CHRONOLOG_ASYNC_TASK_STACK                                                                     // Bytes on ESP/Zephyr, words on FreeRTOS elsewhere
+#if defined(ESP_PLATFORM) || defined(ESP32)
+  #define CHRONOLOG_ASYNC_TASK_STACK  3072
+#elif defined(__ZEPHYR__)
+  #define CHRONOLOG_ASYNC_TASK_STACK  1024
+#else
+  #define CHRONOLOG_ASYNC_TASK_STACK  256
+#endif
+#endif
+#ifndef CHRONOLOG_ASYNC_TASK_PRIO
+  #define CHRONOLOG_ASYNC_TASK_PRIO   1
+#endif
+
+#ifndef CHRONOLOG_ISR
+  #define CHRONOLOG_ISR               0                                                                 // 1: enable the interrupt-safe *FromISR entry points
+#endif
+#ifndef CHRONOLOG_ISR_QUEUE_LEN
+  #define CHRONOLOG_ISR_QUEUE_LEN     16                                                                // Records, must be a power of two
+#endif
+
+#ifndef CHRONOLOG_DEFERRED
+  #define CHRONOLOG_DEFERRED          0                                                                 // 1: async mode captures raw arguments, the drain task formats
+#endif
+#ifndef CHRONOLOG_DEFERRED_QUEUE_LEN
+  #define CHRONOLOG_DEFERRED_QUEUE_LEN 32                                                               // Records, must be a power of two
+#endif
+#ifndef CHRONOLOG_RECORD_ARG_BYTES
+  #define CHRONOLOG_RECORD_ARG_BYTES  48                                                                // Captured argument bytes per ISR/deferred record
+#endif
+
+#ifndef CHRONOLOG_BINARY
+  #define CHRONOLOG_BINARY            0                                                                 // 1: emit tokenized binary frames instead of text
+#endif
+#ifndef CHRONOLOG_BINARY_STRINGS
+  #define CHRONOLOG_BINARY_STRINGS    32                                                                // Module/task/format strings sent once by id
+#endif
+
+#ifndef CHRONOLOG_PRINTF
+  #define CHRONOLOG_PRINTF            0                                                                 // 1: built-in printf formatter instead of vsnprintf
+#endif
+
+#ifndef CHRONOLOG_CALLSITES
+  #define CHRONOLOG_CALLSITES         0                                                                 // 1: count hits per CHRONOLOG_LOG() call site
+#endif
+
+#ifndef CHRONOLOG_SUPPRESS
+  #define CHRONOLOG_SUPPRESS          0                                                                 // 1: collapse repeated lines, rate-limit CHRONOLOG_LIMIT() sites
+#endif
+#ifndef CHRONOLOG_LIMIT_RATE
+  #define CHRONOLOG_LIMIT_RATE        10                                                                // Default lines per second per CHRONOLOG_LIMIT() site, 1..1000
+#endif
+#ifndef CHRONOLOG_LIMIT_BURST
+  #define CHRONOLOG_LIMIT_BURST       20                                                                // Default lines a quiet site may log back to back
+#endif
+#ifndef CHRONOLOG_REPEAT_FLUSH_MS
+  #define CHRONOLOG_REPEAT_FLUSH_MS   1000                                                              // A line that keeps repeating is summarised this often
+#endif
+#ifndef CHRONOLOG_REPEAT_KEY_LEN
+  #define CHRONOLOG_REPEAT_KEY_LEN    64                                                                // Bytes of level, format and arguments kept to spot a repeat
+#endif
+#ifndef CHRONOLOG_CHANGE_VALUE_LEN
+  #define CHRONOLOG_CHANGE_VALUE_LEN  32                                                                // Bytes of the last value kept per CHRONOLOG_ON_CHANGE() site
+#endif
+#ifndef CHRONOLOG_TASK_TLS_INDEX
+  #define CHRONOLOG_TASK_TLS_INDEX    0                                                                 // FreeRTOS TLS slot for the cached task name (STM32)
 #endif
+#ifndef CHRONOLOG_TASK_SLOTS
+  #define CHRONOLOG_TASK_SLOTS        8                                                                 // Cached task names on STM32 and Zephyr custom data, no heap
 #endif
 
+#ifndef CHRONOLOG_MAX_SINKS
+  #define CHRONOLOG_MAX_SINKS         4                                                                 // ChronoLogSinks::add() slots, besides the platform output
+#endif
+#ifndef CHRONOLOG_MAX_RULES
+  #define CHRONOLOG_MAX_RULES         8                                                                 // Entries in a ChronoLogRegistry::setRules() spec
+#endif
+
+#ifndef CHRONOLOG_RULE_LEN
+  #define CHRONOLOG_RULE_LEN          32                                                                // Longest rule pattern, including the terminator
+#endif
+
+#define CHRONOLOG_TIME_HMS            0                                                                 // 12:34:56
+#define CHRONOLOG_TIME_HMS_MS         1                                                                 // 12:34:56.789
+#define CHRONOLOG_TIME_DELTA          2                                                                 // +     1234us since the previous line
+#define CHRONOLOG_TIME_TICKS          3                                                                 // Monotonic microseconds since boot
+#ifndef CHRONOLOG_TIME_FORMAT
+  #define CHRONOLOG_TIME_FORMAT       CHRONOLOG_TIME_HMS
+#endif
+
+#if CHRONOLOG_DEFERRED && !CHRONOLOG_ASYNC
+  #error "CHRONOLOG_DEFERRED requires CHRONOLOG_ASYNC"
+#endif
 
-#define CHRONOLOG_MODE          1
-#define CHRONOLOG_BUFFER_LEN    256
+#include <stdint.h>
+#include <stddef.h>
+#if CHRONOLOG_ASYNC || CHRONOLOG_ISR || CHRONOLOG_BINARY || CHRONOLOG_CALLSITES || CHRONOLOG_SUPPRESS
+  #include <atomic>
+#endif
+#if CHRONOLOG_ASYNC || CHRONOLOG_ISR || CHRONOLOG_BINARY || CHRONOLOG_PRINTF || __cplusplus >= 201703L
+  #include <type_traits>
+#endif
+#if defined(__has_include)
+#if __has_include(<atomic>)
+  #include <atomic>
+  #define CHRONOLOG_HAS_ATOMIC                                                                          // Missing on AVR, which has no preemptive tasks to race with
+#endif
+#endif
+#if CHRONOLOG_ASYNC
+#if defined(CHRONOLOG_PLATFORM_POSIX)
+  #include <mutex>
+  #include <chrono>
+  #include <thread>
+  #include <condition_variable>
+#if defined(__linux__)
+  #include <sched.h>
+#endif
+#endif
+#endif
 
 #define CHRONOLOG_COLOR_INFO    "\033[92m"
 #define CHRONOLOG_COLOR_WARN    "\033[93m"
@@ -97,6 +321,21 @@
 #define CHRONOLOG_COLOR_DEBUG   "\033[94m"
 #define CHRONOLOG_COLOR_FATAL   "\033[95m"
 
+#if defined(CHRONOLOG_PLATFORM_ARDUINO)
+  #define CHRONOLOG_EOL         "\r\n"                                                                   // What Serial.println() terminates lines with
+#else
+  #define CHRONOLOG_EOL         "\n"
+#endif
+#define CHRONOLOG_HEADER_LEN    96                                                                      // Room for the "time | module | level | task | " prefix
+
+#if defined(__GNUC__)
+  #define CHRONOLOG_INLINE      __attribute__((always_inline))                                          // Level checks stay at the call site, also at -Os
+  #define CHRONOLOG_COLD        __attribute__((cold))                                                   // Keeps one-time slow paths out of inlined fast paths
+#else
+  #define CHRONOLOG_INLINE
+  #define CHRONOLOG_COLD
+#endif
+
 enum ChronoLogLevel {
   CHRONOLOG_LEVEL_NONE,
   CHRONOLOG_LEVEL_FATAL,
@@ -106,203 +345,4837 @@ enum ChronoLogLevel {
   CHRONOLOG_LEVEL_DEBUG
 };
 
+/*
+ * Compile-time string ids. CHRONOLOG_ID("literal") is the 32-bit FNV-1a hash of the literal, folded
+ * by the compiler, so equal strings get equal ids in every translation unit and the id can serve as
+ * a stable key for external tooling. Each CHRONOLOG_LOG(), CHRONOLOG_LIMIT() and CHRONOLOG_FMT() format
+ * and each CHRONOLOG_MODULE() name also stores its id next to a second, independent hash in the
+ * "chronolog_ids" section; two entries with the same id but different check hashes are distinct
+ * strings that collide. ChronoLogIds::collisions() finds them at startup and
+ * `chronolog_decode --check-ids -e firmware.elf` (or chronolog_check_ids() in CMake) after linking.
+ */
+constexpr uint32_t chronoLogHash(const char* s, uint32_t h = 2166136261u) {
+  return *s ? chronoLogHash(s + 1, (h ^ (uint8_t)*s) * 16777619u) : h;
+}
+
+constexpr uint32_t chronoLogCheckHash(const char* s, uint32_t h = 5381u) {                            // djb2, only tells colliding strings apart
+  return *s ? chronoLogCheckHash(s + 1, (h * 33u) ^ (uint8_t)*s) : h;
+}
+
+template <uint32_t Id>
+struct ChronoLogId { static constexpr uint32_t value = Id; };
+
+#define CHRONOLOG_ID(s) (ChronoLogId<chronoLogHash(s)>::value)
+
+struct ChronoLogIdEntry {
+  uint32_t id;
+  uint32_t check;
+};
+
+#if defined(__ELF__) && defined(__GNUC__)
+extern "C" const ChronoLogIdEntry __start_chronolog_ids[] __attribute__((weak));
+extern "C" const ChronoLogIdEntry __stop_chronolog_ids[]  __attribute__((weak));
+
+#define CHRONOLOG_ID_ENTRY_AS(var, s)                                                                 \
+  static const ChronoLogIdEntry var __attribute__((section("chronolog_ids"), used)) =                 \
+    {CHRONOLOG_ID(s), ChronoLogId<chronoLogCheckHash(s)>::value}
+#define CHRONOLOG_ID_ENTRY(s) CHRONOLOG_ID_ENTRY_AS(chronolog_id_entry, s)
+#define CHRONOLOG_MODULE_ID(s) CHRONOLOG_ID_ENTRY_AS(CHRONOLOG_CAT(chronolog_module_id_, __COUNTER__), s)
+#else
+#define CHRONOLOG_ID_ENTRY(s) (void)0
+#define CHRONOLOG_MODULE_ID(s) static_assert(true, "")
+#endif
+
+#define CHRONOLOG_CAT_(a, b) a##b
+#define CHRONOLOG_CAT(a, b)  CHRONOLOG_CAT_(a, b)
+
+// Defines a logger at namespace scope and registers its name, which must be a string literal, in
+// chronolog_ids: CHRONOLOG_MODULE(ChronoLogger, radio, "radio", CHRONOLOG_LEVEL_INFO);
+#define CHRONOLOG_MODULE(type, var, ...)                                                              \
+  CHRONOLOG_MODULE_ID(CHRONOLOG_FIRST(__VA_ARGS__));                                                  \
+  type var(__VA_ARGS__)
+
+struct ChronoLogIds {
+  // Entries whose id is shared with a different string; 0 when the section is not available.
+  static size_t collisions() {
+    size_t found = 0;
+  #if defined(__ELF__) && defined(__GNUC__)
+    if (!__start_chronolog_ids) return 0;
+    for (const ChronoLogIdEntry* a = __start_chronolog_ids; a < __stop_chronolog_ids; a++) {
+      for (const ChronoLogIdEntry* b = __start_chronolog_ids; b < a; b++) {
+        if (a->id == b->id && a->check != b->check) {
+          found++;
+          break;
+        }
+      }
+    }
+  #endif
+    return found;
+  }
+};
+
+#if CHRONOLOG_CALLSITES
+
+#define CHRONOLOG_SITE_HIT(s)                                                                         \
+  do {                                                                                                \
+    static ChronoLogSite chronolog_site(CHRONOLOG_ID(s), s);                                          \
+    chronolog_site.hit();                                                                             \
+  } while (0)
+#else
+#define CHRONOLOG_SITE_HIT(s) (void)0
+#endif // CHRONOLOG_CALLSITES
+
+#if __cplusplus >= 201703L
+struct ChronoLogFmtTag {};
+
+template <typename F>
+using ChronoLogIfFmt = typename std::enable_if<std::is_base_of<ChronoLogFmtTag, F>::value>::type;
+
+// Wraps a {}-style format literal in its own type so it can be parsed at compile time.
+#define CHRONOLOG_FMT(s)                                                                              \
+  ([] {                                                                                               \
+    CHRONOLOG_ID_ENTRY(s);                                                                            \
+    struct ChronoLogFmtString : ChronoLogFmtTag {                                                     \
+      static constexpr const char* text() { return s; }                                               \
+    };                                                                                                \
+    return ChronoLogFmtString{};                                                                      \
+  }())
+#endif
+
+#define CHRONOLOG_FIRST_(first, ...) first
+#define CHRONOLOG_FIRST(...)         CHRONOLOG_FIRST_(__VA_ARGS__, 0)
+
+// logger.log() with a compile-time id for the format, which must be a string literal. Binary ELF
+// builds also move the literal into the chronolog_fmt section, see CHRONOLOG_STR().
+#if CHRONOLOG_BINARY && defined(__ELF__)
+#define CHRONOLOG_LOG_CALL(logger, level, ...)                                                        \
+  (logger).logSite(CHRONOLOG_STR(CHRONOLOG_FIRST(__VA_ARGS__)), level, __VA_ARGS__)
+#else
+#define CHRONOLOG_LOG_CALL(logger, level, ...) (logger).log(level, __VA_ARGS__)
+#endif
+
+#if CHRONOLOG_MODE
+#define CHRONOLOG_LOG(logger, level, ...)                                                             \
+  do {                                                                                                \
+    CHRONOLOG_ID_ENTRY(CHRONOLOG_FIRST(__VA_ARGS__));                                                 \
+    if ((logger).enabled(level)) {                                                                    \
+      CHRONOLOG_SITE_HIT(CHRONOLOG_FIRST(__VA_ARGS__));                                               \
+      CHRONOLOG_LOG_CALL(logger, level, __VA_ARGS__);                                                 \
+    }                                                                                                 \
+  } while (0)
+#else
+#define CHRONOLOG_LOG(logger, level, ...) do {} while (0)
+#endif
+
+/*
+ * Compile-time level filter. The call is wrapped in a lambda that ChronoLogGate<false> never invokes,
+ * so a call above CHRONOLOG_MIN_LEVEL is type-checked but no code, argument evaluation or string
+ * literal is emitted for it, even at -O0. CHRONOLOG_MIN_LEVEL is expanded at the call site: redefine it
+ * after the include to give one file (module) its own floor.
+ */
+template <bool On>
+struct ChronoLogGate {
+  template <typename F> static void run(const F& call) { call(); }
+};
+
+template <>
+struct ChronoLogGate<false> {
+  template <typename F> static void run(const F&) {}
+};
+
+// Message text returned by the callables passed to the lazy logger.debug([&] { ... }) overloads.
+inline const char* chronoLogText(const char* text) { return text; }
+
+template <typename S>
+auto chronoLogText(const S& text) -> decltype(text.c_str()) { return text.c_str(); }
+
 #if CHRONOLOG_MODE
+#define CHRONOLOG_AT(logger, level, ...)                                                              \
+  ChronoLogGate<((level) <= (CHRONOLOG_MIN_LEVEL))>::run([&] { CHRONOLOG_LOG(logger, level, __VA_ARGS__); })
+#else
+#define CHRONOLOG_AT(logger, level, ...) do {} while (0)
+#endif
 
-class ChronoLogger {
-public:
-  constexpr ChronoLogger(const char* moduleName, ChronoLogLevel level = CHRONOLOG_LEVEL_DEBUG)
-    : name(moduleName), chronoLogLevel(level) {}
+// Rate-limited call site, within the logger's setRateLimit() budget. Needs CHRONOLOG_SUPPRESS.
+#if CHRONOLOG_MODE && CHRONOLOG_SUPPRESS
+#define CHRONOLOG_LIMIT(logger, level, ...)                                                           \
+  do {                                                                                                \
+    static ChronoLogRate chronolog_rate;                                                              \
+    CHRONOLOG_ID_ENTRY(CHRONOLOG_FIRST(__VA_ARGS__));                                                 \
+    if ((logger).enabled(level)) (logger).logLimited(chronolog_rate, level, __VA_ARGS__);             \
+  } while (0)
+#else
+#define CHRONOLOG_LIMIT(logger, level, ...) CHRONOLOG_LOG(logger, level, __VA_ARGS__)
+#endif
+
+/*
+ * Sampled call sites, for logs inside fast loops. The count only advances while the level is
+ * enabled, and the format must be a printf literal, as with CHRONOLOG_LOG().
+ *   CHRONOLOG_EVERY_N(log, level, n, ...)       calls 1, n + 1, 2n + 1, ...
+ *   CHRONOLOG_FIRST_N(log, level, n, ...)       the first n calls after boot
+ *   CHRONOLOG_EVERY_MS(log, level, ms, ...)     at most one line per ms milliseconds
+ *   CHRONOLOG_ON_CHANGE(log, level, value, ...) when value differs from the last one logged here
+ */
+#if CHRONOLOG_MODE
+#define CHRONOLOG_SAMPLED(logger, level, State, test, ...)                                            \
+  do {                                                                                                \
+    static State chronolog_sample;                                                                    \
+    if ((logger).enabled(level) && chronolog_sample.test) CHRONOLOG_LOG(logger, level, __VA_ARGS__);  \
+  } while (0)
+#else
+#define CHRONOLOG_SAMPLED(logger, level, State, test, ...) do {} while (0)
+#endif
+
+#define CHRONOLOG_EVERY_N(logger, level, n, ...)       CHRONOLOG_SAMPLED(logger, level, ChronoLogSample, everyN(n), __VA_ARGS__)
+#define CHRONOLOG_FIRST_N(logger, level, n, ...)       CHRONOLOG_SAMPLED(logger, level, ChronoLogSample, firstN(n), __VA_ARGS__)
+#define CHRONOLOG_EVERY_MS(logger, level, ms, ...)     CHRONOLOG_SAMPLED(logger, level, ChronoLogSample, everyMs(ms), __VA_ARGS__)
+#define CHRONOLOG_ON_CHANGE(logger, level, value, ...) CHRONOLOG_SAMPLED(logger, level, ChronoLogChange, changed(value), __VA_ARGS__)
 
-  void setLevel(ChronoLogLevel level)               { chronoLogLevel = level; }
+#define CHRONOLOG_DEBUG(logger, ...) CHRONOLOG_AT(logger, CHRONOLOG_LEVEL_DEBUG, __VA_ARGS__)
+#define CHRONOLOG_INFO(logger, ...)  CHRONOLOG_AT(logger, CHRONOLOG_LEVEL_INFO,  __VA_ARGS__)
+#define CHRONOLOG_WARN(logger, ...)  CHRONOLOG_AT(logger, CHRONOLOG_LEVEL_WARN,  __VA_ARGS__)
+#define CHRONOLOG_ERROR(logger, ...) CHRONOLOG_AT(logger, CHRONOLOG_LEVEL_ERROR, __VA_ARGS__)
+#define CHRONOLOG_FATAL(logger, ...) CHRONOLOG_AT(logger, CHRONOLOG_LEVEL_FATAL, __VA_ARGS__)
+
+#if CHRONOLOG_MODE
 
 #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
-  void setUartHandler(UART_HandleTypeDef* handler)  { uartHandler = handler;  }
+typedef UART_HandleTypeDef* ChronoLogTarget;
+#else
+typedef void* ChronoLogTarget;
+#endif
+
+#if defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(CHRONOLOG_STM32_FREERTOS) || \
+    (defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(CHRONOLOG_ESP))
+  #define CHRONOLOG_FREERTOS
+#endif
+
+#if defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(CHRONOLOG_PLATFORM_POSIX) || \
+    (defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(CHRONOLOG_ESP))
+  #define CHRONOLOG_WALL_CLOCK                                                                          // Timestamps are local wall-clock time, not uptime
+#endif
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+static inline uint32_t chronoLogIrqSave() {
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  return primask;
+}
+
+static inline void chronoLogIrqRestore(uint32_t primask) { __set_PRIMASK(primask); }
+#endif
+
+static inline bool chronoLogInIsr() {
+  #if defined(CHRONOLOG_PLATFORM_ESP_IDF) || (defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(CHRONOLOG_ESP))
+    return xPortInIsrContext();
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+    return k_is_in_isr();
+  #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
+    return __get_IPSR() != 0;
+  #else
+    return false;                                                                                       // Host builds call the *FromISR API explicitly
+  #endif
+}
+
+#if defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+  #define CHRONOLOG_NO_RMW                                                                             // No LDREX/STREX: atomic RMW would be __atomic_*_4 libcalls
+#endif
+
+/*
+ * Short critical section shared by the clock and the logger registry: interrupts off on MCUs (with
+ * the portMUX spinlock on ESP32), an atomic_flag spinlock on POSIX. Never held across I/O.
+ */
+struct ChronoLogCritical {
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+  uint32_t primask = chronoLogIrqSave();
+  ~ChronoLogCritical() { chronoLogIrqRestore(primask); }
+#elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+  unsigned int key = irq_lock();
+  ~ChronoLogCritical() { irq_unlock(key); }
+#elif defined(CHRONOLOG_PLATFORM_ESP_IDF) || (defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(ESP32))
+  ChronoLogCritical()  { portENTER_CRITICAL(&mux()); }
+  ~ChronoLogCritical() { portEXIT_CRITICAL(&mux()); }
+
+  static portMUX_TYPE& mux() {
+    static portMUX_TYPE m = portMUX_INITIALIZER_UNLOCKED;
+    return m;
+  }
+#elif defined(CHRONOLOG_PLATFORM_ARDUINO)
+  ChronoLogCritical()  { noInterrupts(); }
+  ~ChronoLogCritical() { interrupts(); }
+#elif defined(CHRONOLOG_NO_RMW)                                                                        // Other Cortex-M0/M0+/M23 targets: PRIMASK directly
+  uint32_t primask;
+  ChronoLogCritical()  { __asm volatile("mrs %0, primask\n\tcpsid i" : "=r"(primask) : : "memory"); }
+  ~ChronoLogCritical() { __asm volatile("msr primask, %0" : : "r"(primask) : "memory"); }
+#elif defined(CHRONOLOG_HAS_ATOMIC)
+  ChronoLogCritical()  { while (flag().test_and_set(std::memory_order_acquire)) {} }
+  ~ChronoLogCritical() { flag().clear(std::memory_order_release); }
+
+  static std::atomic_flag& flag() {
+    static std::atomic_flag f = ATOMIC_FLAG_INIT;
+    return f;
+  }
 #endif
+};
 
-  void debug(const char* fmt, ...) const {
-    if (chronoLogLevel >= CHRONOLOG_LEVEL_DEBUG) {
-      va_list args;
-      va_start(args, fmt);
-      print("DEBUG", CHRONOLOG_COLOR_DEBUG, fmt, args);
-      va_end(args);
+#if defined(CHRONOLOG_HAS_ATOMIC)
+/*
+ * Atomic read-modify-write. ARMv6-M and ARMv8-M Baseline (Cortex-M0, M0+, M23) have no exclusive
+ * load/store, so GCC turns fetch_add, exchange and compare_exchange into __atomic_*_4 calls that
+ * newlib does not implement; there each one is a load and a store inside ChronoLogCritical.
+ */
+template <typename T, typename V>
+static inline T chronoLogFetchAdd(std::atomic<T>& a, V v, std::memory_order order = std::memory_order_relaxed) {
+  #if defined(CHRONOLOG_NO_RMW)
+    (void)order;
+    ChronoLogCritical critical;
+    T old = a.load(std::memory_order_relaxed);                                                         // Single core: the critical section orders them
+    a.store((T)(old + v), std::memory_order_relaxed);
+    return old;
+  #else
+    return a.fetch_add(v, order);
+  #endif
+}
+
+template <typename T> struct ChronoLogSame { typedef T type; };                                        // Deduce T from the atomic only
+
+template <typename T>
+static inline T chronoLogExchange(std::atomic<T>& a, typename ChronoLogSame<T>::type v, std::memory_order order = std::memory_order_relaxed) {
+  #if defined(CHRONOLOG_NO_RMW)
+    (void)order;
+    ChronoLogCritical critical;
+    T old = a.load(std::memory_order_relaxed);
+    a.store(v, std::memory_order_relaxed);
+    return old;
+  #else
+    return a.exchange(v, order);
+  #endif
+}
+
+// compare_exchange_strong; expected gets the current value when it fails.
+template <typename T>
+static inline bool chronoLogCas(std::atomic<T>& a, T& expected, typename ChronoLogSame<T>::type desired,
+                                std::memory_order order = std::memory_order_relaxed) {
+  #if defined(CHRONOLOG_NO_RMW)
+    (void)order;
+    ChronoLogCritical critical;
+    T current = a.load(std::memory_order_relaxed);
+    if (current != expected) {
+      expected = current;
+      return false;
     }
+    a.store(desired, std::memory_order_relaxed);
+    return true;
+  #else
+    return a.compare_exchange_strong(expected, desired, order);
+  #endif
+}
+#endif
+
+#if CHRONOLOG_CALLSITES
+
+/*
+ * Per call site hit counter, constant-initialised inside CHRONOLOG_LOG(). A site links itself into
+ * a lock-free list on its first hit, so tooling can walk first()/next() and report counts by id.
+ */
+class ChronoLogSite {
+public:
+  const uint32_t    id;
+  const char* const fmt;
+
+  constexpr ChronoLogSite(uint32_t siteId, const char* siteFmt) : id(siteId), fmt(siteFmt), count(0), link(nullptr) {}
+
+  void hit() {
+    if (chronoLogFetchAdd(count, 1) != 0) return;
+    ChronoLogSite* head = list().load(std::memory_order_relaxed);
+    do {
+      link = head;
+    } while (!chronoLogCas(list(), head, this, std::memory_order_release));
+  }
+
+  uint32_t hits() const               { return count.load(std::memory_order_relaxed); }
+  const ChronoLogSite* next() const   { return link; }
+  static const ChronoLogSite* first() { return list().load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> count;
+  ChronoLogSite*        link;
+
+  static std::atomic<ChronoLogSite*>& list() {
+    static std::atomic<ChronoLogSite*> head{nullptr};
+    return head;
   }
+};
+
+#endif // CHRONOLOG_CALLSITES
 
-  void info(const char* fmt, ...) const {
-    if (chronoLogLevel >= CHRONOLOG_LEVEL_INFO) {
-      va_list args;
-      va_start(args, fmt);
-      print("INFO", CHRONOLOG_COLOR_INFO, fmt, args);
-      va_end(args);
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL) && CHRONOLOG_STM32_UART_DMA
+
+/*
+ * Double-buffered UART transmitter. Writers append to the fill buffer and return; whenever the
+ * UART is idle the fill buffer is handed to HAL_UART_Transmit_DMA (or _IT when the UART has no TX
+ * DMA channel) and the other buffer becomes the fill buffer. The completion interrupt chains the
+ * next buffer, so the CPU only waits when both buffers are full.
+ *
+ * That wait is bounded. In an interrupt, or with interrupts masked, the completion interrupt cannot
+ * run, so nothing is waited for; otherwise the writer gives up once no transfer has finished for
+ * CHRONOLOG_UART_TX_WAIT_MS. The rest of the line is then dropped and counted in dropped().
+ *
+ * Forward the HAL completion callback:
+ *   void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) { ChronoLogUartTx::txComplete(huart); }
+ */
+class ChronoLogUartTx {
+public:
+  // The port of huart, claiming a free slot on first use; nullptr once every slot is taken.
+  static ChronoLogUartTx* get(UART_HandleTypeDef* huart) {
+    uint32_t primask = chronoLogIrqSave();
+    ChronoLogUartTx* port = find(huart);
+    for (size_t i = 0; i < CHRONOLOG_UART_TX_PORTS && !port; i++) {
+      if (ports()[i].huart == nullptr) {
+        ports()[i].huart = huart;
+        port = &ports()[i];
+      }
     }
+    chronoLogIrqRestore(primask);
+    return port;
   }
 
-  void warn(const char* fmt, ...) const {
-    if (chronoLogLevel >= CHRONOLOG_LEVEL_WARN) {
-      va_list args;
-      va_start(args, fmt);
-      print("WARNING", CHRONOLOG_COLOR_WARN, fmt, args);
-      va_end(args);
+  // Lookup only: HAL_UART_TxCpltCallback fires for every UART, and one that never logged must not
+  // take a slot from the log UART.
+  static ChronoLogUartTx* find(UART_HandleTypeDef* huart) {
+    for (size_t i = 0; i < CHRONOLOG_UART_TX_PORTS; i++) {
+      if (ports()[i].huart == huart) return &ports()[i];
     }
+    return nullptr;
+  }
+
+  static void txComplete(UART_HandleTypeDef* huart) {
+    ChronoLogUartTx* port = find(huart);
+    if (port) port->onTxComplete();
   }
 
-  void error(const char* fmt, ...) const {
-    if (chronoLogLevel >= CHRONOLOG_LEVEL_ERROR) {
-      va_list args;
-      va_start(args, fmt);
-      print("ERROR", CHRONOLOG_COLOR_ERROR, fmt, args);
-      va_end(args);
+  void write(const char* data, size_t len) {
+    uint32_t since = HAL_GetTick();
+    while (len > 0) {
+      uint32_t primask = chronoLogIrqSave();
+      size_t space = CHRONOLOG_UART_TX_BUF_LEN - fill[active];
+      if (space == 0) {
+        if (!busy) kick();
+        chronoLogIrqRestore(primask);
+        if (!wait(primask, since)) {                                                                    // Both buffers full, the UART did not free one
+          lost = lost + 1;
+          return;
+        }
+        continue;
+      }
+
+      size_t n = (len < space) ? len : space;
+      memcpy(&buffer[active][fill[active]], data, n);
+      fill[active] = (uint16_t)(fill[active] + n);
+      if (!busy) kick();
+      chronoLogIrqRestore(primask);
+
+      data += n;
+      len  -= n;
     }
   }
 
-  void fatal(const char* fmt, ...) const {
-    if (chronoLogLevel >= CHRONOLOG_LEVEL_FATAL) {
-      va_list args;
-      va_start(args, fmt);
-      print("FATAL", CHRONOLOG_COLOR_FATAL, fmt, args);
-      va_end(args);
+  bool flush() {                                                                                        // false: data is still buffered
+    uint32_t since = HAL_GetTick();
+    for (;;) {
+      uint32_t primask = chronoLogIrqSave();
+      if (!busy) kick();
+      bool idle = !busy && fill[active] == 0;
+      chronoLogIrqRestore(primask);
+      if (idle) return true;
+      if (!wait(primask, since)) return false;
     }
   }
 
+  uint32_t dropped() const { return lost; }                                                             // Lines cut short by a full or failing UART
+
+  void onTxComplete() {                                                                                 // ISR context
+    fill[sending] = 0;
+    busy          = false;
+    kick();
+  }
+
 private:
-  const char* name;
-  ChronoLogLevel chronoLogLevel;
+  static ChronoLogUartTx* ports() {
+    static ChronoLogUartTx all[CHRONOLOG_UART_TX_PORTS];
+    return all;
+  }
 
-#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
-  UART_HandleTypeDef* uartHandler = nullptr;
-#endif
+  UART_HandleTypeDef* volatile huart = nullptr;
+  uint8_t           buffer[2][CHRONOLOG_UART_TX_BUF_LEN];
+  volatile uint16_t fill[2] = {0, 0};
+  volatile uint8_t  active  = 0;
+  volatile uint8_t  sending = 0;
+  volatile bool     busy    = false;
+  volatile uint32_t lost    = 0;
 
-  static const char* getCurrentTaskName() {
-  #if defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(CHRONOLOG_STM32_FREERTOS)
-    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
-      const char* name = pcTaskGetName(NULL);
-      return (name != nullptr) ? name : "MainTask";
+  // Waits for the transfer in flight to finish; false when it cannot finish here or took too long.
+  // A finished transfer restarts the deadline. A kick() refused with HAL_BUSY leaves busy clear, and
+  // the caller retries it until the deadline passes.
+  bool wait(uint32_t primask, uint32_t& since) const {
+    if (primask != 0 || chronoLogInIsr()) return false;
+    if (!busy) return HAL_GetTick() - since < CHRONOLOG_UART_TX_WAIT_MS;
+    while (busy) {
+      if (HAL_GetTick() - since >= CHRONOLOG_UART_TX_WAIT_MS) return false;
     }
-    return "MainTask";
-  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
-    return k_thread_name_get(k_current_get());
-  #elif defined(CHRONOLOG_PLATFORM_ESP_IDF) || (defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(CHRONOLOG_ESP))
-    return pcTaskGetName(NULL);
-  #else
-    return "MainTask";
-  #endif
+    since = HAL_GetTick();
+    return true;
   }
 
-  void print(const char* levelStr, const char* color, const char* fmt, va_list args) const {
-    char time_buf[16];
+  void kick() {                                                                                         // Called with interrupts disabled
+    if (fill[active] == 0) return;
+    sending = active;
+    active ^= 1;
+    busy    = true;
 
-    #if (defined(CHRONOLOG_PLATFORM_ARDUINO) || defined(CHRONOLOG_PLATFORM_ESP_IDF)) && defined(CHRONOLOG_ESP)
-      struct timeval tv;
-      gettimeofday(&tv, NULL);
-      struct tm timeinfo;
-      localtime_r(&tv.tv_sec, &timeinfo);
-      snprintf(time_buf, sizeof(time_buf), "%02d:%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
-      uint64_t ms = k_uptime_get();
-      snprintf(time_buf, sizeof(time_buf), "%02llu:%02llu:%02llu",
-        (ms / 3600000) % 24, (ms / 60000) % 60, (ms / 1000) % 60);
-    #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
-      uint32_t ms = HAL_GetTick();
-      snprintf(time_buf, sizeof(time_buf), "%02lu:%02lu:%02lu",
-        (ms / 3600000) % 24, (ms / 60000) % 60, (ms / 1000) % 60);
-    #elif (defined(CHRONOLOG_PLATFORM_ARDUINO) && !defined(CHRONOLOG_ESP))
-      unsigned long ms = millis();
-      snprintf(time_buf, sizeof(time_buf), "%02lu:%02lu:%02lu",
-        (ms / 3600000) % 24, (ms / 60000) % 60, (ms / 1000) % 60);
-    #endif
-
-    const char* taskName = getCurrentTaskName();
-
-    #if defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(CHRONOLOG_ESP)
-      Serial.printf("%s | %-15s | %s%-8s%s | %-16s | ",
-        time_buf, name, color, levelStr, CHRONOLOG_COLOR_RESET, taskName);
-    #elif defined(CHRONOLOG_PLATFORM_ARDUINO) && !defined(CHRONOLOG_ESP)
-      char line_buf[96];
-      snprintf(line_buf, sizeof(line_buf),
-               "%s | %-15s | %s%-8s%s | %-16s | ",
-               time_buf, name, color, levelStr, CHRONOLOG_COLOR_RESET, taskName);
-      Serial.print(line_buf);
-    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) || defined(CHRONOLOG_PLATFORM_ESP_IDF)
-      printf("%s | %-15s | %s%-8s%s | %-16s | ",
-        time_buf, name, color, levelStr, CHRONOLOG_COLOR_RESET, taskName);
-    #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
-      char line_buf[96];
-      snprintf(line_buf, sizeof(line_buf),
-               "%s | %-15s | %s%-8s%s | %-16s | ",
-               time_buf, name, color, levelStr, CHRONOLOG_COLOR_RESET, taskName);
-      if (!uartHandler) return;
-      HAL_UART_Transmit(uartHandler, (uint8_t*)line_buf, strlen(line_buf), HAL_MAX_DELAY);
-    #endif
-
-    char msg_buf[CHRONOLOG_BUFFER_LEN];
-    va_list args_copy;
-    va_copy(args_copy, args);
-    int len = vsnprintf(msg_buf, sizeof(msg_buf), fmt, args_copy);
-    va_end(args_copy);
-
-    if (len < CHRONOLOG_BUFFER_LEN) {
-      #if defined(CHRONOLOG_PLATFORM_ARDUINO)
-        Serial.print(msg_buf);
-      #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) || defined(CHRONOLOG_PLATFORM_ESP_IDF)
-        printf("%s", msg_buf);
-      #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
-        if (!uartHandler) return;
-        HAL_UART_Transmit(uartHandler, (uint8_t*)msg_buf, len, HAL_MAX_DELAY);
-      #endif
-    } else {
-      char* dynamic_buf = (char*)malloc(len + 1);
-      if (dynamic_buf) {
-        va_copy(args_copy, args);
-        vsnprintf(dynamic_buf, len + 1, fmt, args_copy);
-        va_end(args_copy);
-
-        #if defined(CHRONOLOG_PLATFORM_ARDUINO)
-          Serial.print(dynamic_buf);
-        #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) || defined(CHRONOLOG_PLATFORM_ESP_IDF)
-          printf("%s", dynamic_buf);
-        #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
-          if (!uartHandler) return;
-          HAL_UART_Transmit(uartHandler, (uint8_t*)dynamic_buf, len, HAL_MAX_DELAY);
-        #endif
+    HAL_StatusTypeDef status;
+    #if defined(HAL_DMA_MODULE_ENABLED)
+      if (huart->hdmatx != nullptr) status = HAL_UART_Transmit_DMA(huart, buffer[sending], fill[sending]);
+      else                          status = HAL_UART_Transmit_IT(huart, buffer[sending], fill[sending]);
+    #else
+      status = HAL_UART_Transmit_IT(huart, buffer[sending], fill[sending]);
+    #endif
 
-        free(dynamic_buf);
-      } else {
-        #if defined(CHRONOLOG_PLATFORM_ARDUINO)
-          Serial.print("[Log too long: memory error]");
-        #elif defined(DEBUG_PLATFORM_ZEPHYR) || defined(CHRONOLOG_PLATFORM_ESP_IDF)
-          printf("[Log too long: memory error]");
-        #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
-          if (!uartHandler) return;
-          const char* err_msg = "[Log too long: memory error]";
-          HAL_UART_Transmit(uartHandler, (uint8_t*)err_msg, strlen(err_msg), HAL_MAX_DELAY);
-        #endif
+    if (status == HAL_OK) return;
+    active = sending;
+    busy   = false;
+    if (status != HAL_BUSY) {                                                                           // HAL_ERROR will not clear by retrying
+      fill[sending] = 0;
+      lost          = lost + 1;
+    }                                                                                                   // HAL_BUSY: UART owned elsewhere, retry later
+  }
+};
+
+#endif // CHRONOLOG_STM32_UART_DMA
+
+// One piece of a gather write: a line, or part of one.
+struct ChronoLogPart {
+  const char* data;
+  size_t      len;
+};
+
+#if defined(CHRONOLOG_PLATFORM_POSIX) && CHRONOLOG_POSIX_FD >= 0
+/*
+ * Straight to the descriptor, without stdio's buffer and FILE lock: the pieces go to the kernel in
+ * one writev(2), and a short write (pipe or socket under pressure) continues where it stopped.
+ */
+static inline void chronoLogWritev(const ChronoLogPart* parts, size_t count) {
+  struct iovec iov[CHRONOLOG_ASYNC_BATCH > 16 ? CHRONOLOG_ASYNC_BATCH : 16];
+  const size_t room = sizeof(iov) / sizeof(iov[0]);
+  while (count > 0) {
+    size_t n = count < room ? count : room;
+    for (size_t i = 0; i < n; i++) {
+      iov[i].iov_base = (void*)parts[i].data;
+      iov[i].iov_len  = parts[i].len;
+    }
+    parts += n;
+    count -= n;
+    for (struct iovec* v = iov; n > 0;) {
+      ssize_t done = writev(CHRONOLOG_POSIX_FD, v, (int)n);
+      if (done < 0 && errno == EINTR) continue;
+      if (done <= 0) return;                                                                            // Closed or failing descriptor, drop the rest
+      while (n > 0 && (size_t)done >= v->iov_len) {
+        done -= (ssize_t)v->iov_len;
+        v++;
+        n--;
+      }
+      if (n > 0) {
+        v->iov_base = (char*)v->iov_base + done;
+        v->iov_len -= (size_t)done;
       }
     }
-
-    #if defined(CHRONOLOG_PLATFORM_ARDUINO)
-      Serial.println();
-    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) || defined(CHRONOLOG_PLATFORM_ESP_IDF)
-      printf("\n");
-    #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
-      if (!uartHandler) return;
-      const char* newline = "\n";
-      HAL_UART_Transmit(uartHandler, (uint8_t*)newline, strlen(newline), HAL_MAX_DELAY);
-    #endif
   }
-};
+}
+#endif
 
-#else  // CHRONOLOG_MODE
+static inline void chronoLogWrite(ChronoLogTarget target, const char* data, size_t len) {
+  #if defined(CHRONOLOG_PLATFORM_ARDUINO)
+    (void)target;
+    Serial.write((const uint8_t*)data, len);
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) || defined(CHRONOLOG_PLATFORM_ESP_IDF)
+    (void)target;
+    printf("%.*s", (int)len, data);
+  #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
+    if (!target) return;
+  #if CHRONOLOG_STM32_UART_DMA
+    ChronoLogUartTx* port = ChronoLogUartTx::get(target);
+    if (port) {
+      port->write(data, len);
+      return;
+    }
+  #endif
+    HAL_UART_Transmit(target, (uint8_t*)data, len, CHRONOLOG_UART_TIMEOUT_MS);
+  #elif defined(CHRONOLOG_PLATFORM_POSIX) && CHRONOLOG_POSIX_FD >= 0
+    (void)target;
+    ChronoLogPart part = {data, len};
+    chronoLogWritev(&part, 1);
+  #elif defined(CHRONOLOG_PLATFORM_POSIX)
+    (void)target;
+    fwrite(data, 1, len, stdout);
+  #else
+    (void)target; (void)data; (void)len;
+  #endif
+}
+
+static inline void chronoLogWrite(ChronoLogTarget target, const ChronoLogPart* parts, size_t count) {
+  #if defined(CHRONOLOG_PLATFORM_POSIX) && CHRONOLOG_POSIX_FD >= 0
+    (void)target;
+    chronoLogWritev(parts, count);
+  #else
+    for (size_t i = 0; i < count; i++) chronoLogWrite(target, parts[i].data, parts[i].len);
+  #endif
+}
 
-class ChronoLogger {
+/*
+ * The output path shared by every logger, the async drain task and the record drain. write() sends
+ * a whole line under one lock, so lines from different tasks never interleave, whatever the layer
+ * below does: per-character output on Zephyr's minimal libc, chunked copies into the DMA buffers,
+ * HAL_BUSY from a UART another task is transmitting on. The lock is a priority-inheriting FreeRTOS
+ * or Zephyr mutex, or a std::mutex (a futex) on POSIX. It is skipped in interrupts and before the
+ * scheduler runs, where blocking is not allowed, and it does not exist on single-threaded targets.
+ */
+class ChronoLogTransport {
 public:
-  constexpr ChronoLogger(const char* moduleName, ChronoLogLevel level = CHRONOLOG_LEVEL_NONE) {}
-  void setLevel(ChronoLogLevel level) {}
-  void info(const char* fmt, ...) const {}
-  void warn(const char* fmt, ...) const {}
-  void debug(const char* fmt, ...) const {}
-  void error(const char* fmt, ...) const {}
-  void fatal(const char* fmt, ...) const {}
-};
+  struct Stats {
+    uint32_t writes;                                                                                    // Lines and frames written
+    uint32_t contended;                                                                                 // Writes that found the lock held and waited
+  };
+
+  static void write(ChronoLogTarget target, const char* data, size_t len) {
+    Lock lock(1);
+    chronoLogWrite(target, data, len);
+  }
+
+  static void write(ChronoLogTarget target, const ChronoLogPart* lines, size_t count) {                // Whole lines, one lock and one gather write
+    if (count == 0) return;
+    Lock lock(count);
+    chronoLogWrite(target, lines, count);
+  }
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+  // Default UART for loggers without their own setUartHandler().
+  static void setTarget(UART_HandleTypeDef* huart) { shared() = huart; }
+  static UART_HandleTypeDef* target()              { return shared(); }
+#endif
+
+  static Stats stats() {
+    Counters& c = counters();
+  #if defined(CHRONOLOG_HAS_ATOMIC)
+    return Stats{c.writes.load(std::memory_order_relaxed), c.contended.load(std::memory_order_relaxed)};
+  #else
+    return Stats{c.writes, c.contended};
+  #endif
+  }
+
+  static void resetStats() {
+    counters().writes    = 0;
+    counters().contended = 0;
+  }
+
+private:
+  struct Counters {
+  #if defined(CHRONOLOG_HAS_ATOMIC)
+    std::atomic<uint32_t> writes;
+    std::atomic<uint32_t> contended;
+  #else
+    volatile uint32_t writes;
+    volatile uint32_t contended;
+  #endif
+  };
+
+  static Counters& counters() {
+    static Counters c;
+    return c;
+  }
+
+  static void count(size_t lines, bool waited) {                                                        // Called with the lock held, so no RMW is needed
+  #if defined(CHRONOLOG_HAS_ATOMIC)
+    Counters& c = counters();
+    c.writes.store(c.writes.load(std::memory_order_relaxed) + (uint32_t)lines, std::memory_order_relaxed);
+    if (waited) c.contended.store(c.contended.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  #else
+    counters().writes    = counters().writes + (uint32_t)lines;
+    counters().contended = counters().contended + (waited ? 1 : 0);
+  #endif
+  }
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+  static UART_HandleTypeDef*& shared() {
+    static UART_HandleTypeDef* huart = nullptr;
+    return huart;
+  }
+#endif
+
+  struct Lock {
+  #if defined(CHRONOLOG_FREERTOS)
+    SemaphoreHandle_t held;
+
+    explicit Lock(size_t lines) : held(nullptr) {
+      if (chronoLogInIsr() || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+        count(lines, false);
+        return;
+      }
+      SemaphoreHandle_t m = mutex();
+      bool waited = m && xSemaphoreTake(m, 0) != pdTRUE;
+      if (waited) xSemaphoreTake(m, portMAX_DELAY);
+      held = m;
+      count(lines, waited);
+    }
+    ~Lock() { if (held) xSemaphoreGive(held); }
+
+    static SemaphoreHandle_t mutex() {                                                                  // Created on first use; a losing racer deletes its copy
+      static std::atomic<SemaphoreHandle_t> shared{nullptr};
+      SemaphoreHandle_t m = shared.load(std::memory_order_acquire);
+      if (m) return m;
+      SemaphoreHandle_t fresh = xSemaphoreCreateMutex();
+      if (!fresh) return nullptr;
+      if (chronoLogCas(shared, m, fresh, std::memory_order_acq_rel)) return fresh;
+      vSemaphoreDelete(fresh);
+      return m;
+    }
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+    bool held;
+
+    explicit Lock(size_t lines) : held(!k_is_in_isr() && !k_is_pre_kernel()) {
+      bool waited = held && k_mutex_lock(mutex(), K_NO_WAIT) != 0;
+      if (waited) k_mutex_lock(mutex(), K_FOREVER);
+      count(lines, waited);
+    }
+    ~Lock() { if (held) k_mutex_unlock(mutex()); }
+
+    static struct k_mutex* mutex() {
+      static struct k_mutex m;
+      static volatile bool  ready = false;
+      if (!ready) {
+        ChronoLogCritical guard;
+        if (!ready) {
+          k_mutex_init(&m);
+          ready = true;
+        }
+      }
+      return &m;
+    }
+  #elif defined(CHRONOLOG_PLATFORM_POSIX)
+    explicit Lock(size_t lines) {
+      bool waited = !mutex().try_lock();
+      if (waited) mutex().lock();
+      count(lines, waited);
+    }
+    ~Lock() { mutex().unlock(); }
+
+    static std::mutex& mutex() {
+      static std::mutex m;
+      return m;
+    }
+  #else
+    explicit Lock(size_t lines) { count(lines, false); }                                                // Single-threaded target
+  #endif
+  };
+};
+
+/*
+ * Extra output for finished lines, e.g. a RAM buffer or a file. write() must not block: it returns
+ * false when the line does not fit right now, and the line is dropped for that sink only. It can be
+ * called from several tasks at once. flush may be nullptr.
+ */
+struct ChronoLogSink {
+  bool (*write)(void* context, const char* data, size_t len);
+  void (*flush)(void* context);
+  void* context;
+};
+
+/*
+ * Fan-out of every line to the platform output (Serial, printf, the UART) and up to
+ * CHRONOLOG_MAX_SINKS added sinks, each with its own level. Loggers are capped at the most verbose
+ * level any output wants, so a line nobody takes is never formatted. Added sinks are written first,
+ * outside the transport lock, so a UART that blocks does not hold up a RAM buffer.
+ */
+class ChronoLogSinks {
+public:
+  // false when all slots are taken. Adding a sink that is already there only changes its level.
+  static bool add(const ChronoLogSink& sink, ChronoLogLevel level = CHRONOLOG_LEVEL_DEBUG);
+  static void remove(const ChronoLogSink& sink);                                                       // In-flight writes may still finish
+  static void setLevel(const ChronoLogSink& sink, ChronoLogLevel level) { add(sink, level); }
+  static void setTransportLevel(ChronoLogLevel level);                                                 // The platform output, CHRONOLOG_LEVEL_NONE mutes it
+
+  static uint32_t dropped(const ChronoLogSink& sink) {                                                 // Lines the sink refused
+    const Slot* slot = find(&sink);
+    return slot ? slot->drops.load() : 0;
+  }
+
+  static void flush() {
+    Table& t = table();
+    for (size_t i = 0; i < CHRONOLOG_MAX_SINKS; i++) {
+      const ChronoLogSink* sink = t.slots[i].sink.load();
+      if (sink && sink->flush) sink->flush(sink->context);
+    }
+  }
+
+  static uint8_t ceiling() { return table().ceiling.load(); }                                          // Most verbose level any output takes
+
+  static void write(ChronoLogLevel level, ChronoLogTarget target, const char* data, size_t len) {
+    size_t n = fanOut(level, data, len);
+    if (n) ChronoLogTransport::write(target, data, n);
+  }
+
+  // Writes the added sinks only and returns how many leading bytes the transport takes, for callers
+  // that batch lines into one transport write: all of them, none, or in binary mode the DEF frames
+  // in front of a line below its level.
+  static size_t fanOut(ChronoLogLevel level, const char* data, size_t len);
+
+private:
+  template <typename T>
+  struct Cell {                                                                                         // Relaxed atomic, or a volatile value on AVR
+  #if defined(CHRONOLOG_HAS_ATOMIC)
+    std::atomic<T> value;
+    T load() const     { return value.load(std::memory_order_relaxed); }
+    void store(T v)    { value.store(v, std::memory_order_relaxed); }
+  #else
+    volatile T value;
+    T load() const     { return value; }
+    void store(T v)    { value = v; }
+  #endif
+    constexpr Cell(T v) : value(v) {}
+  };
+
+  struct Slot {
+    Cell<const ChronoLogSink*> sink{nullptr};
+    Cell<uint8_t>              level{0};
+    Cell<uint32_t>             drops{0};
+  };
+
+  struct Table {
+    Slot          slots[CHRONOLOG_MAX_SINKS];
+    Cell<uint8_t> used{0};                                                                              // Sinks added
+    Cell<uint8_t> transport{(uint8_t)CHRONOLOG_LEVEL_DEBUG};
+    Cell<uint8_t> ceiling{(uint8_t)CHRONOLOG_LEVEL_DEBUG};
+  };
+
+  static Table& table() {
+    static Table t;
+    return t;
+  }
+
+  static Slot* find(const ChronoLogSink* sink) {
+    Table& t = table();
+    for (size_t i = 0; i < CHRONOLOG_MAX_SINKS; i++) {
+      if (t.slots[i].sink.load() == sink) return &t.slots[i];
+    }
+    return nullptr;
+  }
+
+  static void changed();                                                                                // Recomputes the ceiling, re-levels the loggers
+};
+
+#if CHRONOLOG_ASYNC || CHRONOLOG_ISR
+
+/*
+ * Bounded lock-free queue (Vyukov). Every cell carries a sequence number so producers claim a
+ * slot with a single CAS on head, fill it in place and publish it with a release store; no
+ * producer ever waits on another one and nothing is allocated after construction.
+ * Sequence numbers are stored relative to the cell index so an all-zero ring is a valid empty
+ * ring; that keeps it constant-initialised and usable from interrupts before main() runs.
+ */
+template <typename T, size_t N>
+class ChronoLogRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "ChronoLogRing length must be a power of two");
+
+public:
+  constexpr ChronoLogRing() : cells{} {}
+
+  template <typename Fill>
+  bool push(Fill&& fill) {
+    size_t pos = head.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t index  = pos & (N - 1);
+      Cell& cell    = cells[index];
+      size_t seq    = cell.seq.load(std::memory_order_acquire) + index;
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (chronoLogCas(head, pos, pos + 1)) {
+          fill(cell.data);
+          cell.seq.store(pos + 1 - index, std::memory_order_release);
+          notePeak(pos + 1 - tail.load(std::memory_order_relaxed));
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;                                                                                   // Full
+      } else {
+        pos = head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  template <typename Consume>
+  bool pop(Consume&& consume) {
+    size_t pos = tail.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t index  = pos & (N - 1);
+      Cell& cell    = cells[index];
+      size_t seq    = cell.seq.load(std::memory_order_acquire) + index;
+      intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+      if (diff == 0) {
+        if (chronoLogCas(tail, pos, pos + 1)) {
+          consume(cell.data);
+          cell.seq.store(pos + N - index, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;                                                                                   // Empty
+      } else {
+        pos = tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  const T* front() const {                                                                              // Oldest element, left in place; single consumer only
+    size_t pos       = tail.load(std::memory_order_relaxed);
+    size_t index     = pos & (N - 1);
+    const Cell& cell = cells[index];
+    return cell.seq.load(std::memory_order_acquire) + index == pos + 1 ? &cell.data : nullptr;
+  }
+
+  bool   empty()         const { return size() == 0; }
+  size_t size()          const { return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed); }
+  size_t highWaterMark() const { return peak.load(std::memory_order_relaxed); }
+  static constexpr size_t capacity() { return N; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> seq{0};
+    T data{};
+  };
+
+  Cell cells[N];
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+  std::atomic<size_t> peak{0};
+
+  void notePeak(size_t used) {
+    if (used > N) return;                                                                               // Tail already passed our slot: wrapped below zero
+    size_t prev = peak.load(std::memory_order_relaxed);
+    while (used > prev && !chronoLogCas(peak, prev, used)) {}
+  }
+};
+
+#endif // CHRONOLOG_ASYNC || CHRONOLOG_ISR
+
+/*
+ * Allocation-free writers behind CHRONOLOG_FMT() and the built-in printf backend (CHRONOLOG_PRINTF).
+ * Decimal digits are produced two at a time from a lookup table, dividing by 100 with a reciprocal
+ * multiply, and floats are written in fixed point from integer parts, so neither libc's division
+ * heavy integer paths nor its float formatter (_printf_float on newlib-nano) are needed.
+ */
+struct ChronoLogWriter {
+  struct Field {
+    char     type;                                                                                      // Conversion character, '?' for a plain {} field
+    char     fill;                                                                                      // ' ' or '0'
+    bool     left;
+    char     sign;                                                                                      // 0, '+' or ' ' before non-negative numbers
+    bool     alt;                                                                                       // '#'
+    uint16_t width;
+    int16_t  precision;                                                                                 // -1 when not given
+  };
+
+  struct Out {
+    char* p;
+    char* end;
+
+    void put(const char* s, size_t n) {
+      if (n > (size_t)(end - p)) n = (size_t)(end - p);
+      memcpy(p, s, n);
+      p += n;
+    }
+
+    void fill(char c, size_t n) {
+      if (n > (size_t)(end - p)) n = (size_t)(end - p);
+      memset(p, c, n);
+      p += n;
+    }
+  };
+
+  // Text of a number: lead zeros, head, mid zeros, tail, trail zeros.
+  struct Body {
+    size_t      lead;
+    const char* head;
+    size_t      headLen;
+    size_t      mid;
+    const char* tail;
+    size_t      tailLen;
+    size_t      trail;
+
+    size_t size() const { return lead + headLen + mid + tailLen + trail; }
+  };
+
+  static void pad(Out& out, const Field& f, const char* prefix, const Body& body) {
+    size_t prefixLen = strlen(prefix);
+    size_t total     = prefixLen + body.size();
+    size_t padLen    = (f.width > total) ? f.width - total : 0;
+    if (!f.left && f.fill != '0') out.fill(' ', padLen);
+    out.put(prefix, prefixLen);
+    if (!f.left && f.fill == '0') out.fill('0', padLen);
+    out.fill('0', body.lead);
+    out.put(body.head, body.headLen);
+    out.fill('0', body.mid);
+    out.put(body.tail, body.tailLen);
+    out.fill('0', body.trail);
+    if (f.left) out.fill(' ', padLen);
+  }
+
+  static void pad(Out& out, const Field& f, const char* prefix, const char* s, size_t n) {
+    Body body = {0, s, n, 0, "", 0, 0};
+    pad(out, f, prefix, body);
+  }
+
+  // Writes v right-aligned ending at end and returns its first character.
+  static char* digits(char* end, unsigned long long v, char type) {
+    char* p = end;
+    switch (type) {
+      case 'x': case 'X': case 'p': {
+        const char* hex = (type == 'X') ? "0123456789ABCDEF" : "0123456789abcdef";
+        do { *--p = hex[v & 0xF]; v >>= 4; } while (v);
+        return p;
+      }
+      case 'o':
+        do { *--p = (char)('0' + (v & 7)); v >>= 3; } while (v);
+        return p;
+      case 'b':
+        do { *--p = (char)('0' + (v & 1)); v >>= 1; } while (v);
+        return p;
+      default:
+        while (v > 0xFFFFFFFFull) {                                                                     // Peel 8 digits per 64-bit division
+          unsigned long long q = v / 100000000u;
+          p = decimal(p, (uint32_t)(v - q * 100000000u), 8);
+          v = q;
+        }
+        return decimal(p, (uint32_t)v, 1);
+    }
+  }
+
+  static void writeInt(Out& out, const Field& field, unsigned long long magnitude, bool negative) {
+    Field f = field;
+    if (f.precision >= 0) f.fill = ' ';
+
+    char  buf[66];
+    char* end = buf + sizeof(buf);
+    char* p   = (magnitude == 0 && f.precision == 0) ? end : digits(end, magnitude, f.type);           // printf: %.0d of 0 prints nothing
+    size_t n  = (size_t)(end - p);
+
+    char prefix[3] = {0, 0, 0};
+    bool isSigned  = (f.type == 'd' || f.type == 'i' || f.type == '?');
+    if (negative)                 prefix[0] = '-';
+    else if (isSigned && f.sign)  prefix[0] = f.sign;
+    else if (f.alt && magnitude && (f.type == 'x' || f.type == 'X' || f.type == 'b')) {
+      prefix[0] = '0';
+      prefix[1] = f.type;
+    }
+
+    size_t lead = (f.precision > (int)n) ? (size_t)f.precision - n : 0;
+    if (f.alt && f.type == 'o' && lead == 0 && (n == 0 || *p != '0')) lead = 1;
+    Body body = {lead, p, n, 0, "", 0, 0};
+    pad(out, f, prefix, body);
+  }
+
+  static void writeFloat(Out& out, const Field& field, double v) {
+    Field f        = field;
+    bool  upper    = (f.type == 'F' || f.type == 'E' || f.type == 'G');
+    bool  negative = (v < 0) || (v == 0 && 1 / v < 0);                                                 // Keeps the sign of -0.0
+    double a       = negative ? -v : v;
+    char  prefix[2] = {negative ? '-' : f.sign, 0};
+
+    if (v != v || a - a != 0) {
+      f.fill = ' ';
+      if (v != v) return pad(out, f, "", upper ? "NAN" : "nan", 3);
+      return pad(out, f, prefix, upper ? "INF" : "inf", 3);
+    }
+
+    int  precision = (f.precision < 0) ? 6 : f.precision;
+    bool trim      = false;
+    bool useExp    = (f.type == 'e' || f.type == 'E');
+    char buf[48];
+    if (f.type == 'g' || f.type == 'G') {
+      int p = precision ? precision : 1;
+      int x = 0;
+      if (a != 0) mantissa(buf, a, (p - 1 < 17) ? p - 1 : 17, x);
+      useExp    = (x < -4 || x >= p);
+      precision = useExp ? p - 1 : p - 1 - x;
+      trim      = !f.alt;
+    } else if (f.type == '?') {                                                                        // {}: fixed, trailing zeros dropped
+      trim   = (f.precision < 0);
+      useExp = (a != 0 && (a >= 1e18 || (trim && a < 1e-4)));
+    }
+
+    bool   dot   = false;                                                                               // '.' already placed in the tail
+    int    frac  = (precision < 17) ? precision : 17;
+    size_t extra = (size_t)(precision - frac);
+    char   tail[8];
+    Body   body = {0, buf, 0, 0, tail, 0, 0};
+    if (useExp) {
+      int x = 0;
+      body.headLen = mantissa(buf, a, frac, x);
+      body.mid     = extra;
+      tail[body.tailLen++] = upper ? 'E' : 'e';
+      tail[body.tailLen++] = (x < 0) ? '-' : '+';
+      unsigned e = (unsigned)(x < 0 ? -x : x);
+      if (e < 10) tail[body.tailLen++] = '0';
+      char* d = digits(tail + sizeof(tail), e, 'd');
+      while (d < tail + sizeof(tail)) tail[body.tailLen++] = *d++;
+    } else if (a >= 1e18) {                                                                            // Past 64-bit integers: 17 digits, then zeros
+      int x = 0;
+      mantissa(buf, a, 16, x);
+      memmove(buf + 1, buf + 2, 16);
+      body.headLen = 17;
+      body.mid     = (size_t)(x + 1 - 17);
+      tail[0]      = '.';
+      body.tailLen = (precision || f.alt) ? 1 : 0;
+      dot          = true;
+      body.trail   = (size_t)precision;
+    } else {
+      body.headLen = fixed(buf, a, frac);
+      body.mid     = extra;
+    }
+
+    if (trim && memchr(buf, '.', body.headLen)) {
+      body.mid = 0;
+      while (buf[body.headLen - 1] == '0') body.headLen--;
+      if (buf[body.headLen - 1] == '.') body.headLen--;
+    } else if (f.alt && precision == 0 && !trim && !dot) {
+      buf[body.headLen++] = '.';
+    }
+    pad(out, f, prefix, body);
+  }
+
+  static void writeStr(Out& out, const Field& field, const char* s) {
+    Field f = field;
+    f.fill  = ' ';
+    if (!s) s = "(null)";
+    size_t n = 0;
+    while (s[n] && (f.precision < 0 || n < (size_t)f.precision)) n++;
+    pad(out, f, "", s, n);
+  }
+
+  static void writeChar(Out& out, const Field& field, char c) {
+    Field f = field;
+    f.fill  = ' ';
+    pad(out, f, "", &c, 1);
+  }
+
+  static void writePtr(Out& out, const Field& field, const void* ptr) {
+    Field f = field;
+    f.fill  = ' ';
+    char  buf[20];
+    char* p = digits(buf + sizeof(buf), (unsigned long long)(uintptr_t)ptr, 'x');
+    pad(out, f, "0x", p, (size_t)(buf + sizeof(buf) - p));
+  }
+
+private:
+  static char* decimal(char* p, uint32_t v, int minDigits) {
+    static const char pairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+    char* stop = p - minDigits;
+    while (v >= 100) {
+      uint32_t q = (uint32_t)(((uint64_t)v * 0x51EB851Fu) >> 37);                                       // v / 100 for any 32-bit v
+      uint32_t r = (v - q * 100) * 2;
+      v = q;
+      *--p = pairs[r + 1];
+      *--p = pairs[r];
+    }
+    if (v >= 10) {
+      *--p = pairs[v * 2 + 1];
+      *--p = pairs[v * 2];
+    } else {
+      *--p = (char)('0' + v);
+    }
+    while (p > stop) *--p = '0';
+    return p;
+  }
+
+  static const unsigned long long* powers() {
+    static const unsigned long long pow10[18] = {
+      1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+      1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+      100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull};
+    return pow10;
+  }
+
+  // Writes a (< 1e18) with precision (<= 17) decimals, rounding half to even.
+  static size_t fixed(char* buf, double a, int precision) {
+    const unsigned long long* pow10 = powers();
+    unsigned long long ip     = (unsigned long long)a;
+    double             part   = a - (double)ip;
+    double             scaled = part * (double)pow10[precision];
+    unsigned long long frac   = (unsigned long long)scaled;
+    double             rest   = scaled - (double)frac;
+    if (rest == 0.5) {                                                                                 // Tie after rounding, the product error decides
+      double err = productError(part, (double)pow10[precision], scaled);
+      if (err > 0 || (err == 0 && ((precision ? frac : ip) & 1))) frac++;
+    } else if (rest > 0.5) {
+      frac++;
+    }
+    if (frac >= pow10[precision]) {
+      ip++;
+      frac -= pow10[precision];
+    }
+
+    char   tmp[24];
+    char*  p = digits(tmp + sizeof(tmp), ip, 'd');
+    size_t n = (size_t)(tmp + sizeof(tmp) - p);
+    memcpy(buf, p, n);
+    if (precision > 0) {
+      buf[n++] = '.';
+      decimalTo(buf + n, frac, precision);
+      n += (size_t)precision;
+    }
+    return n;
+  }
+
+  // Exact a * b - p for p = a * b rounded (Dekker), without needing fma.
+  static double productError(double a, double b, double p) {
+    const double split = 134217729.0;                                                                  // 2^27 + 1
+    double ta = split * a, ah = ta - (ta - a), al = a - ah;
+    double tb = split * b, bh = tb - (tb - b), bl = b - bh;
+    return ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+  }
+
+  static void decimalTo(char* buf, unsigned long long v, int width) {
+    char* p = digits(buf + width, v, 'd');
+    while (p > buf) *--p = '0';
+  }
+
+  // Leading digits of an exact fixed-point rendering of a; x is the estimated exponent and gets
+  // corrected when the rendering disagrees. Returns 0 when the rendering would not fit.
+  static size_t significant(char* buf, double a, int precision, int& x) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+      int k = precision - x;
+      if (k < 0 || k > 17) return 0;
+
+      char   tmp[48];
+      char   sig[40];
+      size_t n        = fixed(tmp, a, k);
+      size_t m        = 0;
+      int    exponent = -1;
+      bool   dot      = false;
+      for (size_t i = 0; i < n; i++) {
+        if (tmp[i] == '.') {
+          dot = true;
+        } else if (m == 0 && tmp[i] == '0') {
+          if (dot) exponent--;
+        } else {
+          if (!dot) exponent++;
+          sig[m++] = tmp[i];
+        }
+      }
+      if (exponent != x) {
+        x = exponent;
+        continue;
+      }
+
+      size_t len = 0;
+      buf[len++] = sig[0];
+      if (precision > 0) {
+        buf[len++] = '.';
+        memcpy(buf + len, sig + 1, (size_t)precision);
+        len += (size_t)precision;
+      }
+      return len;
+    }
+    return 0;
+  }
+
+  // Writes a as d.ddd with precision decimals and returns the decimal exponent through x.
+  static size_t mantissa(char* buf, double a, int precision, int& x) {
+    static const double exact[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    x = 0;
+    if (a != 0) {
+      double m = a;
+      while (m >= 1e22)  { m /= 1e22; x += 22; }                                                       // Only for the exponent estimate,
+      while (m < 1e-22)  { m *= 1e22; x -= 22; }                                                       // the scaling below is exact or
+      while (m >= 10)    { m /= 10;   x++;     }                                                       // rounded once per 22 decades
+      while (m < 1)      { m *= 10;   x--;     }
+      if (a < 1e18) {
+        size_t n = significant(buf, a, precision, x);
+        if (n) return n;
+      }
+      int e = x;
+      for (; e > 22;  e -= 22) a /= 1e22;
+      for (; e < -22; e += 22) a *= 1e22;
+      a = (e >= 0) ? a / exact[e] : a * exact[-e];
+      if (a >= 10) { a /= 10; x++; }
+      if (a < 1)   { a *= 10; x--; }
+    }
+    size_t n = fixed(buf, a, precision);
+    if (n > (size_t)(precision ? precision + 2 : 1)) {                                                // Rounded up to 10
+      x++;
+      n = fixed(buf, 1.0, precision);
+    }
+    return n;
+  }
+};
+
+static inline uint32_t chronoLogUptimeMs() {                                                           // Safe from interrupts and signal handlers
+  #if defined(CHRONOLOG_PLATFORM_ARDUINO)
+    return millis();
+  #elif defined(CHRONOLOG_PLATFORM_ESP_IDF)
+    return (uint32_t)(esp_timer_get_time() / 1000);
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+    return k_uptime_get_32();
+  #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
+    return HAL_GetTick();
+  #elif defined(CHRONOLOG_PLATFORM_POSIX)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+  #else
+    return 0;
+  #endif
+}
+
+#if CHRONOLOG_ISR || CHRONOLOG_DEFERRED || CHRONOLOG_BINARY || CHRONOLOG_PRINTF
+
+class ChronoLogModule;
+
+
+/*
+ * printf format walker shared by argument capture and replay. Each conversion is classified by
+ * the C type va_arg has to fetch, so capture can copy raw argument bytes without formatting and
+ * replay can hand every conversion back to snprintf with exactly the same type.
+ */
+struct ChronoLogFmt {
+  enum Kind : uint8_t { LITERAL, PERCENT, INT, LONG, LLONG, INTMAX, SIZE, PTRDIFF, DOUBLE, LDOUBLE, PTR, STR, SKIP };
+
+  struct Spec {
+    const char* text;                                                                                   // Literal run, or the conversion including '%'
+    size_t      len;
+    Kind        kind;
+    uint8_t     stars;                                                                                  // '*' width/precision ints preceding the value
+  };
+
+  static bool next(const char*& p, Spec& spec) {
+    if (*p == '\0') return false;
+    spec.text  = p;
+    spec.stars = 0;
+    if (*p != '%') {
+      while (*p && *p != '%') p++;
+      spec.kind = LITERAL;
+      spec.len  = (size_t)(p - spec.text);
+      return true;
+    }
+
+    p++;
+    if (*p == '%') {
+      p++;
+      spec.kind = PERCENT;
+      spec.len  = 2;
+      return true;
+    }
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'') p++;
+    if (*p == '*') { spec.stars++; p++; } else { while (*p >= '0' && *p <= '9') p++; }
+    if (*p == '.') {
+      p++;
+      if (*p == '*') { spec.stars++; p++; } else { while (*p >= '0' && *p <= '9') p++; }
+    }
+
+    Kind intKind = INT;
+    bool longDouble = false;
+    switch (*p) {
+      case 'h': p++; if (*p == 'h') p++;                     break;
+      case 'l': p++; intKind = LONG; if (*p == 'l') { p++; intKind = LLONG; } break;
+      case 'q': p++; intKind = LLONG;                        break;
+      case 'j': p++; intKind = INTMAX;                       break;
+      case 'z': p++; intKind = SIZE;                         break;
+      case 't': p++; intKind = PTRDIFF;                      break;
+      case 'L': p++; longDouble = true;                      break;
+      default:                                               break;
+    }
+
+    switch (*p) {
+      case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+        spec.kind = intKind;                                   break;
+      case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        spec.kind = longDouble ? LDOUBLE : DOUBLE;             break;
+      case 's': spec.kind = STR;                               break;
+      case 'p': spec.kind = PTR;                               break;
+      case '\0':                                                                                       // Dangling '%', print it verbatim
+        spec.kind = LITERAL;
+        spec.len  = (size_t)(p - spec.text);
+        return true;
+      case '%': spec.kind = PERCENT;                           break;                                   // "%5%" and the like
+      default:  spec.kind = SKIP;                              break;                                   // %n and unknown conversions are dropped
+    }
+    p++;
+    spec.len = (size_t)(p - spec.text);
+    return true;
+  }
+
+  /*
+   * Copies the arguments named by fmt into out. Source::get<T>() yields the next argument as T;
+   * strings are copied with their terminator since the caller's buffer may not outlive the call.
+   * Returns false when the arguments do not fit.
+   */
+  template <typename Source>
+  static bool capture(const char* fmt, Source& src, uint8_t* out, size_t cap, uint16_t& used) {
+    size_t pos = 0;
+    Spec spec;
+    while (next(fmt, spec)) {
+      if (spec.kind == LITERAL || spec.kind == PERCENT) continue;
+      for (uint8_t i = 0; i < spec.stars; i++) {
+        if (!put(out, cap, pos, src.template get<int>())) return false;
+      }
+      bool ok = true;
+      switch (spec.kind) {
+        case INT:     ok = put(out, cap, pos, src.template get<int>());            break;
+        case LONG:    ok = put(out, cap, pos, src.template get<long>());           break;
+        case LLONG:   ok = put(out, cap, pos, src.template get<long long>());      break;
+        case INTMAX:  ok = put(out, cap, pos, src.template get<intmax_t>());       break;
+        case SIZE:    ok = put(out, cap, pos, src.template get<size_t>());         break;
+        case PTRDIFF: ok = put(out, cap, pos, src.template get<ptrdiff_t>());      break;
+        case DOUBLE:  ok = put(out, cap, pos, src.template get<double>());         break;
+        case LDOUBLE: ok = put(out, cap, pos, src.template get<long double>());    break;
+        case PTR:     ok = put(out, cap, pos, src.template get<void*>());          break;
+        case SKIP:    (void)src.template get<void*>();                             break;
+        case STR: {
+          const char* str = src.template get<const char*>();
+          if (!str) str = "(null)";
+          size_t n = strlen(str) + 1;
+          if (pos + n > cap) return false;
+          memcpy(out + pos, str, n);
+          pos += n;
+          break;
+        }
+        default: break;
+      }
+      if (!ok) return false;
+    }
+    used = (uint16_t)pos;
+    return true;
+  }
+
+  /*
+   * Renders fmt, fetching every argument from Source::get<T>() with the type its conversion
+   * expects (strings as const char*). Returns the number of characters written to out, which
+   * must have room for cap characters plus a terminator.
+   */
+  template <typename Source>
+  static size_t render(const char* fmt, Source& src, char* out, size_t cap) {
+    size_t len = 0;
+  #if !CHRONOLOG_PRINTF
+    char conv[24];
+  #endif
+    Spec spec;
+    while (next(fmt, spec) && len < cap) {
+      if (spec.kind == LITERAL || spec.kind == PERCENT) {
+        size_t n = (spec.kind == PERCENT) ? 1 : spec.len;
+        if (n > cap - len) n = cap - len;
+        memcpy(out + len, spec.text, n);
+        len += n;
+        continue;
+      }
+
+      int star[2] = {0, 0};
+      for (uint8_t i = 0; i < spec.stars; i++) star[i] = src.template get<int>();
+      if (spec.kind == SKIP) continue;
+
+    #if CHRONOLOG_PRINTF
+      const char* conv = spec.text;                                                                     // Parsed in place, no terminator needed
+    #else
+      size_t n = (spec.len < sizeof(conv)) ? spec.len : sizeof(conv) - 1;
+      memcpy(conv, spec.text, n);
+      conv[n] = '\0';
+    #endif
+
+      char*  dst  = out + len;
+      size_t room = cap - len + 1;
+      int written = 0;
+      switch (spec.kind) {
+        case INT:     written = emit(dst, room, conv, spec.stars, star, src.template get<int>());          break;
+        case LONG:    written = emit(dst, room, conv, spec.stars, star, src.template get<long>());         break;
+        case LLONG:   written = emit(dst, room, conv, spec.stars, star, src.template get<long long>());    break;
+        case INTMAX:  written = emit(dst, room, conv, spec.stars, star, src.template get<intmax_t>());     break;
+        case SIZE:    written = emit(dst, room, conv, spec.stars, star, src.template get<size_t>());       break;
+        case PTRDIFF: written = emit(dst, room, conv, spec.stars, star, src.template get<ptrdiff_t>());    break;
+        case DOUBLE:  written = emit(dst, room, conv, spec.stars, star, src.template get<double>());       break;
+        case LDOUBLE: written = emit(dst, room, conv, spec.stars, star, src.template get<long double>());  break;
+        case PTR:     written = emit(dst, room, conv, spec.stars, star, src.template get<void*>());        break;
+        case STR:     written = emit(dst, room, conv, spec.stars, star, src.template get<const char*>());  break;
+        default: break;
+      }
+      if (written > 0) len += ((size_t)written < cap - len) ? (size_t)written : cap - len;
+    }
+    return len;
+  }
+
+private:
+  template <typename T>
+  static bool put(uint8_t* out, size_t cap, size_t& pos, T value) {
+    if (pos + sizeof(T) > cap) return false;
+    memcpy(out + pos, &value, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  template <typename T>
+  static int emit(char* out, size_t size, const char* conv, uint8_t stars, const int* star, T value) {
+  #if CHRONOLOG_PRINTF
+    (void)stars;
+    ChronoLogWriter::Out   dst{out, out + size - 1};
+    ChronoLogWriter::Field f = field(conv, star);
+    int shortness = 0;                                                                                  // 1: h, 2: hh
+    for (; *conv == 'h' || *conv == 'l' || *conv == 'q' || *conv == 'j' || *conv == 'z' || *conv == 't' || *conv == 'L'; conv++) {
+      if (*conv == 'h') shortness++;
+    }
+    f.type = *conv;
+    write(dst, f, shortness, value);
+    *dst.p = '\0';
+    return (int)(dst.p - out);
+  #else
+    switch (stars) {
+      case 0:  return snprintf(out, size, conv, value);
+      case 1:  return snprintf(out, size, conv, star[0], value);
+      default: return snprintf(out, size, conv, star[0], star[1], value);
+    }
+  #endif
+  }
+
+#if CHRONOLOG_PRINTF
+  // Parses flags, width and precision of a conversion, leaving conv at the length modifier.
+  static ChronoLogWriter::Field field(const char*& conv, const int* star) {
+    ChronoLogWriter::Field f{0, ' ', false, 0, false, 0, -1};
+    int next = 0;
+    for (conv++;; conv++) {
+      if (*conv == '-')                     f.left = true;
+      else if (*conv == '+')                f.sign = '+';
+      else if (*conv == ' ')                f.sign = f.sign ? f.sign : ' ';
+      else if (*conv == '#')                f.alt  = true;
+      else if (*conv == '0')                f.fill = '0';
+      else if (*conv != '\'')               break;
+    }
+    long width = 0;
+    if (*conv == '*') {
+      width = star[next++];
+      if (width < 0) {
+        f.left = true;
+        width  = -width;
+      }
+      conv++;
+    } else {
+      while (*conv >= '0' && *conv <= '9') width = width * 10 + (*conv++ - '0');
+    }
+    f.width = (uint16_t)((width < 4096) ? width : 4096);
+    if (*conv == '.') {
+      long precision = 0;
+      conv++;
+      if (*conv == '*') {
+        precision = star[next++];
+        conv++;
+      } else {
+        while (*conv >= '0' && *conv <= '9') precision = precision * 10 + (*conv++ - '0');
+      }
+      f.precision = (int16_t)((precision < 0) ? -1 : (precision < 4096) ? precision : 4096);
+    }
+    if (f.left) f.fill = ' ';
+    return f;
+  }
+
+  template <typename T>
+  static typename std::enable_if<std::is_integral<T>::value>::type
+  write(ChronoLogWriter::Out& out, ChronoLogWriter::Field& f, int shortness, T value) {
+    if (f.type == 'c') {
+      ChronoLogWriter::writeChar(out, f, (char)value);
+    } else if (f.type == 'd' || f.type == 'i') {
+      long long s = (long long)(typename std::make_signed<T>::type)value;
+      if (shortness == 1) s = (short)s;
+      if (shortness >= 2) s = (signed char)s;
+      ChronoLogWriter::writeInt(out, f, (s < 0) ? 0ull - (unsigned long long)s : (unsigned long long)s, s < 0);
+    } else {
+      unsigned long long u = (unsigned long long)(typename std::make_unsigned<T>::type)value;
+      if (shortness == 1) u = (unsigned short)u;
+      if (shortness >= 2) u = (unsigned char)u;
+      ChronoLogWriter::writeInt(out, f, u, false);
+    }
+  }
+
+  static void write(ChronoLogWriter::Out& out, ChronoLogWriter::Field& f, int, double value) {
+    if (f.type == 'a' || f.type == 'A') f.type = (char)(f.type + ('e' - 'a'));                          // Hex floats are written as %e
+    ChronoLogWriter::writeFloat(out, f, value);
+  }
+
+  static void write(ChronoLogWriter::Out& out, ChronoLogWriter::Field& f, int shortness, long double value) {
+    write(out, f, shortness, (double)value);
+  }
+
+  static void write(ChronoLogWriter::Out& out, ChronoLogWriter::Field& f, int, const char* value) {
+    ChronoLogWriter::writeStr(out, f, value);
+  }
+
+  static void write(ChronoLogWriter::Out& out, ChronoLogWriter::Field& f, int, void* value) {
+    ChronoLogWriter::writePtr(out, f, value);
+  }
+#endif
+};
+
+struct ChronoLogVaSource {
+  va_list args;
+
+  explicit ChronoLogVaSource(va_list src) { va_copy(args, src); }
+  ~ChronoLogVaSource()                    { va_end(args); }
+  ChronoLogVaSource(const ChronoLogVaSource&) = delete;
+  ChronoLogVaSource& operator=(const ChronoLogVaSource&) = delete;
+
+  template <typename T> T get() { return va_arg(args, T); }
+};
+
+#endif // CHRONOLOG_ISR || CHRONOLOG_DEFERRED || CHRONOLOG_BINARY || CHRONOLOG_PRINTF
+
+// vsnprintf, or the built-in formatter when CHRONOLOG_PRINTF is set (truncates, returns the length written).
+static inline int chronoLogVsnprintf(char* buf, size_t size, const char* fmt, va_list args) {
+  #if CHRONOLOG_PRINTF
+    if (size == 0) return 0;
+    ChronoLogVaSource src(args);
+    size_t len = ChronoLogFmt::render(fmt, src, buf, size - 1);
+    buf[len] = '\0';
+    return (int)len;
+  #else
+    return vsnprintf(buf, size, fmt, args);
+  #endif
+}
+
+#if CHRONOLOG_ISR || CHRONOLOG_DEFERRED
+
+struct ChronoLogRecordSource {                                                                          // Reads arguments stored by ChronoLogFmt::capture()
+  const uint8_t* p;
+
+  template <typename T> T get() {
+    if constexpr (std::is_same<T, const char*>::value) {
+      const char* str = (const char*)p;
+      p += strlen(str) + 1;
+      return str;
+    } else {
+      T value;
+      memcpy(&value, p, sizeof(T));
+      p += sizeof(T);
+      return value;
+    }
+  }
+};
+
+struct ChronoLogRecord {
+  const ChronoLogModule* logger;
+  void (*replay)(const ChronoLogRecord& rec);                                                           // Formats with the logger's own policies
+  const char*         fmt;
+  uint32_t            timestamp;                                                                        // Uptime in ms
+  uint8_t             level;
+  uint16_t            size;
+  char                taskName[16];
+  uint8_t             args[CHRONOLOG_RECORD_ARG_BYTES];
+};
+
+inline void chronoLogRecordDropped(ChronoLogLevel level);
+
+/*
+ * Records of interrupts and CHRONOLOG_DEFERRED calls. A full queue always drops the new record,
+ * whatever CHRONOLOG_ASYNC_POLICY says: an interrupt cannot wait, and only the drain may pop. Every
+ * record lost goes through drop(), so it also shows in ChronoLogAsync's counts and drop marker.
+ */
+template <size_t N>
+struct ChronoLogRecordQueue {
+  ChronoLogRing<ChronoLogRecord, N> ring;
+  std::atomic<uint32_t> dropped{0};
+
+  template <typename Source>
+  bool post(const ChronoLogModule* logger, void (*replay)(const ChronoLogRecord&), ChronoLogLevel level,
+            const char* taskName, const char* fmt, Source& src) {
+    uint8_t  args[CHRONOLOG_RECORD_ARG_BYTES];
+    uint16_t size = 0;
+    if (!ChronoLogFmt::capture(fmt, src, args, sizeof(args), size)) return false;               // Caller formats eagerly instead
+
+    uint32_t now = chronoLogUptimeMs();
+    bool queued  = ring.push([&](ChronoLogRecord& rec) {
+      rec.logger    = logger;
+      rec.replay    = replay;
+      rec.fmt       = fmt;
+      rec.timestamp = now;
+      rec.level     = (uint8_t)level;
+      rec.size      = size;
+      size_t n = 0;
+      while (taskName && n < sizeof(rec.taskName) - 1 && taskName[n]) n++;
+      memcpy(rec.taskName, taskName ? taskName : "", n);
+      rec.taskName[n] = '\0';
+      memcpy(rec.args, args, size);
+    });
+    if (!queued) drop(level);
+    return true;
+  }
+
+  void drop(ChronoLogLevel level) {
+    chronoLogFetchAdd(dropped, 1);
+    chronoLogRecordDropped(level);
+  }
+};
+
+inline size_t chronoLogDrainRecords();
+
+#endif // CHRONOLOG_ISR || CHRONOLOG_DEFERRED
+
+#if CHRONOLOG_ISR
+
+/*
+ * Interrupt-side state. Records are reserved with one CAS, filled with the format pointer and the
+ * raw argument bytes and formatted later from task context (the async drain task, or the next
+ * regular log call when running synchronously).
+ */
+struct ChronoLogIsr {
+  static inline ChronoLogRecordQueue<CHRONOLOG_ISR_QUEUE_LEN> queue;
+
+  static bool inIsr() { return chronoLogInIsr(); }
+
+  struct WordSource {                                                                                   // Integer arguments of the *FromISR templates
+    const long long* values;
+    size_t           count;
+    size_t           index;
+
+    template <typename T> T get() {
+      long long value = (index < count) ? values[index++] : 0;
+      if constexpr (std::is_pointer<T>::value) return (T)(uintptr_t)value;
+      else                                     return (T)value;
+    }
+  };
+};
+
+#endif // CHRONOLOG_ISR
+
+#if CHRONOLOG_DEFERRED
+
+struct ChronoLogDeferred {
+  static inline ChronoLogRecordQueue<CHRONOLOG_DEFERRED_QUEUE_LEN> queue;
+};
+
+#endif // CHRONOLOG_DEFERRED
+
+#if CHRONOLOG_BINARY && defined(__ELF__)
+extern "C" const char __start_chronolog_fmt[] __attribute__((weak));
+extern "C" const char __stop_chronolog_fmt[]  __attribute__((weak));
+
+// Places a format string literal in the "chronolog_fmt" section; binary frames then refer to it
+// by its offset and the decoder reads the text back from the firmware ELF. The compiler marks the
+// section loaded; linking with tools/chronolog_fmt.ld (or the same rule in the target's own linker
+// script) makes it an INFO section that takes no flash. The text is then unreadable on the target,
+// so such a format may only reach binary-mode loggers from task context: *FromISR() calls,
+// CHRONOLOG_DEFERRED and text-mode policies read it.
+#define CHRONOLOG_STR(s)                                                                              \
+  ([]() -> const char* {                                                                              \
+    static const char chronolog_str[] __attribute__((section("chronolog_fmt"), used)) = s;            \
+    return chronolog_str;                                                                             \
+  }())
+#else
+#define CHRONOLOG_STR(s) (s)
+#endif
+
+#if CHRONOLOG_BINARY
+
+/*
+ * Tokenized output. Every frame is SYNC, a two-byte varint payload length and the payload:
+ *
+ *   DEF  0x01 | varint id | string bytes
+ *   LOG  0x02 | level | varint second-of-day | module ref | task ref | format ref | arguments
+ *
+ * A ref is varint (n << 2 | tag): tag 0 is string-table id n, tag 1 is offset n into the
+ * chronolog_fmt section, tag 2 is an inline string of n bytes that follows. Integer arguments
+ * are zigzag varints, floating point an 8-byte double, %p a varint and %s a length-prefixed
+ * string. tools/chronolog_decode turns the stream back into the regular text layout.
+ */
+class ChronoLogBinary {
+public:
+  enum : uint8_t { SYNC = 0xA5, FRAME_DEF = 0x01, FRAME_LOG = 0x02, LEVEL_TRUNCATED = 0x80 };
+  enum : uint8_t { REF_TABLE = 0, REF_SECTION = 1, REF_INLINE = 2 };
+
+  struct Frame {
+    uint8_t* buf;
+    size_t   cap;
+    size_t   len      = 0;
+    bool     overflow = false;
+    uint8_t  claimed[3] = {0, 0, 0};
+    uint8_t  claims   = 0;
+    uint32_t epoch    = 0;                                                                              // Table generation the claims belong to
+
+    void put(uint8_t b) {
+      if (len < cap) buf[len++] = b;
+      else           overflow = true;
+    }
+
+    void bytes(const void* data, size_t n) {
+      if (len + n > cap) { overflow = true; return; }
+      memcpy(buf + len, data, n);
+      len += n;
+    }
+
+    void varint(uint64_t v) {
+      while (v >= 0x80) { put((uint8_t)(v | 0x80)); v >>= 7; }
+      put((uint8_t)v);
+    }
+
+    void zigzag(int64_t v) { varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+
+    void str(const char* s, size_t n) { varint(n); bytes(s, n); }
+
+    size_t begin(uint8_t type) {
+      put(SYNC);
+      size_t at = len;
+      put(0);
+      put(0);
+      put(type);
+      return at;
+    }
+
+    void end(size_t at) {                                                                             // Length is always a two-byte varint
+      size_t n = len - at - 2;
+      buf[at]     = (uint8_t)(0x80 | (n & 0x7F));
+      buf[at + 1] = (uint8_t)((n >> 7) & 0x7F);
+    }
+
+    template <typename T>
+    void value(T v) {
+      if constexpr (std::is_floating_point<T>::value) {
+        double d = (double)v;
+        bytes(&d, sizeof(d));
+      } else if constexpr (std::is_same<typename std::decay<T>::type, const char*>::value ||
+                           std::is_same<typename std::decay<T>::type, char*>::value) {
+        const char* s = v ? v : "(null)";
+        str(s, strlen(s));
+      } else if constexpr (std::is_pointer<T>::value) {
+        varint((uintptr_t)v);
+      } else if constexpr (std::is_null_pointer<T>::value) {
+        varint(0);
+      } else {
+        zigzag((int64_t)v);
+      }
+    }
+  };
+
+  struct Ref {
+    uint32_t    value;
+    uint8_t     tag;
+    const char* text;
+  };
+
+  static Ref resolve(const char* s, Frame& frame) {
+    #if defined(__ELF__)
+      if (__start_chronolog_fmt && s >= __start_chronolog_fmt && s < __stop_chronolog_fmt) {
+        return Ref{(uint32_t)(s - __start_chronolog_fmt), REF_SECTION, s};
+      }
+    #endif
+    uint32_t current = epoch.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < CHRONOLOG_BINARY_STRINGS; i++) {
+      const char* slot = strings[i].load(std::memory_order_acquire);
+      if (slot == nullptr && chronoLogCas(strings[i], slot, s, std::memory_order_acq_rel)) {
+        size_t at = frame.begin(FRAME_DEF);                                                             // Definition travels in the same write
+        frame.varint(i);
+        frame.bytes(s, strlen(s));
+        frame.end(at);
+        frame.claimed[frame.claims++] = i;
+        frame.epoch = current;
+        return Ref{i, REF_TABLE, s};
+      }
+      if (slot == s) {
+        if (ready[i].load(std::memory_order_acquire) == current) return Ref{i, REF_TABLE, s};
+        return Ref{(uint32_t)strlen(s), REF_INLINE, s};                                                 // Definition not written yet
+      }
+    }
+    chronoLogFetchAdd(spilled, 1);                                                                     // Table full
+    return Ref{(uint32_t)strlen(s), REF_INLINE, s};
+  }
+
+  static Ref inlineRef(const char* s) { return Ref{(uint32_t)strlen(s), REF_INLINE, s}; }
+
+  static void ref(Frame& frame, const Ref& r) {
+    frame.varint(((uint64_t)r.value << 2) | r.tag);
+    if (r.tag == REF_INLINE) frame.bytes(r.text, r.value);
+  }
+
+  // Builds DEF frames for new strings followed by the LOG frame; writeArgs(frame) appends the arguments.
+  template <typename WriteArgs>
+  static void encode(Frame& frame, ChronoLogLevel level, uint32_t seconds, const char* module,
+                     const Ref& task, const char* fmt, WriteArgs&& writeArgs) {
+    Ref moduleRef = resolve(module, frame);
+    Ref fmtRef    = resolve(fmt, frame);
+
+    size_t at = frame.begin(FRAME_LOG);
+    size_t levelAt = frame.len;
+    frame.put((uint8_t)level);
+    frame.varint(seconds);
+    ref(frame, moduleRef);
+    ref(frame, task);
+    ref(frame, fmtRef);
+
+    size_t argsAt = frame.len;
+    writeArgs(frame);
+    if (frame.overflow && levelAt < frame.cap) {                                                        // Keep the frame, drop the arguments
+      frame.len      = argsAt;
+      frame.overflow = false;
+      frame.buf[levelAt] |= LEVEL_TRUNCATED;
+    }
+    if (!frame.overflow) frame.end(at);
+  }
+
+  template <typename Source>
+  static void encodeArgs(Frame& frame, const char* fmt, Source& src) {
+    ChronoLogFmt::Spec spec;
+    while (ChronoLogFmt::next(fmt, spec)) {
+      for (uint8_t i = 0; i < spec.stars; i++) frame.value(src.template get<int>());
+      switch (spec.kind) {
+        case ChronoLogFmt::INT:     frame.value(src.template get<int>());          break;
+        case ChronoLogFmt::LONG:    frame.value(src.template get<long>());         break;
+        case ChronoLogFmt::LLONG:   frame.value(src.template get<long long>());    break;
+        case ChronoLogFmt::INTMAX:  frame.value(src.template get<intmax_t>());     break;
+        case ChronoLogFmt::SIZE:    frame.value(src.template get<size_t>());       break;
+        case ChronoLogFmt::PTRDIFF: frame.value(src.template get<ptrdiff_t>());    break;
+        case ChronoLogFmt::DOUBLE:  frame.value(src.template get<double>());       break;
+        case ChronoLogFmt::LDOUBLE: frame.value(src.template get<long double>());  break;
+        case ChronoLogFmt::PTR:     frame.value(src.template get<void*>());        break;
+        case ChronoLogFmt::STR:     frame.value(src.template get<const char*>());  break;
+        case ChronoLogFmt::SKIP:    (void)src.template get<void*>();              break;
+        default: break;
+      }
+    }
+  }
+
+  static void published(const Frame& frame) {                                                          // Call once the frame has been written or queued
+    if (frame.claims == 0 || frame.epoch != epoch.load(std::memory_order_acquire)) return;            // A reset came in between
+    for (uint8_t i = 0; i < frame.claims; i++) ready[frame.claimed[i]].store(frame.epoch, std::memory_order_release);
+  }
+
+  static void release(const Frame& frame) {                                                            // The frame was dropped: its ids are free again
+    if (frame.epoch != epoch.load(std::memory_order_acquire)) return;
+    for (uint8_t i = 0; i < frame.claims; i++) strings[frame.claimed[i]].store(nullptr, std::memory_order_release);
+  }
+
+  static void reset() {                                                                                 // Forget all ids, e.g. after the decoder reconnects
+    chronoLogFetchAdd(epoch, 1, std::memory_order_acq_rel);                                            // Ids published before this no longer count
+    for (uint8_t i = 0; i < CHRONOLOG_BINARY_STRINGS; i++) strings[i].store(nullptr, std::memory_order_release);
+  }
+
+  static bool definesStrings(const uint8_t* frame, size_t len) {                                       // Frame starts with a DEF that later frames may rely on
+    return len > 3 && frame[0] == SYNC && frame[3] == FRAME_DEF;
+  }
+
+  static size_t definitions(const uint8_t* data, size_t len) {                                         // Bytes of the DEF frames a write starts with
+    size_t n = 0;
+    while (len - n > 3 && data[n] == SYNC && data[n + 3] == FRAME_DEF) {
+      size_t frame = 3 + (size_t)((data[n + 1] & 0x7F) | (data[n + 2] & 0x7F) << 7);
+      if (frame > len - n) break;
+      n += frame;
+    }
+    return n;
+  }
+
+  static uint32_t inlined() { return spilled.load(std::memory_order_relaxed); }                        // Strings sent inline because the table was full
+
+private:
+  static inline std::atomic<const char*> strings[CHRONOLOG_BINARY_STRINGS] = {};
+  static inline std::atomic<uint32_t>    ready[CHRONOLOG_BINARY_STRINGS]   = {};                      // Epoch the definition was published in
+  static inline std::atomic<uint32_t>    epoch{1};
+  static inline std::atomic<uint32_t>    spilled{0};
+};
+
+#endif // CHRONOLOG_BINARY
+
+#if __cplusplus >= 201703L
+
+/*
+ * {}-style formatting for formats wrapped in CHRONOLOG_FMT(). The literal is parsed at compile time
+ * into a fixed list of pieces (literal text or a typed field); field count and field types are
+ * checked against the arguments with static_assert, and at runtime the pieces are written in order.
+ * Values are written by ChronoLogWriter, so neither vsnprintf nor the libc float formatter is involved.
+ *
+ * Fields are {} or {:[0][width][.precision][type]} with type one of d x X b c s f p; {{ and }}
+ * are literal braces. Output longer than the buffer is truncated.
+ */
+class ChronoLogFormat {
+public:
+  struct Piece {
+    uint16_t               begin;
+    uint16_t               len;
+    ChronoLogWriter::Field field;                                                                       // field.type 0: literal text
+  };
+
+  // Splits fmt into pieces, writing them to out when non-null; returns the piece count or -1.
+  static constexpr int parse(const char* fmt, Piece* out) {
+    int count = 0;
+    int i     = 0;
+    int start = 0;
+    while (true) {
+      char c = fmt[i];
+      if (c != '\0' && c != '{' && c != '}') {
+        i++;
+        continue;
+      }
+      bool escaped = (c != '\0' && fmt[i + 1] == c);
+      int  end     = escaped ? i + 1 : i;                                                               // An escaped brace ends the literal
+      if (end > start) {
+        if (out) out[count] = Piece{(uint16_t)start, (uint16_t)(end - start), {0, ' ', false, 0, false, 0, -1}};
+        count++;
+      }
+      if (c == '\0') return count;
+      if (escaped) {
+        i    += 2;
+        start = i;
+        continue;
+      }
+      if (c == '}') return -1;
+
+      ChronoLogWriter::Field field{'?', ' ', false, 0, false, 0, -1};
+      i++;
+      if (fmt[i] == ':') {
+        i++;
+        if (fmt[i] == '0') {
+          field.fill = '0';
+          i++;
+        }
+        int width = 0;
+        while (fmt[i] >= '0' && fmt[i] <= '9') width = width * 10 + (fmt[i++] - '0');
+        if (width > 255) return -1;
+        field.width = (uint16_t)width;
+        if (fmt[i] == '.') {
+          int precision = 0;
+          i++;
+          if (fmt[i] < '0' || fmt[i] > '9') return -1;
+          while (fmt[i] >= '0' && fmt[i] <= '9') precision = precision * 10 + (fmt[i++] - '0');
+          if (precision > 255) return -1;
+          field.precision = (int16_t)precision;
+        }
+        for (const char* t = "dxXbcsfp"; *t; t++) {
+          if (fmt[i] == *t) field.type = fmt[i++];
+        }
+      }
+      if (fmt[i] != '}') return -1;
+      if (out) out[count] = Piece{0, 0, field};
+      count++;
+      start = ++i;
+    }
+  }
+
+  enum Category { CAT_INT, CAT_CHAR, CAT_BOOL, CAT_FLOAT, CAT_STR, CAT_PTR, CAT_OTHER };
+
+  template <typename T>
+  static constexpr Category category() {
+    using U = typename std::decay<T>::type;
+    if constexpr (std::is_same<U, bool>::value)                                        return CAT_BOOL;
+    else if constexpr (std::is_same<U, char>::value)                                   return CAT_CHAR;
+    else if constexpr (std::is_integral<U>::value || std::is_enum<U>::value)           return CAT_INT;
+    else if constexpr (std::is_floating_point<U>::value)                               return CAT_FLOAT;
+    else if constexpr (std::is_same<U, const char*>::value || std::is_same<U, char*>::value) return CAT_STR;
+    else if constexpr (std::is_pointer<U>::value || std::is_null_pointer<U>::value)    return CAT_PTR;
+    else                                                                               return CAT_OTHER;
+  }
+
+  static constexpr bool accepts(char type, Category cat) {
+    switch (type) {
+      case '?':                               return cat != CAT_OTHER;
+      case 'd': case 'x': case 'X': case 'b': return cat == CAT_INT || cat == CAT_CHAR;
+      case 'c':                               return cat == CAT_INT || cat == CAT_CHAR;
+      case 's':                               return cat == CAT_STR || cat == CAT_BOOL;
+      case 'f':                               return cat == CAT_FLOAT;
+      case 'p':                               return cat == CAT_PTR || cat == CAT_STR;
+      default:                                return false;
+    }
+  }
+
+  template <int N> struct Pieces { Piece at[N]; };
+
+  template <typename F>
+  struct Parsed {
+    static constexpr int count = parse(F::text(), nullptr);
+    static constexpr int size  = (count > 0) ? count : 1;
+
+    static constexpr Pieces<size> build() {
+      Pieces<size> pieces{};
+      if (count > 0) parse(F::text(), pieces.at);
+      return pieces;
+    }
+    static constexpr Pieces<size> pieces = build();
+
+    static constexpr size_t fields() {
+      size_t n = 0;
+      for (int i = 0; i < count; i++) n += (pieces.at[i].field.type != 0);
+      return n;
+    }
+  };
+
+  template <typename F, typename... Args>
+  static constexpr bool typesMatch() {
+    constexpr Category cats[] = {category<Args>()..., CAT_OTHER};
+    if (Parsed<F>::fields() != sizeof...(Args)) return true;                                         // Reported by the count check
+    size_t arg = 0;
+    for (int i = 0; i < Parsed<F>::count; i++) {
+      char type = Parsed<F>::pieces.at[i].field.type;
+      if (type != 0 && !accepts(type, cats[arg++])) return false;
+    }
+    return true;
+  }
+
+  // Formats into buf (always terminated) and returns the length written.
+  template <typename F, typename... Args>
+  static size_t format(F, char* buf, size_t cap, const Args&... args) {
+    static_assert(Parsed<F>::count >= 0, "ChronoLog: malformed {} format string");
+    static_assert(Parsed<F>::fields() == sizeof...(Args), "ChronoLog: argument count does not match the format string");
+    static_assert(typesMatch<F, Args...>(), "ChronoLog: argument type is unsupported or does not match its field");
+
+    if (cap == 0) return 0;
+    ChronoLogWriter::Out out{buf, buf + cap - 1};
+    const char* text  = F::text();
+    int         piece = 0;
+    auto literals = [&] {
+      for (; piece < Parsed<F>::count && Parsed<F>::pieces.at[piece].field.type == 0; piece++) {
+        out.put(text + Parsed<F>::pieces.at[piece].begin, Parsed<F>::pieces.at[piece].len);
+      }
+    };
+    literals();
+    ((write(out, Parsed<F>::pieces.at[piece++].field, args), literals()), ...);
+    *out.p = '\0';
+    return (size_t)(out.p - buf);
+  }
+
+private:
+  template <typename T>
+  static void write(ChronoLogWriter::Out& out, const ChronoLogWriter::Field& field, const T& v) {
+    constexpr Category cat = category<T>();
+    ChronoLogWriter::Field f = field;
+    if constexpr (cat == CAT_BOOL) {
+      f.left = true;
+      ChronoLogWriter::writeStr(out, f, v ? "true" : "false");
+    } else if constexpr (cat == CAT_CHAR || cat == CAT_INT) {
+      if (f.type == 'c' || (cat == CAT_CHAR && f.type == '?')) {
+        f.left = true;
+        return ChronoLogWriter::writeChar(out, f, (char)v);
+      }
+      using U = typename std::conditional<std::is_enum<T>::value, std::underlying_type<T>, std::decay<T>>::type::type;
+      if constexpr (std::is_signed<U>::value) {
+        long long s = (long long)v;
+        if (f.type == 'd' || f.type == '?') {
+          return ChronoLogWriter::writeInt(out, f, (s < 0) ? 0ull - (unsigned long long)s : (unsigned long long)s, s < 0);
+        }
+        ChronoLogWriter::writeInt(out, f, (unsigned long long)(typename std::make_unsigned<U>::type)v, false);
+      } else {
+        ChronoLogWriter::writeInt(out, f, (unsigned long long)v, false);
+      }
+    } else if constexpr (cat == CAT_FLOAT) {
+      ChronoLogWriter::writeFloat(out, f, (double)v);
+    } else if constexpr (cat == CAT_STR) {
+      if (f.type == 'p') return ChronoLogWriter::writePtr(out, f, (const void*)v);
+      f.left = true;
+      ChronoLogWriter::writeStr(out, f, v);
+    } else {
+      ChronoLogWriter::writePtr(out, f, (const void*)v);
+    }
+  }
+};
+
+#endif // __cplusplus >= 201703L
+
+#if CHRONOLOG_ASYNC
+
+struct ChronoLogLine {
+  uint64_t        stamp;                                                                                // ChronoLogClock::nowUs(), orders lines across cores
+  ChronoLogTarget target;
+  uint16_t        len;
+  uint8_t         level;
+  char            text[CHRONOLOG_ASYNC_LINE_LEN];
+};
+
+enum ChronoLogPolicy {                                                                                  // Behaviour of submit() when the ring is full
+  CHRONOLOG_POLICY_DROP_NEWEST,                                                                         // The new line is dropped
+  CHRONOLOG_POLICY_DROP_OLDEST,                                                                         // The oldest line on the core's ring makes room
+  CHRONOLOG_POLICY_BLOCK,                                                                               // Wait for the drain task
+  CHRONOLOG_POLICY_BLOCK_TIMEOUT,                                                                       // Wait up to CHRONOLOG_ASYNC_BLOCK_MS, then drop
+  CHRONOLOG_POLICY_DROP_BELOW                                                                           // Keep the last quarter for CHRONOLOG_ASYNC_KEEP_LEVEL and above
+};
+
+inline unsigned chronoLogCoreId() {
+  #if CHRONOLOG_ASYNC_CORES == 1
+    return 0;
+  #elif defined(CHRONOLOG_FREERTOS)
+    return (unsigned)xPortGetCoreID() % CHRONOLOG_ASYNC_CORES;
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) && defined(CONFIG_SMP)
+    return (unsigned)arch_curr_cpu()->id % CHRONOLOG_ASYNC_CORES;
+  #elif defined(CHRONOLOG_PLATFORM_POSIX) && defined(__linux__)
+    int cpu = sched_getcpu();                                                                           // vDSO/rseq read, no syscall on current glibc
+    return cpu > 0 ? (unsigned)cpu % CHRONOLOG_ASYNC_CORES : 0;
+  #else
+    return 0;
+  #endif
+}
+
+/*
+ * Async engine. Loggers format complete lines straight into the ring of the core they run on and
+ * return; the drain task (FreeRTOS task, Zephyr thread or std::thread) merges the rings by
+ * timestamp and hands the lines to the transport. Where no scheduler is available start() only
+ * switches loggers to queueing and drain() has to be pumped from the main loop.
+ * Each ring keeps its multi-producer CAS: a task can be preempted by another one on the same core,
+ * or migrate mid-call on a host, but the cache lines it touches normally stay with one core.
+ */
+class ChronoLogAsync {
+public:
+  typedef void (*WriteHook)(const char* data, size_t len);
+
+  static ChronoLogAsync& instance() {
+    static ChronoLogAsync engine;
+    return engine;
+  }
+
+  bool start() {
+    if (active.load(std::memory_order_acquire)) return true;
+    active.store(true, std::memory_order_release);
+
+    #if defined(CHRONOLOG_FREERTOS)
+      if (xTaskCreate(taskEntry, "ChronoLog", CHRONOLOG_ASYNC_TASK_STACK, this,
+                      CHRONOLOG_ASYNC_TASK_PRIO, &taskHandle) != pdPASS) {
+        taskHandle = nullptr;
+        active.store(false, std::memory_order_release);
+        return false;
+      }
+    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+      static K_THREAD_STACK_DEFINE(drainStack, CHRONOLOG_ASYNC_TASK_STACK);
+      static struct k_thread drainThread;
+      if (!threadStarted) {
+        k_sem_init(&wakeSem, 0, 1);
+        k_thread_create(&drainThread, drainStack, K_THREAD_STACK_SIZEOF(drainStack),
+                        threadEntry, this, nullptr, nullptr,
+                        K_PRIO_PREEMPT(CHRONOLOG_ASYNC_TASK_PRIO), 0, K_NO_WAIT);
+        k_thread_name_set(&drainThread, "ChronoLog");
+        threadStarted = true;
+      }
+    #elif defined(CHRONOLOG_PLATFORM_POSIX)
+      worker = std::thread([this] { run(); });
+    #endif
+    return true;
+  }
+
+  void stop() {                                                                                         // Back to synchronous output, queue is flushed
+    if (!chronoLogExchange(active, false, std::memory_order_acq_rel)) return;
+    #if defined(CHRONOLOG_PLATFORM_POSIX)
+      wakeCv.notify_one();
+      if (worker.joinable()) worker.join();
+    #endif
+    drain();
+  }
+
+  bool running() const { return active.load(std::memory_order_acquire); }
+
+  template <typename Fill>
+  bool submit(ChronoLogLevel level, Fill&& fill) {                                                      // fill() sets the line's stamp when CHRONOLOG_ASYNC_CORES > 1
+    Ring& ring             = lanes[chronoLogCoreId()].ring;
+    ChronoLogPolicy policy = (ChronoLogPolicy)policyMode.load(std::memory_order_relaxed);
+    if (policy == CHRONOLOG_POLICY_DROP_BELOW && level > keepLevel.load(std::memory_order_relaxed) &&
+        ring.size() >= Ring::capacity() - Ring::capacity() / 4) {
+      return drop(level);
+    }
+
+    uint32_t since   = 0;
+    bool     waiting = false;
+    while (!ring.push([&](ChronoLogLine& line) {
+      line.level = (uint8_t)level;
+      fill(line);
+    })) {
+      if (policy == CHRONOLOG_POLICY_DROP_OLDEST) {
+        if (!evictOldest(ring)) return drop(level);                                                    // A drain is running and frees slots itself
+      } else if (policy == CHRONOLOG_POLICY_BLOCK || policy == CHRONOLOG_POLICY_BLOCK_TIMEOUT) {
+        if (!waiting) {
+          since   = chronoLogUptimeMs();
+          waiting = true;
+        }
+        if (policy == CHRONOLOG_POLICY_BLOCK_TIMEOUT &&
+            chronoLogUptimeMs() - since >= blockMs.load(std::memory_order_relaxed)) {
+          return drop(level);
+        }
+        if (!waitForDrain()) return drop(level);
+      } else {
+        return drop(level);
+      }
+    }
+    wake();
+    return true;
+  }
+
+  // Applies to lines submitted from now on. waitMs is used by CHRONOLOG_POLICY_BLOCK_TIMEOUT,
+  // keep by CHRONOLOG_POLICY_DROP_BELOW.
+  void setPolicy(ChronoLogPolicy policy, uint32_t waitMs = CHRONOLOG_ASYNC_BLOCK_MS,
+                 ChronoLogLevel keep = CHRONOLOG_ASYNC_KEEP_LEVEL) {
+    blockMs.store(waitMs, std::memory_order_relaxed);
+    keepLevel.store((uint8_t)keep, std::memory_order_relaxed);
+    policyMode.store((uint8_t)policy, std::memory_order_relaxed);
+  }
+
+  ChronoLogPolicy policy() const { return (ChronoLogPolicy)policyMode.load(std::memory_order_relaxed); }
+
+  void wake() {
+    #if defined(CHRONOLOG_FREERTOS)
+      if (taskHandle) xTaskNotifyGive(taskHandle);
+    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+      if (threadStarted) k_sem_give(&wakeSem);
+    #elif defined(CHRONOLOG_PLATFORM_POSIX)
+      wakeCv.notify_one();
+    #endif
+  }
+
+  size_t drain() {                                                                                     // Lines queued so far, oldest stamp first
+    if (chronoLogExchange(draining, true, std::memory_order_acquire)) return 0;                        // Another context is already draining
+    size_t count = 0;
+    #if CHRONOLOG_ISR || CHRONOLOG_DEFERRED
+      count += chronoLogDrainRecords();
+    #endif
+    ChronoLogLine batch[CHRONOLOG_ASYNC_BATCH];
+    size_t lines = 0;
+    ChronoLogTarget target = ChronoLogTarget();                                                         // Where the marker goes
+    for (;;) {
+      size_t held = take(batch);
+      if (held == 0) break;
+      target = batch[held - 1].target;
+      lines += held;
+      output(batch, held);                                                                              // Rings are free meanwhile: DROP_OLDEST can evict
+    }
+    if (count + lines > 0) reportDrops(target);                                                         // Space has freed up, say what was lost
+    draining.store(false, std::memory_order_release);
+    return count + lines;
+  }
+
+  void output(ChronoLogLevel level, ChronoLogTarget target, const char* data, size_t len) const {
+    WriteHook hook = writeHook.load(std::memory_order_acquire);
+    if (hook) hook(data, len);
+    else      ChronoLogSinks::write(level, target, data, len);
+  }
+
+  void output(const ChronoLogLine* batch, size_t count) const {                                         // Runs of lines for one target go out in one transport write
+    WriteHook hook = writeHook.load(std::memory_order_acquire);
+    ChronoLogPart parts[CHRONOLOG_ASYNC_BATCH];
+    size_t n = 0;
+    ChronoLogTarget target = ChronoLogTarget();
+    for (size_t i = 0; i < count; i++) {
+      const ChronoLogLine& line = batch[i];
+      if (hook) {
+        hook(line.text, line.len);
+        continue;
+      }
+      size_t take = ChronoLogSinks::fanOut((ChronoLogLevel)line.level, line.text, line.len);
+      if (!take) continue;
+      if (n > 0 && line.target != target) {
+        ChronoLogTransport::write(target, parts, n);
+        n = 0;
+      }
+      target     = line.target;
+      parts[n++] = ChronoLogPart{line.text, take};
+    }
+    ChronoLogTransport::write(target, parts, n);
+  }
+
+  void     setWriteHook(WriteHook hook)  { writeHook.store(hook, std::memory_order_release); }        // Redirects drained lines, e.g. to a mock
+  void     recordDropped(ChronoLogLevel level) { drop(level); }                                         // A full ISR or deferred queue lost one
+  uint32_t droppedCount(ChronoLogLevel level) const { return drops[level].load(std::memory_order_relaxed); }
+
+  uint32_t droppedCount() const {
+    uint32_t total = 0;
+    for (const std::atomic<uint32_t>& n : drops) total += n.load(std::memory_order_relaxed);
+    return total;
+  }
+
+  size_t pending() const {
+    size_t total = 0;
+    for (const Lane& lane : lanes) total += lane.ring.size();
+    return total;
+  }
+
+  size_t highWaterMark() const {                                                                        // Fullest ring
+    size_t peak = 0;
+    for (const Lane& lane : lanes) if (lane.ring.highWaterMark() > peak) peak = lane.ring.highWaterMark();
+    return peak;
+  }
+
+private:
+  typedef ChronoLogRing<ChronoLogLine, CHRONOLOG_ASYNC_QUEUE_LEN> Ring;
+
+  struct alignas(CHRONOLOG_ASYNC_CORES > 1 ? 64 : alignof(Ring)) Lane {                                // Own cache lines per core
+    Ring ring;
+  };
+
+  Lane                   lanes[CHRONOLOG_ASYNC_CORES];
+  std::atomic<bool>      active{false};
+  std::atomic<bool>      draining{false};                                                               // Held by the one context writing lines out
+  std::atomic<bool>      popping{false};                                                                // Held while a line is taken off a ring
+  std::atomic<uint32_t>  drops[CHRONOLOG_LEVEL_DEBUG + 1] = {};
+  std::atomic<uint32_t>  unreported{0};                                                                 // Drops not yet announced by a marker line
+  std::atomic<uint8_t>   policyMode{(uint8_t)CHRONOLOG_ASYNC_POLICY};
+  std::atomic<uint8_t>   keepLevel{(uint8_t)CHRONOLOG_ASYNC_KEEP_LEVEL};
+  std::atomic<uint32_t>  blockMs{CHRONOLOG_ASYNC_BLOCK_MS};
+  std::atomic<WriteHook> writeHook{nullptr};
+
+  bool drop(ChronoLogLevel level) {
+    chronoLogFetchAdd(drops[level], 1);
+    chronoLogFetchAdd(unreported, 1);
+    return false;
+  }
+
+  // Pops up to CHRONOLOG_ASYNC_BATCH lines, oldest stamp first, holding the consumer side only while
+  // copying them out.
+  size_t take(ChronoLogLine* batch) {
+    while (chronoLogExchange(popping, true, std::memory_order_acquire)) {}                              // evictOldest() holds it for one pop
+    size_t held = 0;
+    while (held < CHRONOLOG_ASYNC_BATCH) {
+      Lane* next                = nullptr;
+      const ChronoLogLine* head = nullptr;
+      for (Lane& lane : lanes) {
+        const ChronoLogLine* front = lane.ring.front();
+        if (front && (!head || (int64_t)(front->stamp - head->stamp) < 0)) {
+          head = front;
+          next = &lane;
+        }
+      }
+      if (!next) break;
+      ChronoLogLine& line = batch[held];
+      if (!next->ring.pop([&line](ChronoLogLine& slot) {
+        line.target = slot.target;
+        line.level  = slot.level;
+        line.len    = slot.len;
+        memcpy(line.text, slot.text, slot.len);
+      })) break;
+      held++;
+    }
+    popping.store(false, std::memory_order_release);
+    return held;
+  }
+
+  bool evictOldest(Ring& ring) {                                                                        // Only while nobody else pops
+    if (chronoLogExchange(popping, true, std::memory_order_acquire)) return false;
+    #if CHRONOLOG_BINARY
+      const ChronoLogLine* head = ring.front();
+      if (head && ChronoLogBinary::definesStrings((const uint8_t*)head->text, head->len)) {
+        popping.store(false, std::memory_order_release);                                                // Later frames use its ids: drop the new line instead
+        return false;
+      }
+    #endif
+    uint8_t level = 0;
+    bool evicted  = ring.pop([&level](ChronoLogLine& slot) { level = slot.level; });
+    popping.store(false, std::memory_order_release);
+    if (evicted) drop((ChronoLogLevel)level);
+    return true;
+  }
+
+  bool waitForDrain() {                                                                                 // false: nothing will make room, drop the line
+    if (chronoLogInIsr()) return false;
+    wake();
+    #if defined(CHRONOLOG_FREERTOS)
+      if (taskHandle && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        vTaskDelay(1);
+        return true;
+      }
+    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+      if (threadStarted && !k_is_pre_kernel()) {
+        k_msleep(1);
+        return true;
+      }
+    #elif defined(CHRONOLOG_PLATFORM_POSIX)
+      if (active.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        return true;
+      }
+    #endif
+    return drain() > 0;                                                                                 // No drain task to wait for, make room here
+  }
+
+  void reportDrops(ChronoLogTarget target);                                                             // "*** 12 messages dropped ***"
+
+#if defined(CHRONOLOG_FREERTOS)
+  TaskHandle_t taskHandle = nullptr;
+
+  static void taskEntry(void* arg) { static_cast<ChronoLogAsync*>(arg)->run(); }
+#elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+  struct k_sem wakeSem;
+  bool threadStarted = false;
+
+  static void threadEntry(void* arg, void*, void*) { static_cast<ChronoLogAsync*>(arg)->run(); }
+#elif defined(CHRONOLOG_PLATFORM_POSIX)
+  std::thread             worker;
+  std::mutex              wakeLock;
+  std::condition_variable wakeCv;
+
+public:
+  ~ChronoLogAsync() { stop(); }
+
+private:
+#endif
+
+  ChronoLogAsync() = default;
+  ChronoLogAsync(const ChronoLogAsync&) = delete;
+  ChronoLogAsync& operator=(const ChronoLogAsync&) = delete;
+
+  static bool recordsWaiting() {                                                                        // ISR or deferred records not replayed yet
+    bool waiting = false;
+    #if CHRONOLOG_ISR
+      waiting = waiting || !ChronoLogIsr::queue.ring.empty();
+    #endif
+    #if CHRONOLOG_DEFERRED
+      waiting = waiting || !ChronoLogDeferred::queue.ring.empty();
+    #endif
+    return waiting;
+  }
+
+  void run() {
+    #if defined(CHRONOLOG_FREERTOS)
+      for (;;) {
+        drain();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+      }
+    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+      for (;;) {
+        drain();
+        k_sem_take(&wakeSem, K_MSEC(100));
+      }
+    #elif defined(CHRONOLOG_PLATFORM_POSIX)
+      while (active.load(std::memory_order_acquire)) {
+        drain();
+        std::unique_lock<std::mutex> lock(wakeLock);
+        wakeCv.wait_for(lock, std::chrono::milliseconds(10), [this] {
+          return pending() != 0 || recordsWaiting() || !active.load(std::memory_order_acquire);
+        });
+      }
+    #endif
+  }
+};
+
+#endif // CHRONOLOG_ASYNC
+
+/*
+ * Counter behind ChronoLogClock: a free-running 32-bit counter ticking at hz, plus an optional
+ * coarse millisecond tick that lets the clock count wraps it did not see between two reads.
+ */
+struct ChronoLogClockSource {
+  uint32_t (*counter)();
+  uint32_t (*millis)();
+  uint32_t hz;
+};
+
+/*
+ * 64-bit monotonic microseconds since boot. ESP-IDF and POSIX read a native 64-bit timer; the
+ * other platforms extend a fast 32-bit counter (DWT CYCCNT, k_cycle_get_32, micros) on every read,
+ * using the millisecond tick to recover wraps between reads that are further apart than one
+ * counter period. setSource() swaps in another counter, e.g. a fake one in host tests.
+ */
+class ChronoLogClock {
+public:
+  static uint64_t nowUs() {
+    #if defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(CHRONOLOG_PLATFORM_POSIX)
+      if (!injected().load(std::memory_order_acquire)) return nativeUs();
+    #endif
+    ChronoLogCritical guard;
+    State& s = state();
+    #if defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(CHRONOLOG_PLATFORM_POSIX)
+      return s.source ? extend(s, *s.source) : nativeUs();
+    #else
+      return extend(s, s.source ? *s.source : platformSource());
+    #endif
+  }
+
+  static uint64_t sinceLastUs(uint64_t now) {                                                           // For CHRONOLOG_TIME_DELTA
+    ChronoLogCritical guard;
+    State& s    = state();
+    uint64_t d  = (s.lastLineUs && now > s.lastLineUs) ? now - s.lastLineUs : 0;
+    if (now > s.lastLineUs) s.lastLineUs = now;
+    return d;
+  }
+
+  static void setSource(const ChronoLogClockSource* source) {                                          // nullptr restores the platform counter
+    ChronoLogCritical guard;
+    State& s = state();
+    s.source = source;
+    s.seeded = false;
+    #if defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(CHRONOLOG_PLATFORM_POSIX)
+      injected().store(source != nullptr, std::memory_order_release);
+    #endif
+  }
+
+private:
+  struct State {
+    const ChronoLogClockSource* source;
+    bool     seeded;
+    uint32_t lastCount;
+    uint32_t lastMs;
+    uint32_t carry;                                                                                     // Counts not yet folded into seconds
+    uint64_t seconds;
+    uint64_t lastLineUs;
+  };
+
+  static State& state() {
+    static State s;
+    return s;
+  }
+
+
+#if defined(CHRONOLOG_PLATFORM_ESP_IDF) || defined(CHRONOLOG_PLATFORM_POSIX)
+  static std::atomic<bool>& injected() {
+    static std::atomic<bool> flag{false};
+    return flag;
+  }
+
+  static uint64_t nativeUs() {
+    #if defined(CHRONOLOG_PLATFORM_ESP_IDF)
+      return (uint64_t)esp_timer_get_time();
+    #else
+      struct timespec ts;
+      clock_gettime(CLOCK_MONOTONIC, &ts);
+      return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+    #endif
+  }
+#else
+  static const ChronoLogClockSource& platformSource() {
+    #if defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(DWT_CTRL_CYCCNTENA_Msk)
+      static const ChronoLogClockSource src = {[]() -> uint32_t { return DWT->CYCCNT; }, HAL_GetTick, startCycleCounter()};
+    #elif defined(CHRONOLOG_PLATFORM_STM32_HAL)
+      static const ChronoLogClockSource src = {HAL_GetTick, nullptr, 1000};                             // Cortex-M0/M0+: no cycle counter, ms resolution
+    #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+      static const ChronoLogClockSource src = {[]() -> uint32_t { return k_cycle_get_32(); },
+                                               []() -> uint32_t { return k_uptime_get_32(); },
+                                               (uint32_t)sys_clock_hw_cycles_per_sec()};
+    #elif defined(CHRONOLOG_PLATFORM_ARDUINO)
+      static const ChronoLogClockSource src = {[]() -> uint32_t { return (uint32_t)micros(); },
+                                               []() -> uint32_t { return (uint32_t)millis(); }, 1000000};
+    #else
+      static const ChronoLogClockSource src = {[]() -> uint32_t { return 0; }, nullptr, 1000000};
+    #endif
+    return src;
+  }
+#endif
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(DWT_CTRL_CYCCNTENA_Msk)
+  static uint32_t startCycleCounter() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+    return SystemCoreClock;
+  }
+#endif
+
+  static uint64_t extend(State& s, const ChronoLogClockSource& src) {
+    uint32_t count = src.counter();
+    uint32_t ms    = src.millis ? src.millis() : 0;
+
+    if (!s.seeded) {                                                                                    // Line up with uptime, the counter may have wrapped already
+      uint64_t start = src.millis ? (uint64_t)ms * src.hz / 1000 : count;
+      s.seconds   = start / src.hz;
+      s.carry     = (uint32_t)(start % src.hz);
+      s.seeded    = true;
+    } else {
+      uint64_t elapsed = (uint32_t)(count - s.lastCount);
+      if (src.millis) {
+        uint64_t coarse = (uint64_t)(uint32_t)(ms - s.lastMs) * src.hz;                               // Elapsed counts, times 1000
+        if (coarse >= 0x80000000ull * 1000) {                                                           // Far enough apart that wraps may have been missed
+          int64_t missed = (int64_t)(coarse / 1000) - (int64_t)elapsed + 0x80000000ll;
+          if (missed > 0) elapsed += (uint64_t)missed & ~0xFFFFFFFFull;
+        }
+      }
+      uint64_t c = s.carry + elapsed;
+      if (c >= src.hz) {
+        uint64_t secs = c / src.hz;
+        s.seconds += secs;
+        c         -= secs * src.hz;
+      }
+      s.carry = (uint32_t)c;
+    }
+    s.lastCount = count;
+    s.lastMs    = ms;
+
+    uint32_t sub = (src.hz % 1000000 == 0) ? s.carry / (src.hz / 1000000)
+                                           : (uint32_t)((uint64_t)s.carry * 1000000 / src.hz);
+    return s.seconds * 1000000 + sub;
+  }
+};
+
+/*
+ * Shared "HH:MM:SS" cache. The clock is still read for every line, but the text is only rebuilt
+ * when the second changes: short steps increment the digits in place, and only large jumps (or an
+ * hour rollover on the wall clock, where DST may kick in) go back to localtime_r or to dividing
+ * the uptime down. Readers copy a snapshot under a sequence counter; a task that finds the cache
+ * mid-update works on its own copy instead of waiting.
+ */
+class ChronoLogTimeCache {
+public:
+  struct Snapshot {
+    uint64_t base;                                                                                      // Microsecond clock at the start of the second
+    uint32_t secondOfDay;
+    char     text[8];                                                                                   // "HH:MM:SS", not terminated
+  };
+
+  static void format(char* buf, size_t size, bool millis) {                                           // "HH:MM:SS" or "HH:MM:SS.mmm"
+    if (size == 0) return;
+    uint32_t micros;
+    Snapshot snap = now(&micros);
+    char text[12];
+    memcpy(text, snap.text, sizeof(snap.text));
+    size_t len = sizeof(snap.text);
+    if (millis) {
+      uint32_t ms = micros / 1000;
+      text[8]  = '.';
+      text[9]  = (char)('0' + ms / 100);
+      text[10] = (char)('0' + (ms / 10) % 10);
+      text[11] = (char)('0' + ms % 10);
+      len      = sizeof(text);
+    }
+    if (len > size - 1) len = size - 1;
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+  }
+
+  static uint32_t secondsOfDay() { return now(nullptr).secondOfDay; }
+
+  static Snapshot now(uint32_t* micros) {                                                               // micros: position within the second
+    uint64_t ticks = read();
+    Snapshot snap;
+    bool cached    = load(snap);
+    uint64_t delta = ticks - snap.base;
+    if (!cached || ticks < snap.base || delta >= PER_SECOND) {
+      if (!cached || ticks < snap.base || delta >= MAX_STEPS * PER_SECOND || !advance(snap, (uint32_t)delta)) {
+        render(snap, ticks);                                                                            // Also taken when the clock was set back
+      }
+      store(snap);                                                                                      // A stale writer only costs the next reader a few steps
+    }
+    if (micros) *micros = (uint32_t)(ticks - snap.base);
+    return snap;
+  }
+
+private:
+  enum : uint32_t { PER_SECOND = 1000000, MAX_STEPS = 8 };                                            // Longer gaps are rendered from scratch
+
+  static uint64_t read() {                                                                              // Microseconds
+    #if defined(CHRONOLOG_WALL_CLOCK)
+      struct timeval tv;
+      gettimeofday(&tv, NULL);
+      return (uint64_t)tv.tv_sec * 1000000 + (uint64_t)tv.tv_usec;
+    #else
+      return ChronoLogClock::nowUs();
+    #endif
+  }
+
+  static void setDigits(Snapshot& snap, uint32_t hour, uint32_t min, uint32_t sec) {
+    snap.secondOfDay = hour * 3600 + min * 60 + sec;
+    const uint32_t parts[3] = {hour, min, sec};
+    for (int i = 0; i < 3; i++) {
+      snap.text[i * 3]     = (char)('0' + parts[i] / 10);
+      snap.text[i * 3 + 1] = (char)('0' + parts[i] % 10);
+      if (i < 2) snap.text[i * 3 + 2] = ':';
+    }
+  }
+
+  static void render(Snapshot& snap, uint64_t ticks) {
+    uint64_t sec = ticks / PER_SECOND;
+    snap.base    = sec * PER_SECOND;
+    #if defined(CHRONOLOG_WALL_CLOCK)
+      time_t wall = (time_t)sec;
+      struct tm timeinfo;
+      localtime_r(&wall, &timeinfo);
+      setDigits(snap, (uint32_t)timeinfo.tm_hour, (uint32_t)timeinfo.tm_min, (uint32_t)timeinfo.tm_sec);
+    #else
+      uint32_t day = (uint32_t)(sec % 86400);
+      setDigits(snap, day / 3600, (day / 60) % 60, day % 60);
+    #endif
+  }
+
+  static bool tick(Snapshot& snap) {                                                                    // One second forward, digit by digit
+    char* t = snap.text;
+    snap.secondOfDay++;
+    if (++t[7] <= '9') return true;
+    t[7] = '0';
+    if (++t[6] <= '5') return true;
+    t[6] = '0';
+    if (++t[4] <= '9') return true;
+    t[4] = '0';
+    if (++t[3] <= '5') return true;
+    t[3] = '0';
+    #if defined(CHRONOLOG_WALL_CLOCK)
+      return false;                                                                                     // New hour, let localtime_r apply the zone rules
+    #else
+      if (t[0] == '2' && t[1] == '3') {
+        t[0] = t[1] = '0';
+        snap.secondOfDay = 0;
+      } else if (++t[1] > '9') {
+        t[1] = '0';
+        t[0]++;
+      }
+      return true;
+    #endif
+  }
+
+  static bool advance(Snapshot& snap, uint32_t delta) {
+    for (; delta >= PER_SECOND; delta -= PER_SECOND) {
+      if (!tick(snap)) return false;
+      snap.base += PER_SECOND;
+    }
+    return true;
+  }
+
+#if defined(CHRONOLOG_HAS_ATOMIC)
+  struct Shared {
+    std::atomic<uint32_t> seq{0};                                                                       // Odd while an update is in progress
+    std::atomic<uint32_t> words[sizeof(Snapshot) / 4];
+  };
+
+  static Shared& shared() {
+    static Shared cache;
+    return cache;
+  }
+
+  static bool load(Snapshot& snap) {
+    Shared& cache = shared();
+    uint32_t words[sizeof(Snapshot) / 4];
+    uint32_t seq = cache.seq.load(std::memory_order_acquire);
+    for (size_t i = 0; i < sizeof(Snapshot) / 4; i++) words[i] = cache.words[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    memcpy(&snap, words, sizeof(snap));
+    return !(seq & 1) && cache.seq.load(std::memory_order_relaxed) == seq && snap.text[0] != '\0';
+  }
+
+  static void store(const Snapshot& snap) {
+    Shared& cache = shared();
+    uint32_t seq = cache.seq.load(std::memory_order_relaxed);
+    if ((seq & 1) || !chronoLogCas(cache.seq, seq, seq + 1, std::memory_order_acquire)) return;
+    uint32_t words[sizeof(Snapshot) / 4];
+    memcpy(words, &snap, sizeof(words));
+    for (size_t i = 0; i < sizeof(Snapshot) / 4; i++) cache.words[i].store(words[i], std::memory_order_relaxed);
+    cache.seq.store(seq + 2, std::memory_order_release);
+  }
+#else
+  static Snapshot& shared() {                                                                           // Single-threaded targets without <atomic>
+    static Snapshot cache;
+    return cache;
+  }
+
+  static bool load(Snapshot& snap) {
+    snap = shared();
+    return snap.text[0] != '\0';
+  }
+
+  static void store(const Snapshot& snap) { shared() = snap; }
+#endif
+};
+
+/*
+ * Task column of the header, cached per task. The name is fetched from the RTOS and padded to the
+ * column width once, then reused from the task's own slot: thread_local on ESP32 and the host, TLS
+ * on Zephyr. On STM32 (FreeRTOS TLS pointer CHRONOLOG_TASK_TLS_INDEX) and with Zephyr thread custom
+ * data, the slot comes from a static pool of CHRONOLOG_TASK_SLOTS entries; a task gives it back with
+ * release() before it deletes itself, or through the TLS delete callback where FreeRTOS has one.
+ * Tasks that find the pool empty look their name up on every line. renamed() makes every task
+ * rebuild its copy on its next line.
+ */
+class ChronoLogTaskField {
+public:
+  enum : uint8_t { WIDTH = 16 };
+
+  struct Field {
+    uint32_t generation;
+    uint8_t  len;
+    uint8_t  taken;                                                                                     // Pool entries only: owned by a task
+    char     text[32];
+  };
+
+  static const char* name() {
+  #if defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(CHRONOLOG_STM32_FREERTOS)
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+      const char* name = pcTaskGetName(NULL);
+      return (name != nullptr) ? name : "MainTask";
+    }
+    return "MainTask";
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+    const char* name = k_thread_name_get(k_current_get());                                              // NULL without CONFIG_THREAD_NAME
+    return (name != nullptr && name[0] != '\0') ? name : "unnamed";
+  #elif defined(CHRONOLOG_PLATFORM_ESP_IDF) || (defined(CHRONOLOG_PLATFORM_ARDUINO) && defined(CHRONOLOG_ESP))
+    return pcTaskGetName(NULL);
+  #elif defined(CHRONOLOG_PLATFORM_POSIX)
+    static thread_local char     text[16];                                                              // Linux caps thread names at 15 characters
+    static thread_local uint32_t seen = 0;
+    uint32_t gen = generation();
+    if (seen != gen) {                                                                                  // One syscall per thread, again after renamed()
+      if (pthread_getname_np(pthread_self(), text, sizeof(text)) != 0 || text[0] == '\0') strcpy(text, "MainTask");
+      seen = gen;
+    }
+    return text;
+  #else
+    return "MainTask";
+  #endif
+  }
+
+  static void render(Field& field, const char* taskName) {
+    size_t n = strlen(taskName);
+    if (n > sizeof(field.text) - 1) n = sizeof(field.text) - 1;
+    memcpy(field.text, taskName, n);
+    while (n < WIDTH) field.text[n++] = ' ';
+    field.text[n] = '\0';
+    field.len     = (uint8_t)n;
+  }
+
+  static const Field& current(Field& scratch) {                                                         // scratch is used by tasks without a slot
+    Field* field = slot();
+    uint32_t gen = generation();
+    if (field && field->generation == gen) return *field;
+    if (!field) field = &scratch;
+    render(*field, name());
+    field->generation = gen;
+    return *field;
+  }
+
+  static void release() {                                                                               // The calling task is about to be deleted
+  #if defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(CHRONOLOG_STM32_FREERTOS) && \
+      configNUM_THREAD_LOCAL_STORAGE_POINTERS > CHRONOLOG_TASK_TLS_INDEX
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) return;
+    Field* field = (Field*)pvTaskGetThreadLocalStoragePointer(NULL, CHRONOLOG_TASK_TLS_INDEX);
+    vTaskSetThreadLocalStoragePointer(NULL, CHRONOLOG_TASK_TLS_INDEX, nullptr);
+    giveBack(field);
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) && !defined(CONFIG_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_CUSTOM_DATA)
+    Field* field = (Field*)k_thread_custom_data_get();
+    k_thread_custom_data_set(nullptr);
+    giveBack(field);
+  #endif
+  }
+
+  static void renamed() {
+    #if defined(CHRONOLOG_HAS_ATOMIC)
+      counter().store(counter().load(std::memory_order_relaxed) + 1, std::memory_order_release);      // Plain store, no RMW needed on Cortex-M0
+    #else
+      counter() = counter() + 1;
+    #endif
+  }
+
+private:
+#if defined(CHRONOLOG_HAS_ATOMIC)
+  static std::atomic<uint32_t>& counter() {
+    static std::atomic<uint32_t> gen{1};
+    return gen;
+  }
+
+  static uint32_t generation() { return counter().load(std::memory_order_acquire); }
+#else
+  static volatile uint32_t& counter() {
+    static volatile uint32_t gen = 1;
+    return gen;
+  }
+
+  static uint32_t generation() { return counter(); }
+#endif
+
+  static Field* mainField() {                                                                           // Single-task targets and code before the scheduler
+    static Field field;
+    return &field;
+  }
+
+#if (defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(CHRONOLOG_STM32_FREERTOS)) || \
+    (defined(CHRONOLOG_PLATFORM_ZEPHYR) && !defined(CONFIG_THREAD_LOCAL_STORAGE) && defined(CONFIG_THREAD_CUSTOM_DATA))
+  static Field* take() {                                                                                // A free pool entry, nullptr once all are owned
+    static Field pool[CHRONOLOG_TASK_SLOTS];
+    ChronoLogCritical lock;
+    for (Field& field : pool) {
+      if (field.taken) continue;
+      field.taken      = 1;
+      field.generation = 0;
+      return &field;
+    }
+    return nullptr;
+  }
+
+  static void giveBack(void* field) {
+    if (field == nullptr) return;
+    ChronoLogCritical lock;
+    ((Field*)field)->taken = 0;
+  }
+
+  #if defined(configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS) && configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS
+  static void deleted(int, void* field) { giveBack(field); }                                            // vTaskDelete() returns the entry itself
+  #endif
+#endif
+
+  static Field* slot() {
+  #if defined(CHRONOLOG_PLATFORM_STM32_HAL) && defined(CHRONOLOG_STM32_FREERTOS)
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) return mainField();
+    #if configNUM_THREAD_LOCAL_STORAGE_POINTERS > CHRONOLOG_TASK_TLS_INDEX
+      Field* field = (Field*)pvTaskGetThreadLocalStoragePointer(NULL, CHRONOLOG_TASK_TLS_INDEX);
+      if (field == nullptr && (field = take()) != nullptr) {
+        #if defined(configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS) && configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS
+          vTaskSetThreadLocalStoragePointerAndDelCallback(NULL, CHRONOLOG_TASK_TLS_INDEX, field, deleted);
+        #else
+          vTaskSetThreadLocalStoragePointer(NULL, CHRONOLOG_TASK_TLS_INDEX, field);
+        #endif
+      }
+      return field;
+    #else
+      return nullptr;
+    #endif
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) && defined(CONFIG_THREAD_LOCAL_STORAGE)
+    static thread_local Field field;
+    return &field;
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR) && defined(CONFIG_THREAD_CUSTOM_DATA)
+    Field* field = (Field*)k_thread_custom_data_get();
+    if (field == nullptr && (field = take()) != nullptr) k_thread_custom_data_set(field);
+    return field;
+  #elif defined(CHRONOLOG_PLATFORM_ZEPHYR)
+    return nullptr;
+  #elif defined(CHRONOLOG_FREERTOS) || defined(CHRONOLOG_PLATFORM_POSIX)
+    static thread_local Field field;
+    return &field;
+  #else
+    return mainField();
+  #endif
+  }
+};
+
+template <size_t... I> struct ChronoLogIndices {};
+template <size_t N, size_t... I> struct ChronoLogMakeIndices : ChronoLogMakeIndices<N - 1, N - 1, I...> {};
+template <size_t... I> struct ChronoLogMakeIndices<0, I...> { typedef ChronoLogIndices<I...> type; };
+
+/*
+ * Module column of the header, " | name            | ", padded or cut to 15 characters. The logger
+ * builds it in its constexpr constructor, so a global logger carries it in .rodata/.data and
+ * printing it is one memcpy.
+ */
+struct ChronoLogModuleColumn {
+  enum : size_t { WIDTH = 15, SIZE = WIDTH + 6 };
+  char text[SIZE];
+
+  constexpr explicit ChronoLogModuleColumn(const char* name)
+    : ChronoLogModuleColumn(name, __builtin_strlen(name), typename ChronoLogMakeIndices<SIZE>::type()) {}
+
+private:
+  // The length is taken once, so every read of name is bounded by it, which the optimizer can see
+  // for a logger built at run time as well.
+  template <size_t... I>
+  constexpr ChronoLogModuleColumn(const char* name, size_t len, ChronoLogIndices<I...>) : text{at(name, len, I)...} {}
+
+  static constexpr char at(const char* name, size_t len, size_t i) {
+    return (i < 3) ? " | "[i] : (i >= SIZE - 3) ? " | "[i - (SIZE - 3)] : (i - 3 < len) ? name[i - 3] : ' ';
+  }
+};
+
+// Coloured level column plus the separator before the task column, one entry per ChronoLogLevel.
+struct ChronoLogLevelTag {
+  const char* text;
+  size_t      len;
+
+  static const ChronoLogLevelTag& of(ChronoLogLevel level) {
+    #define CHRONOLOG_TAG(color, label) {color label CHRONOLOG_COLOR_RESET " | ", sizeof(color label CHRONOLOG_COLOR_RESET " | ") - 1}
+    static const ChronoLogLevelTag tags[] = {
+      CHRONOLOG_TAG(CHRONOLOG_COLOR_DEBUG, "DEBUG   "),                                                 // NONE, printed like DEBUG as before
+      CHRONOLOG_TAG(CHRONOLOG_COLOR_FATAL, "FATAL   "),
+      CHRONOLOG_TAG(CHRONOLOG_COLOR_ERROR, "ERROR   "),
+      CHRONOLOG_TAG(CHRONOLOG_COLOR_WARN,  "WARNING "),
+      CHRONOLOG_TAG(CHRONOLOG_COLOR_INFO,  "INFO    "),
+      CHRONOLOG_TAG(CHRONOLOG_COLOR_DEBUG, "DEBUG   "),
+    };
+    #undef CHRONOLOG_TAG
+    return tags[((unsigned)level <= (unsigned)CHRONOLOG_LEVEL_DEBUG) ? (unsigned)level : (unsigned)CHRONOLOG_LEVEL_DEBUG];
+  }
+};
+
+class ChronoLogModule;
+
+// Level byte read on every call: a relaxed atomic where <atomic> exists, a plain byte on AVR.
+struct ChronoLogLevelSlot {
+#if defined(CHRONOLOG_HAS_ATOMIC)
+  std::atomic<uint8_t> value;
+  CHRONOLOG_INLINE uint8_t load() const { return value.load(std::memory_order_relaxed); }
+  void store(uint8_t v)                 { value.store(v, std::memory_order_relaxed); }
+#else
+  volatile uint8_t value;
+  CHRONOLOG_INLINE uint8_t load() const { return value; }
+  void store(uint8_t v)                 { value = v; }
+#endif
+  constexpr explicit ChronoLogLevelSlot(uint8_t v) : value(v) {}
+};
+
+/*
+ * Every logger links itself here on first use (or setLevel()), so static initialization order does
+ * not matter. Rules such as "net.*=debug,*=warn" are matched against the module names when a logger
+ * registers and again whenever the rules change; the logging path only reads the resolved level.
+ * Matching runs outside ChronoLogCritical, which only links and unlinks loggers, swaps the rule
+ * table and stores a resolved level if no newer change came in meanwhile.
+ *
+ * "name" matches that module exactly, "net.*" matches "net" and everything below it, any other
+ * trailing '*' is a plain prefix match, and a bare level is the same as "*=level". The most specific
+ * pattern wins (exact, then the longest prefix); among equals, the later entry. Loggers no rule
+ * matches keep their constructor or setLevel() level.
+ */
+class ChronoLogRegistry {
+public:
+  // false, with the previous rules kept, if an entry is malformed or there are more than
+  // CHRONOLOG_MAX_RULES of them. "" or nullptr removes all rules.
+  static bool setRules(const char* spec);
+  static void clearRules() { setRules(nullptr); }
+
+  // Copies up to max registered loggers into out and returns how many are registered.
+  static size_t list(const ChronoLogModule** out, size_t max);
+  static const ChronoLogModule* find(const char* name);
+
+  static bool parseLevel(const char* text, size_t len, ChronoLogLevel& level);
+
+private:
+  friend class ChronoLogModule;
+  friend class ChronoLogSinks;
+
+  struct Rule {
+    char           pattern[CHRONOLOG_RULE_LEN];                                                         // Without the trailing '*'
+    uint8_t        len;
+    bool           wildcard;
+    ChronoLogLevel level;
+  };
+
+  struct Rules {
+    size_t count;
+    Rule   rule[CHRONOLOG_MAX_RULES];
+  };
+
+  struct State {
+    const ChronoLogModule* head;
+    const ChronoLogModule* cursor;                                                                      // Logger the newest walk() is at; detach() moves it on
+    uint32_t               version;                                                                     // Bumped by every walk(), so older ones give up
+    Rules                  rules;
+  };
+
+  struct Subject {                                                                                      // What resolve() needs of a logger, read while it is linked
+    const char* name;
+    uint8_t     base;
+    bool        sinksCeiling;
+  };
+
+  static State& state() {
+    static State s;
+    return s;
+  }
+
+  CHRONOLOG_COLD static uint8_t attach(const ChronoLogModule& logger);
+  static void    detach(const ChronoLogModule& logger);
+  static void    assign(ChronoLogModule& logger, ChronoLogLevel level);
+  static void    refresh();
+  static void    walk(const Rules* fresh);
+  static Subject subject(const ChronoLogModule& logger);
+  static uint8_t resolve(const Rules& rules, const Subject& logger);
+  static uint8_t cap(bool sinksCeiling, uint8_t level);
+};
+
+#if CHRONOLOG_SUPPRESS
+
+/*
+ * Token bucket of one CHRONOLOG_LIMIT() site, kept as the time the bucket is next due to be full
+ * (GCRA), so taking a token is one CAS on one word. Constant-initialised, no heap.
+ */
+class ChronoLogRate {
+public:
+  constexpr ChronoLogRate() : due(0), refused(0) {}
+
+  // true when the call may log; missed gets the calls refused since the previous one that could.
+  bool take(uint32_t perSecond, uint32_t burst, uint32_t& missed) {
+    missed = 0;
+    if (perSecond == 0) return true;                                                                    // Unlimited
+    uint32_t now   = chronoLogUptimeMs();
+    uint32_t step  = perSecond < 1000 ? 1000 / perSecond : 1;
+    uint32_t limit = step * (burst ? burst : 1);
+    uint32_t next  = due.load(std::memory_order_relaxed);
+    for (;;) {
+      int32_t ahead = (int32_t)(next - now);
+      if (ahead < 0 || (uint32_t)ahead > limit + 60000) ahead = 0;                                      // Idle, or stale after the ms counter wrapped
+      if ((uint32_t)ahead + step > limit) {
+        chronoLogFetchAdd(refused, 1);
+        return false;
+      }
+      if (chronoLogCas(due, next, now + (uint32_t)ahead + step)) break;
+    }
+    if (refused.load(std::memory_order_relaxed)) missed = chronoLogExchange(refused, 0);
+    return true;
+  }
+
+private:
+  std::atomic<uint32_t> due;
+  std::atomic<uint32_t> refused;
+};
+
+/*
+ * "last message repeated N times": a logger keeps the exact key of its previous call (level, format
+ * address and argument bytes, strings by content, so nothing is formatted to compare) and counts
+ * identical calls instead of writing them. A call whose key does not fit CHRONOLOG_REPEAT_KEY_LEN is
+ * always written. The count is written before the next different line, and every
+ * CHRONOLOG_REPEAT_FLUSH_MS while the repetition goes on.
+ */
+class ChronoLogRepeats {
+public:
+  struct Summary {
+    uint32_t       count;
+    ChronoLogLevel level;
+  };
+
+  struct Key {
+    uint8_t bytes[CHRONOLOG_REPEAT_KEY_LEN];
+    size_t  len  = 0;
+    bool    fits = true;
+
+    void add(const char* s) {                                                                           // Tagged, so nullptr differs from ""
+      uint8_t tag = s ? 1 : 0;
+      put(&tag, 1);
+      if (s) put(s, strlen(s) + 1);
+    }
+    void add(char* s) { add((const char*)s); }
+
+    template <typename T>
+    void add(const T& value) { put(&value, sizeof(T)); }
+
+    void put(const void* data, size_t n) {
+      if (!fits || n > sizeof(bytes) - len) {
+        fits = false;
+        return;
+      }
+      memcpy(bytes + len, data, n);
+      len += n;
+    }
+  };
+
+  constexpr ChronoLogRepeats() : on(true), busy(false), last{}, lastLen(0), level(0), count(0), since(0) {}
+
+  void enable(bool collapse) { on.store(collapse, std::memory_order_relaxed); }
+
+  // true: the call repeats the previous one and is not written. summary.count > 0: write it first.
+  bool collapse(ChronoLogLevel callLevel, const Key& key, Summary& summary) {
+    summary.count = 0;
+    if (!on.load(std::memory_order_relaxed)) return false;
+    if (chronoLogExchange(busy, true, std::memory_order_acquire)) return false;                         // Another context is comparing: write this call
+    bool repeat = key.fits && key.len == lastLen && memcmp(key.bytes, last, key.len) == 0;
+    if (repeat) {
+      uint32_t now = chronoLogUptimeMs();
+      if (count++ == 0) since = now;
+      else if (now - since >= CHRONOLOG_REPEAT_FLUSH_MS) take(summary);
+    } else {
+      take(summary);
+      lastLen = key.fits ? key.len : 0;                                                                 // 0 matches no key: the next call is written too
+      memcpy(last, key.bytes, lastLen);
+      level = (uint8_t)callLevel;
+    }
+    busy.store(false, std::memory_order_release);
+    return repeat;
+  }
+
+private:
+  std::atomic<bool> on;
+  std::atomic<bool> busy;                                                                               // Guards the fields below
+  uint8_t           last[CHRONOLOG_REPEAT_KEY_LEN];
+  size_t            lastLen;
+  uint8_t           level;                                                                              // Of the call being repeated
+  uint32_t          count;
+  uint32_t          since;
+
+  void take(Summary& summary) {
+    if (!count) return;
+    summary.count = count;
+    summary.level = (ChronoLogLevel)level;
+    count         = 0;
+  }
+};
+
+#endif // CHRONOLOG_SUPPRESS
+
+/*
+ * Per call site state of the counting sampling macros, constant-initialised inside the macro. A
+ * skipped call costs relaxed atomics only: one increment for CHRONOLOG_EVERY_N(), one load for
+ * CHRONOLOG_FIRST_N(), a clock read and a load for CHRONOLOG_EVERY_MS().
+ */
+class ChronoLogSample {
+public:
+  constexpr ChronoLogSample() : word(0) {}
+
+  bool everyN(uint32_t n) { return add(word) % (n ? n : 1) == 0; }                                      // Calls 1, n + 1, 2n + 1, ...
+
+  bool firstN(uint32_t n) { return load(word) < n && add(word) < n; }                                   // Saturates, never wraps back
+
+  bool everyMs(uint32_t ms) {                                                                           // word: earliest time of the next line
+    uint32_t next = load(word);                                                                         // Before the clock, so now is never older than next
+    uint32_t now  = chronoLogUptimeMs();
+    uint32_t wait = next - now;
+    if (wait != 0 && wait <= ms) return false;                                                         // Further ahead than ms: never set, or stale
+    return swapIf(word, next, now + ms);
+  }
+
+private:
+#if defined(CHRONOLOG_HAS_ATOMIC)
+  std::atomic<uint32_t> word;
+
+  static uint32_t load(const std::atomic<uint32_t>& w)         { return w.load(std::memory_order_relaxed); }
+  static uint32_t add(std::atomic<uint32_t>& w)                { return chronoLogFetchAdd(w, 1); }
+  static bool swapIf(std::atomic<uint32_t>& w, uint32_t e, uint32_t v) {
+    return chronoLogCas(w, e, v);
+  }
+#else
+  volatile uint32_t word;                                                                               // Single core without <atomic> (AVR)
+
+  static uint32_t load(const volatile uint32_t& w)             { return w; }
+  static uint32_t add(volatile uint32_t& w)                    { uint32_t v = w; w = v + 1; return v; }
+  static bool swapIf(volatile uint32_t& w, uint32_t e, uint32_t v) {
+    if (w != e) return false;
+    w = v;
+    return true;
+  }
+#endif
+};
+
+/*
+ * Per call site state of CHRONOLOG_ON_CHANGE(): the bytes of the last value logged there (strings by
+ * content), compared exactly, so no two values can be mistaken for each other. A value longer than
+ * CHRONOLOG_CHANGE_VALUE_LEN is not kept and every call with one is written. Callers take turns on a
+ * per-site flag, so a change several tasks see at once is written once; one that cannot get the
+ * flag (in an interrupt, or while the holder is preempted) writes its line rather than miss a change.
+ */
+class ChronoLogChange {
+public:
+  constexpr ChronoLogChange() : busy(false), last{}, lastLen(EMPTY) {}
+
+  template <typename T>
+  bool changed(const T& value) { return update(VALUE, &value, sizeof(T)); }
+  bool changed(const char* s)  { return s ? update(TEXT, s, strlen(s)) : update(NO_TEXT, "", 0); }
+  bool changed(char* s)        { return changed((const char*)s); }
+
+private:
+  enum : uint8_t { VALUE, TEXT, NO_TEXT };                                                              // Kept in last[0], so nullptr differs from ""
+  enum : size_t  { EMPTY = ~(size_t)0 };                                                                // Nothing logged yet, or the last value did not fit
+
+  bool update(uint8_t kind, const void* data, size_t len) {
+    if (!take()) return true;
+    bool fits = len < sizeof(last);
+    bool same = fits && lastLen == len + 1 && last[0] == kind && memcmp(last + 1, data, len) == 0;
+    if (!same) {
+      lastLen = fits ? len + 1 : EMPTY;
+      last[0] = kind;
+      if (fits) memcpy(last + 1, data, len);
+    }
+    give();
+    return !same;
+  }
+
+#if defined(CHRONOLOG_HAS_ATOMIC)
+  std::atomic<bool> busy;                                                                               // Guards the fields below
+
+  bool take() {                                                                                         // The holder only compares and copies, so a short spin does
+    for (int spin = 0; chronoLogExchange(busy, true, std::memory_order_acquire); spin++) {
+      if (spin == 64 || chronoLogInIsr()) return false;
+    }
+    return true;
+  }
+  void give() { busy.store(false, std::memory_order_release); }
+#else
+  volatile bool busy;                                                                                   // Single core without <atomic> (AVR)
+
+  bool take() {
+    ChronoLogCritical critical;
+    if (busy) return false;
+    busy = true;
+    return true;
+  }
+  void give() { busy = false; }
+#endif
+
+  uint8_t last[CHRONOLOG_CHANGE_VALUE_LEN + 1];
+  size_t  lastLen;
+};
+
+/*
+ * Everything a logger has besides its output path: name, levels, registry link and the pre-built
+ * module column. The registry and the ISR/deferred records only see this part, so loggers built
+ * from different ChronoLoggerT policies share rules, lists and queues.
+ */
+class ChronoLogModule {
+public:
+  ChronoLogModule(const ChronoLogModule&) = delete;
+  ChronoLogModule& operator=(const ChronoLogModule&) = delete;
+
+  // Applies at once; the next ChronoLogRegistry::setRules() overrides it if a rule matches.
+  void setLevel(ChronoLogLevel level)               { ChronoLogRegistry::assign(*this, level); }
+
+  // One relaxed load on the hot path; a logger that has not registered yet does so here.
+  CHRONOLOG_INLINE bool enabled(ChronoLogLevel level) const {
+    uint8_t current = chronoLogLevel.load();
+    return current >= level && (current < RESOLVING || ChronoLogRegistry::attach(*this) >= level);
+  }
+
+  ChronoLogLevel currentLevel() const {
+    uint8_t current = chronoLogLevel.load();
+    return (ChronoLogLevel)(current < RESOLVING ? current : ChronoLogRegistry::attach(*this));
+  }
+
+  const char* moduleName() const                    { return name; }
+  uint32_t id() const                               { return moduleId; }                               // Same as CHRONOLOG_ID(moduleName)
+  static void taskRenamed()                         { ChronoLogTaskField::renamed(); }                 // Call after renaming a task
+  static void taskExiting()                         { ChronoLogTaskField::release(); }                 // Call before a task deletes itself
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+  void setUartHandler(UART_HandleTypeDef* handler)  { uartHandler = handler;  }
+#endif
+
+#if CHRONOLOG_SUPPRESS
+  // Budget of each CHRONOLOG_LIMIT() site of this logger; perSecond 0 lifts the limit.
+  void setRateLimit(uint16_t perSecond, uint16_t burst) {
+    rateLimit.store((uint32_t)perSecond << 16 | burst, std::memory_order_relaxed);
+  }
+
+  void collapseRepeats(bool collapse)               { repeats.enable(collapse); }                      // On by default
+#endif
+
+protected:
+  friend class ChronoLogRegistry;
+
+  enum : uint8_t { RESOLVING = 0xFE, UNRESOLVED = 0xFF };                                               // Above every level, so enabled() falls through to attach()
+
+  constexpr ChronoLogModule(const char* moduleName, ChronoLogLevel level, bool fansOut)
+    : name(moduleName), moduleId(chronoLogHash(moduleName)), baseLevel(level), chronoLogLevel(UNRESOLVED),
+      registryNext(nullptr), sinksCeiling(fansOut), column(moduleName) {}
+  ~ChronoLogModule()                                { ChronoLogRegistry::detach(*this); }
+
+  const char* name;
+  uint32_t moduleId;
+  ChronoLogLevelSlot baseLevel;                                                                         // Used when no rule matches
+  mutable ChronoLogLevelSlot chronoLogLevel;
+  mutable const ChronoLogModule* registryNext;
+  bool sinksCeiling;                                                                                    // Sink is ChronoLogSinks: capped at its ceiling()
+  ChronoLogModuleColumn column;
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+  UART_HandleTypeDef* uartHandler = nullptr;
+#endif
+#if CHRONOLOG_SUPPRESS
+  std::atomic<uint32_t> rateLimit{(uint32_t)CHRONOLOG_LIMIT_RATE << 16 | CHRONOLOG_LIMIT_BURST};      // perSecond << 16 | burst
+  mutable ChronoLogRepeats repeats;
+#endif
+};
+
+/*
+ * Policies of the platform logger. A policy is a class with static members only, so ChronoLoggerT
+ * calls it directly and the compiler inlines it; there is no virtual call and no pointer per
+ * logger. Any class with the same static members can replace one of them:
+ *
+ *   Clock      static void format(char* buf, size_t size)          time column, NUL-terminated
+ *   TaskInfo   static const char* name()                            current task or thread
+ *              static const ChronoLogTaskField::Field& current(ChronoLogTaskField::Field& scratch)
+ *   Sink       static void write(ChronoLogLevel level, ChronoLogTarget target, const char* data, size_t len)
+ *   Formatter  static int format(char* buf, size_t size, const char* fmt, va_list args)
+ *
+ * ChronoLogTaskField and ChronoLogSinks serve as the TaskInfo and Sink policies themselves.
+ */
+struct ChronoLogTimeColumn {
+  static void format(char* time_buf, size_t size) {
+    #if CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_DELTA || CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_TICKS
+      formatMicros(time_buf, size, ChronoLogClock::nowUs());
+    #else
+      ChronoLogTimeCache::format(time_buf, size, CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_HMS_MS);
+    #endif
+  }
+
+  static void formatMicros(char* time_buf, size_t size, uint64_t us) {                                  // "+     1234us" or "    12345678"
+    if (size == 0) return;
+    ChronoLogWriter::Out out = {time_buf, time_buf + size - 1};
+    #if CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_DELTA
+      ChronoLogWriter::Field field = {'u', ' ', false, 0, false, 9, -1};
+      out.put("+", 1);
+      ChronoLogWriter::writeInt(out, field, ChronoLogClock::sinceLastUs(us), false);
+      out.put("us", 2);
+    #else
+      ChronoLogWriter::Field field = {'u', ' ', false, 0, false, 12, -1};
+      ChronoLogWriter::writeInt(out, field, us, false);
+    #endif
+    *out.p = '\0';
+  }
+};
+
+struct ChronoLogPrintf {
+  static int format(char* buf, size_t size, const char* fmt, va_list args) { return chronoLogVsnprintf(buf, size, fmt, args); }
+};
+
+// Async, deferred and binary output end in the platform engines, so only loggers whose Sink is
+// ChronoLogSinks use them; other sinks get every line formatted and written synchronously.
+template <typename Sink> struct ChronoLogQueued                 { enum { value = false }; };
+template <>              struct ChronoLogQueued<ChronoLogSinks> { enum { value = true }; };
+
+template <typename Clock, typename TaskInfo, typename Sink, typename Formatter>
+class ChronoLoggerT : public ChronoLogModule {
+public:
+  constexpr ChronoLoggerT(const char* moduleName, ChronoLogLevel level = CHRONOLOG_LEVEL_DEBUG)
+    : ChronoLogModule(moduleName, level, ChronoLogQueued<Sink>::value) {}
+
+#if CHRONOLOG_SUPPRESS
+  template <typename... Args>
+  void logLimited(ChronoLogRate& site, ChronoLogLevel level, const char* fmt, Args... args) const {
+    uint32_t budget = rateLimit.load(std::memory_order_relaxed);
+    uint32_t missed;
+    if (!site.take(budget >> 16, budget & 0xFFFF, missed)) return;
+    if (missed) emitf(level, "rate limit: %lu messages suppressed", (unsigned long)missed);
+    emit(level, fmt, args...);
+  }
+#endif
+
+  // The level test is inlined at the call site; only enabled calls reach the variadic emit().
+  template <typename... Args> CHRONOLOG_INLINE void debug(const char* fmt, Args... args) const { if (enabled(CHRONOLOG_LEVEL_DEBUG)) emit(CHRONOLOG_LEVEL_DEBUG, fmt, args...); }
+  template <typename... Args> CHRONOLOG_INLINE void info(const char* fmt, Args... args)  const { if (enabled(CHRONOLOG_LEVEL_INFO))  emit(CHRONOLOG_LEVEL_INFO,  fmt, args...); }
+  template <typename... Args> CHRONOLOG_INLINE void warn(const char* fmt, Args... args)  const { if (enabled(CHRONOLOG_LEVEL_WARN))  emit(CHRONOLOG_LEVEL_WARN,  fmt, args...); }
+  template <typename... Args> CHRONOLOG_INLINE void error(const char* fmt, Args... args) const { if (enabled(CHRONOLOG_LEVEL_ERROR)) emit(CHRONOLOG_LEVEL_ERROR, fmt, args...); }
+  template <typename... Args> CHRONOLOG_INLINE void fatal(const char* fmt, Args... args) const { if (enabled(CHRONOLOG_LEVEL_FATAL)) emit(CHRONOLOG_LEVEL_FATAL, fmt, args...); }
+  template <typename... Args> CHRONOLOG_INLINE void log(ChronoLogLevel level, const char* fmt, Args... args) const { if (enabled(level)) emit(level, fmt, args...); }
+
+  // Lazy overloads: the callable runs only when the level is enabled and returns the message text,
+  // as a const char* or anything with c_str(). logger.debug([&] { return dump(buf); });
+  template <typename F> CHRONOLOG_INLINE auto debug(const F& make) const -> decltype(chronoLogText(make()), void()) { log(CHRONOLOG_LEVEL_DEBUG, make); }
+  template <typename F> CHRONOLOG_INLINE auto info(const F& make) const  -> decltype(chronoLogText(make()), void()) { log(CHRONOLOG_LEVEL_INFO,  make); }
+  template <typename F> CHRONOLOG_INLINE auto warn(const F& make) const  -> decltype(chronoLogText(make()), void()) { log(CHRONOLOG_LEVEL_WARN,  make); }
+  template <typename F> CHRONOLOG_INLINE auto error(const F& make) const -> decltype(chronoLogText(make()), void()) { log(CHRONOLOG_LEVEL_ERROR, make); }
+  template <typename F> CHRONOLOG_INLINE auto fatal(const F& make) const -> decltype(chronoLogText(make()), void()) { log(CHRONOLOG_LEVEL_FATAL, make); }
+  template <typename F>
+  CHRONOLOG_INLINE auto log(ChronoLogLevel level, const F& make) const -> decltype(chronoLogText(make()), void()) {
+    if (enabled(level)) emit(level, "%s", chronoLogText(make()));
+  }
+
+#if __cplusplus >= 201703L
+  // {}-style overloads, picked when the format is wrapped in CHRONOLOG_FMT().
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  CHRONOLOG_INLINE void debug(F fmt, const Args&... args) const { if (enabled(CHRONOLOG_LEVEL_DEBUG)) printFormat(CHRONOLOG_LEVEL_DEBUG, fmt, args...); }
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  CHRONOLOG_INLINE void info(F fmt, const Args&... args)  const { if (enabled(CHRONOLOG_LEVEL_INFO))  printFormat(CHRONOLOG_LEVEL_INFO,  fmt, args...); }
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  CHRONOLOG_INLINE void warn(F fmt, const Args&... args)  const { if (enabled(CHRONOLOG_LEVEL_WARN))  printFormat(CHRONOLOG_LEVEL_WARN,  fmt, args...); }
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  CHRONOLOG_INLINE void error(F fmt, const Args&... args) const { if (enabled(CHRONOLOG_LEVEL_ERROR)) printFormat(CHRONOLOG_LEVEL_ERROR, fmt, args...); }
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  CHRONOLOG_INLINE void fatal(F fmt, const Args&... args) const { if (enabled(CHRONOLOG_LEVEL_FATAL)) printFormat(CHRONOLOG_LEVEL_FATAL, fmt, args...); }
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  CHRONOLOG_INLINE void log(ChronoLogLevel level, F fmt, const Args&... args) const { if (enabled(level)) printFormat(level, fmt, args...); }
+#endif
+
+  // Same as log(). In binary mode every task-context call encodes its arguments from their C++
+  // types, so the format string is never read on the target.
+  template <typename... Args>
+  void logToken(ChronoLogLevel level, const char* fmt, Args... args) const { log(level, fmt, args...); }
+
+  // CHRONOLOG_LOG() in binary mode: text is the format literal, moved to the chronolog_fmt section.
+  template <typename... Args>
+  CHRONOLOG_INLINE void logSite(const char* text, ChronoLogLevel level, const char*, Args... args) const { log(level, text, args...); }
+
+#if CHRONOLOG_ISR
+  // Interrupt-safe variants: no allocation, no locks, no formatting. Only integer arguments are
+  // accepted; they are converted to whatever the matching conversion in fmt expects.
+  template <typename... Args> void debugFromISR(const char* fmt, Args... args) const { logFromISR(CHRONOLOG_LEVEL_DEBUG, fmt, args...); }
+  template <typename... Args> void infoFromISR(const char* fmt, Args... args)  const { logFromISR(CHRONOLOG_LEVEL_INFO,  fmt, args...); }
+  template <typename... Args> void warnFromISR(const char* fmt, Args... args)  const { logFromISR(CHRONOLOG_LEVEL_WARN,  fmt, args...); }
+  template <typename... Args> void errorFromISR(const char* fmt, Args... args) const { logFromISR(CHRONOLOG_LEVEL_ERROR, fmt, args...); }
+  template <typename... Args> void fatalFromISR(const char* fmt, Args... args) const { logFromISR(CHRONOLOG_LEVEL_FATAL, fmt, args...); }
+
+  template <typename... Args>
+  void logFromISR(ChronoLogLevel level, const char* fmt, Args... args) const {
+    static_assert(((std::is_integral<Args>::value || std::is_enum<Args>::value) && ...),
+                  "ISR log arguments must be integers");
+    uint8_t current = chronoLogLevel.load();                                                           // No registering from an ISR
+    if ((current >= RESOLVING ? baseLevel.load() : current) < level) return;
+    const long long values[] = {(long long)args..., 0};
+    ChronoLogIsr::WordSource src{values, sizeof...(Args), 0};
+    if (!ChronoLogIsr::queue.post(this, replay, level, "ISR", fmt, src)) {                              // Arguments too long to capture
+      ChronoLogIsr::queue.drop(level);
+    }
+  }
+#endif
+
+private:
+  enum : bool { queued = ChronoLogQueued<Sink>::value };
+
+  static const char* getCurrentTaskName() { return TaskInfo::name(); }
+
+#if CHRONOLOG_ISR || CHRONOLOG_DEFERRED
+  static void replay(const ChronoLogRecord& rec)    { static_cast<const ChronoLoggerT*>(rec.logger)->printRecord(rec); }
+#endif
+
+  ChronoLogTarget outputTarget() const {                                                                // This logger's UART, else the shared one
+  #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+    return uartHandler ? uartHandler : ChronoLogTransport::target();
+  #else
+    return nullptr;
+  #endif
+  }
+
+  size_t formatHeader(char* buf, size_t cap, const char* time_buf, ChronoLogLevel level,
+                      const ChronoLogTaskField::Field& task) const {
+    const ChronoLogLevelTag& tag = ChronoLogLevelTag::of(level);
+    ChronoLogWriter::Out out = {buf, buf + cap};
+    out.put(time_buf, strlen(time_buf));
+    out.put(column.text, sizeof(column.text));
+    out.put(tag.text, tag.len);
+    out.put(task.text, task.len);
+    out.put(" | ", 3);
+    return (size_t)(out.p - buf);
+  }
+
+#if CHRONOLOG_ASYNC
+  // Builds the line in a ring slot; render(buf, size) writes the message, as in writeLine().
+  template <typename Render>
+  void enqueue(ChronoLogLevel level, const Render& render) const {
+    ChronoLogTarget target = outputTarget();
+    #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+      if (!target) return;
+    #endif
+
+    ChronoLogAsync::instance().submit(level, [&](ChronoLogLine& line) {
+      #if CHRONOLOG_ASYNC_CORES > 1
+        line.stamp = ChronoLogClock::nowUs();
+      #endif
+      const size_t eol = sizeof(CHRONOLOG_EOL) - 1;
+      const size_t cap = sizeof(line.text) - eol;                                                       // Keep room for the newline
+      char time_buf[24];
+      Clock::format(time_buf, sizeof(time_buf));
+
+      ChronoLogTaskField::Field scratch;
+      size_t len = formatHeader(line.text, cap, time_buf, level, TaskInfo::current(scratch));
+
+      int n = render(line.text + len, cap + 1 - len);
+      if (n > 0) len += ((size_t)n < cap - len) ? (size_t)n : cap - len;
+
+      memcpy(line.text + len, CHRONOLOG_EOL, eol);
+      line.len    = (uint16_t)(len + eol);
+      line.target = target;
+    });
+  }
+#endif
+
+#if CHRONOLOG_ISR || CHRONOLOG_DEFERRED || CHRONOLOG_BINARY
+  static uint32_t secondsOfDayAt(uint32_t stampMs, uint32_t* millis = nullptr) {
+    #if defined(CHRONOLOG_WALL_CLOCK)
+      struct timeval tv;
+      gettimeofday(&tv, NULL);
+      uint32_t age   = chronoLogUptimeMs() - stampMs;                                                 // Map the uptime stamp onto wall-clock time
+      int64_t wallMs = (int64_t)tv.tv_sec * 1000 + tv.tv_usec / 1000 - age;
+      time_t sec     = (time_t)(wallMs / 1000);
+      if (millis) *millis = (uint32_t)(wallMs % 1000);
+      struct tm timeinfo;
+      localtime_r(&sec, &timeinfo);
+      return (uint32_t)(timeinfo.tm_hour * 3600 + timeinfo.tm_min * 60 + timeinfo.tm_sec);
+    #else
+      if (millis) *millis = stampMs % 1000;
+      return (stampMs / 1000) % 86400;
+    #endif
+  }
+#endif
+
+#if CHRONOLOG_ISR || CHRONOLOG_DEFERRED
+  static void formatTimeAt(char* time_buf, size_t size, uint32_t stampMs) {
+    #if CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_DELTA || CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_TICKS
+      uint32_t age = chronoLogUptimeMs() - stampMs;                                                   // Records only carry a millisecond stamp
+      ChronoLogTimeColumn::formatMicros(time_buf, size, ChronoLogClock::nowUs() - (uint64_t)age * 1000);
+    #else
+      uint32_t ms;
+      uint32_t sec = secondsOfDayAt(stampMs, &ms);
+      int n = snprintf(time_buf, size, "%02u:%02u:%02u", (unsigned)(sec / 3600), (unsigned)((sec / 60) % 60), (unsigned)(sec % 60));
+      if (CHRONOLOG_TIME_FORMAT == CHRONOLOG_TIME_HMS_MS && n > 0 && (size_t)n < size) {
+        snprintf(time_buf + n, size - n, ".%03u", (unsigned)ms);
+      }
+    #endif
+  }
+
+  void printRecord(const ChronoLogRecord& rec) const {
+    ChronoLogTarget target = outputTarget();
+    #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+      if (!target) return;
+    #endif
+
+    #if CHRONOLOG_BINARY
+      if (queued) {
+        uint8_t buf[CHRONOLOG_BUFFER_LEN];
+        ChronoLogBinary::Frame frame{buf, sizeof(buf)};
+        ChronoLogRecordSource src{rec.args};
+        ChronoLogBinary::encode(frame, (ChronoLogLevel)rec.level, secondsOfDayAt(rec.timestamp), name,
+                                ChronoLogBinary::inlineRef(rec.taskName), rec.fmt,
+                                [&](ChronoLogBinary::Frame& f) { ChronoLogBinary::encodeArgs(f, rec.fmt, src); });
+        emitFrame(target, (ChronoLogLevel)rec.level, frame);
+        return;
+      }
+    #endif
+
+    char time_buf[24];
+    formatTimeAt(time_buf, sizeof(time_buf), rec.timestamp);
+
+    char line_buf[CHRONOLOG_HEADER_LEN + CHRONOLOG_BUFFER_LEN];
+    const size_t eol = sizeof(CHRONOLOG_EOL) - 1;
+    const size_t cap = sizeof(line_buf) - eol;
+    ChronoLogTaskField::Field task;
+    ChronoLogTaskField::render(task, rec.taskName);
+    size_t len = formatHeader(line_buf, cap, time_buf, (ChronoLogLevel)rec.level, task);
+    ChronoLogRecordSource src{rec.args};
+    len += ChronoLogFmt::render(rec.fmt, src, line_buf + len, cap - len);
+    memcpy(line_buf + len, CHRONOLOG_EOL, eol);
+    len += eol;
+
+    #if CHRONOLOG_ASYNC
+      if (queued) {
+        ChronoLogAsync::instance().output((ChronoLogLevel)rec.level, target, line_buf, len);
+        return;
+      }
+    #endif
+    Sink::write((ChronoLogLevel)rec.level, target, line_buf, len);
+  }
+
+#endif
+
+#if CHRONOLOG_BINARY
+  template <typename... Args>
+  void printToken(ChronoLogLevel level, const char* fmt, Args... args) const {
+  #if CHRONOLOG_ISR
+    replayIsrRecords();
+  #endif
+    ChronoLogTarget target = outputTarget();
+    #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+      if (!target) return;
+    #endif
+    uint8_t buf[CHRONOLOG_BUFFER_LEN];
+    ChronoLogBinary::Frame frame{buf, sizeof(buf)};
+    ChronoLogBinary::Ref task = ChronoLogBinary::resolve(getCurrentTaskName(), frame);
+    ChronoLogBinary::encode(frame, level, ChronoLogTimeCache::secondsOfDay(), name, task, fmt,
+                            [&](ChronoLogBinary::Frame& f) { int put[] = {0, (f.value(args), 0)...}; (void)put; });
+    emitFrame(target, level, frame);
+  }
+
+  void emitFrame(ChronoLogTarget target, ChronoLogLevel level, const ChronoLogBinary::Frame& frame) const {
+    if (frame.overflow) {
+      ChronoLogBinary::release(frame);
+      return;
+    }
+    #if CHRONOLOG_ASYNC
+      ChronoLogAsync& engine = ChronoLogAsync::instance();
+      if (engine.running() && frame.len <= CHRONOLOG_ASYNC_LINE_LEN) {
+        if (!engine.submit(level, [&](ChronoLogLine& line) {
+          #if CHRONOLOG_ASYNC_CORES > 1
+            line.stamp = ChronoLogClock::nowUs();
+          #endif
+          memcpy(line.text, frame.buf, frame.len);
+          line.len    = (uint16_t)frame.len;
+          line.target = target;
+        })) {
+          ChronoLogBinary::release(frame);                                                              // Dropped: its strings are defined again next time
+          return;
+        }
+      } else {
+        engine.output(level, target, (const char*)frame.buf, frame.len);
+      }
+    #else
+      Sink::write(level, target, (const char*)frame.buf, frame.len);
+    #endif
+    ChronoLogBinary::published(frame);
+  }
+
+  void printBinary(ChronoLogLevel level, const char* fmt, va_list args) const {
+    ChronoLogTarget target = outputTarget();
+    #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+      if (!target) return;
+    #endif
+
+    uint8_t buf[CHRONOLOG_BUFFER_LEN];
+    ChronoLogBinary::Frame frame{buf, sizeof(buf)};
+    ChronoLogVaSource src(args);
+    ChronoLogBinary::Ref task = ChronoLogBinary::resolve(getCurrentTaskName(), frame);
+    ChronoLogBinary::encode(frame, level, ChronoLogTimeCache::secondsOfDay(), name, task, fmt,
+                            [&](ChronoLogBinary::Frame& f) { ChronoLogBinary::encodeArgs(f, fmt, src); });
+    emitFrame(target, level, frame);
+  }
+#endif
+
+#if CHRONOLOG_ISR
+  void postFromIsr(ChronoLogLevel level, const char* fmt, va_list args) const {
+    ChronoLogVaSource src(args);
+    if (!ChronoLogIsr::queue.post(this, replay, level, "ISR", fmt, src)) {                              // Arguments too long to capture
+      ChronoLogIsr::queue.drop(level);
+    }
+  }
+#endif
+
+#if __cplusplus >= 201703L
+  // The message is written straight behind the header, in the line buffer or the ring slot. Only
+  // paths that take a printf format and arguments (interrupts, binary frames, deferred records)
+  // get it as one "%s" argument.
+  template <typename F, typename... Args>
+  void printFormat(ChronoLogLevel level, F fmt, const Args&... args) const {
+  #if CHRONOLOG_SUPPRESS
+    if (repeated(level, F::text(), args...)) return;
+  #endif
+    if (formatsElsewhere()) {
+      char msg_buf[CHRONOLOG_BUFFER_LEN];
+      ChronoLogFormat::format(fmt, msg_buf, sizeof(msg_buf), args...);
+      emitf(level, "%s", msg_buf);
+      return;
+    }
+  #if CHRONOLOG_ISR
+    replayIsrRecords();
+  #endif
+    auto render = [&](char* buf, size_t size) { return (int)ChronoLogFormat::format(fmt, buf, size, args...); };
+  #if CHRONOLOG_ASYNC
+    if (queued && ChronoLogAsync::instance().running()) {
+      enqueue(level, render);
+      return;
+    }
+  #endif
+    writeLine(level, render);
+  }
+
+  bool formatsElsewhere() const {
+  #if CHRONOLOG_ISR
+    if (ChronoLogIsr::inIsr()) return true;
+  #endif
+  #if CHRONOLOG_BINARY
+    if (queued) return true;
+  #endif
+  #if CHRONOLOG_ASYNC && CHRONOLOG_DEFERRED
+    if (queued && ChronoLogAsync::instance().running()) return true;
+  #endif
+    return false;
+  }
+#endif
+
+#if CHRONOLOG_SUPPRESS
+  // true when the call repeats the previous one; writes the pending repeat count first if needed.
+  template <typename... Args>
+  bool repeated(ChronoLogLevel level, const char* fmt, const Args&... args) const {
+    ChronoLogRepeats::Key key;
+    key.add((uint8_t)level);
+    key.add((const void*)fmt);                                                                          // By address: the text may not be loaded
+    int add[] = {0, (key.add(args), 0)...};
+    (void)add;
+    ChronoLogRepeats::Summary summary{};
+    bool repeat = repeats.collapse(level, key, summary);
+    if (summary.count) emitf(summary.level, "last message repeated %lu times", (unsigned long)summary.count);
+    return repeat;
+  }
+#endif
+
+  template <typename... Args>
+  void emit(ChronoLogLevel level, const char* fmt, Args... args) const {
+  #if CHRONOLOG_SUPPRESS
+    if (repeated(level, fmt, args...)) return;
+  #endif
+  #if CHRONOLOG_BINARY
+    if (queued && !chronoLogInIsr()) {
+      printToken(level, fmt, args...);
+      return;
+    }
+  #endif
+    emitf(level, fmt, args...);
+  }
+
+  void emitf(ChronoLogLevel level, const char* fmt, ...) const {
+    va_list args;
+    va_start(args, fmt);
+    print(level, fmt, args);
+    va_end(args);
+  }
+
+#if CHRONOLOG_ISR
+  static void replayIsrRecords() {                                                                      // Records posted from interrupts since the last call
+    if (ChronoLogIsr::queue.ring.empty()) return;
+    #if CHRONOLOG_ASYNC
+      if (ChronoLogAsync::instance().running()) ChronoLogAsync::instance().wake();                   // The drain task replays them, in order with its lines
+      else                                      chronoLogDrainRecords();
+    #else
+      chronoLogDrainRecords();
+    #endif
+  }
+#endif
+
+  void print(ChronoLogLevel level, const char* fmt, va_list args) const {
+  #if CHRONOLOG_ISR
+    if (ChronoLogIsr::inIsr()) {
+      postFromIsr(level, fmt, args);
+      return;
+    }
+    replayIsrRecords();
+  #endif
+  #if CHRONOLOG_BINARY
+    if (queued) {
+      printBinary(level, fmt, args);
+      return;
+    }
+  #endif
+    auto render = [&](char* buf, size_t size) {                                                         // Works on a copy, so it can run twice
+      va_list args_copy;
+      va_copy(args_copy, args);
+      int n = Formatter::format(buf, size, fmt, args_copy);
+      va_end(args_copy);
+      return n;
+    };
+  #if CHRONOLOG_ASYNC
+    if (queued && ChronoLogAsync::instance().running()) {
+    #if CHRONOLOG_DEFERRED
+      ChronoLogVaSource src(args);
+      if (ChronoLogDeferred::queue.post(this, replay, level, getCurrentTaskName(), fmt, src)) {
+        ChronoLogAsync::instance().wake();
+        return;
+      }
+    #endif
+      enqueue(level, render);
+      return;
+    }
+  #endif
+    writeLine(level, render);
+  }
+
+  // Header, message and newline in one Sink write. render(buf, size) writes the message and returns
+  // the length it needs, as vsnprintf does; a longer message is rendered again into a heap buffer.
+  template <typename Render>
+  void writeLine(ChronoLogLevel level, const Render& render) const {
+    ChronoLogTarget target = outputTarget();
+    #if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+      if (!target) return;
+    #endif
+
+    char time_buf[24];
+    Clock::format(time_buf, sizeof(time_buf));
+
+    char line_buf[CHRONOLOG_HEADER_LEN + CHRONOLOG_BUFFER_LEN];                                        // Header, message and newline go out in one write
+    const size_t eol = sizeof(CHRONOLOG_EOL) - 1;
+    const size_t cap = sizeof(line_buf) - eol;
+    ChronoLogTaskField::Field scratch;
+    size_t len = formatHeader(line_buf, cap, time_buf, level, TaskInfo::current(scratch));
+
+    int n = render(line_buf + len, cap + 1 - len);
+    if (n < 0) n = 0;
+
+    if ((size_t)n <= cap - len) {
+      memcpy(line_buf + len + n, CHRONOLOG_EOL, eol);
+      Sink::write(level, target, line_buf, len + n + eol);
+      return;
+    }
+
+    char* dynamic_buf = (char*)malloc(len + n + eol + 1);
+    if (dynamic_buf) {
+      memcpy(dynamic_buf, line_buf, len);
+      render(dynamic_buf + len, n + 1);
+      memcpy(dynamic_buf + len + n, CHRONOLOG_EOL, eol);
+      Sink::write(level, target, dynamic_buf, len + n + eol);
+      free(dynamic_buf);
+    } else {
+      const char* err_msg = "[Log too long: memory error]";
+      size_t      err_len = strlen(err_msg);
+      if (err_len > cap - len) err_len = cap - len;
+      memcpy(line_buf + len, err_msg, err_len);
+      memcpy(line_buf + len + err_len, CHRONOLOG_EOL, eol);
+      Sink::write(level, target, line_buf, len + err_len + eol);
+    }
+  }
+};
+
+typedef ChronoLoggerT<ChronoLogTimeColumn, ChronoLogTaskField, ChronoLogSinks, ChronoLogPrintf> ChronoLogger;
+
+#if defined(CHRONOLOG_PLATFORM_POSIX)
+/*
+ * Host policies, for unit tests and benchmarks of the logger itself on Linux or macOS: microseconds
+ * since the first line from std::chrono::steady_clock, the pthread name, and one write(2) per line
+ * to a file descriptor. Registry rules apply to these loggers as to any other.
+ */
+struct ChronoLogSteadyClock {
+  static void format(char* time_buf, size_t size) {                                                     // "    12345678"
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (size == 0) return;
+    uint64_t us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    ChronoLogWriter::Out out = {time_buf, time_buf + size - 1};
+    ChronoLogWriter::Field field = {'u', ' ', false, 0, false, 12, -1};
+    ChronoLogWriter::writeInt(out, field, us, false);
+    *out.p = '\0';
+  }
+};
+
+typedef ChronoLogTaskField ChronoLogThreadName;                                                         // pthread names, cached per thread
+
+template <int Fd>
+struct ChronoLogFdSink {
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) {
+    while (len > 0) {
+      ssize_t n = ::write(Fd, data, len);
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) return;
+      data += n;
+      len  -= (size_t)n;
+    }
+  }
+};
+
+typedef ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, ChronoLogFdSink<1>, ChronoLogPrintf> ChronoLogHostLogger;
+
+/*
+ * File output for long host runs. Lines are copied into one of CHRONOLOG_FILE_BUFFERS page-aligned
+ * buffers of CHRONOLOG_FILE_BUFFER_LEN bytes, and a buffer goes to the kernel as one write when it
+ * is full or CHRONOLOG_FILE_FLUSH_MS old. The sink's thread queues it to io_uring on Linux, so
+ * several writes are in the kernel at once, and reads completions from the shared ring. Where
+ * io_uring is missing or refused (old kernel, seccomp) the thread calls pwrite() instead. A line
+ * that finds every buffer in flight is refused, which ChronoLogSinks counts as a drop, so a slow
+ * disk never stalls a logging task. With maxBytes set, the file is rotated to path.1 .. path.keep.
+ * Buffers get their file and offset on the sink's thread, in the order they filled, and rotation
+ * runs there too, so renames, open() and io_uring_enter never hold the lock a logging task takes.
+ *
+ *   static ChronoLogFileSink file;
+ *   file.open("sim.log", 64u << 20, 5);
+ *   ChronoLogSinks::add(file.sink());
+ */
+class ChronoLogFileSink {
+public:
+  struct Stats {
+    uint64_t bytes;                                                                                     // Written to the file
+    uint32_t writes;                                                                                    // Buffers handed to the kernel
+    uint32_t refused;                                                                                   // Lines that found every buffer busy
+    uint32_t errors;                                                                                    // Failed writes, their data is lost
+    uint32_t rotations;
+    bool     uring;
+  };
+
+  ChronoLogFileSink() : handle{writeEntry, flushEntry, this} {}
+  ~ChronoLogFileSink() { close(); }
+
+  ChronoLogFileSink(const ChronoLogFileSink&) = delete;
+  ChronoLogFileSink& operator=(const ChronoLogFileSink&) = delete;
+
+  // Appends to path. maxBytes 0 never rotates; keep 0 truncates instead of keeping old files.
+  bool open(const char* path, uint64_t maxBytes = 0, unsigned keep = 3) {
+    close();
+    size_t n = strlen(path);
+    if (n + 12 > sizeof(name)) return false;                                                            // Room for ".<keep>"
+    std::unique_lock<std::mutex> g(lock);
+    for (Buffer& b : buffers) {
+      void* mem = nullptr;
+      if (posix_memalign(&mem, 4096, CHRONOLOG_FILE_BUFFER_LEN) != 0) {
+        g.unlock();
+        close();                                                                                        // Frees the ones already allocated
+        return false;
+      }
+      b = Buffer{(char*)mem, 0, 0, 0, 0, -1, FREE};
+    }
+    memcpy(name, path, n + 1);
+    limit   = maxBytes;
+    history = keep;
+    fd      = ::open(name, O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+      g.unlock();
+      close();
+      return false;
+    }
+    offset = (uint64_t)lseek(fd, 0, SEEK_END);
+    counters = Stats{0, 0, 0, 0, 0, false};
+    #if defined(CHRONOLOG_HAS_URING) && CHRONOLOG_FILE_URING
+      counters.uring = ring.setup(CHRONOLOG_FILE_BUFFERS);
+    #endif
+    stopping = false;
+    inRing   = 0;
+    sequence = 0;
+    writer   = std::thread([this] { run(); });
+    return true;
+  }
+
+  void close() {                                                                                        // Writes what is buffered and waits for it
+    std::unique_lock<std::mutex> g(lock);
+    if (fd >= 0) {
+      if (current >= 0) submit(current);
+      done.wait(g, [this] { return idle(-1); });
+      stopping = true;
+      work.notify_all();
+      g.unlock();
+      writer.join();
+      g.lock();
+      ::close(fd);
+      fd = -1;
+    }
+    #if defined(CHRONOLOG_HAS_URING)
+      ring.teardown();
+    #endif
+    counters.uring = false;
+    for (Buffer& b : buffers) {
+      free(b.data);
+      b.data = nullptr;
+    }
+  }
+
+  void flush() {                                                                                        // Hands over the partial buffer and waits for every write
+    std::unique_lock<std::mutex> g(lock);
+    if (fd < 0) return;
+    if (current >= 0) submit(current);
+    done.wait(g, [this] { return idle(-1); });
+  }
+
+  bool write(const char* data, size_t len) {
+    std::unique_lock<std::mutex> g(lock);
+    if (fd < 0) return false;
+    if (len > CHRONOLOG_FILE_BUFFER_LEN) len = CHRONOLOG_FILE_BUFFER_LEN;
+    uint32_t now = chronoLogUptimeMs();
+    if (current >= 0 && (buffers[current].len + len > CHRONOLOG_FILE_BUFFER_LEN || now - filledAt >= CHRONOLOG_FILE_FLUSH_MS)) {
+      submit(current);
+    }
+    if (current < 0) {
+      for (int i = 0; i < CHRONOLOG_FILE_BUFFERS && current < 0; i++) {
+        if (buffers[i].state == FREE) current = i;
+      }
+      if (current < 0) {
+        counters.refused++;
+        return false;
+      }
+      buffers[current].state = FILLING;
+      filledAt = now;
+    }
+    Buffer& b = buffers[current];
+    memcpy(b.data + b.len, data, len);
+    b.len += len;
+    return true;
+  }
+
+  const ChronoLogSink& sink() const { return handle; }                                                  // For ChronoLogSinks::add()
+
+  Stats stats() const {
+    std::lock_guard<std::mutex> g(lock);
+    return counters;
+  }
+
+private:
+  enum State : uint8_t { FREE, FILLING, PENDING, BUSY };                                                // PENDING waits for the writer thread, BUSY is in the kernel
+
+  struct Buffer {
+    char*    data;
+    size_t   len;
+    size_t   done;
+    uint64_t seq;                                                                                       // Order of submit(), for placing
+    uint64_t offset;
+    int      fd;                                                                                        // -1 until the writer thread places it
+    State    state;
+  };
+
+#if defined(CHRONOLOG_HAS_URING)
+  struct Ring {                                                                                         // Raw io_uring: no liburing needed
+    int            fd = -1;
+    unsigned*      sqTail;
+    unsigned*      sqMask;
+    unsigned*      sqArray;
+    unsigned*      cqHead;
+    unsigned*      cqTail;
+    unsigned*      cqMask;
+    io_uring_sqe*  sqes;
+    io_uring_cqe*  cqes;
+    void*          sqMap;
+    void*          cqMap;
+    size_t         sqSize;
+    size_t         cqSize;
+    size_t         sqeSize;
+
+    bool setup(unsigned entries) {
+      io_uring_params p;
+      memset(&p, 0, sizeof(p));
+      fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+      if (fd < 0) return false;
+      sqSize  = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+      cqSize  = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+      sqeSize = p.sq_entries * sizeof(io_uring_sqe);
+      bool single = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (single) sqSize = cqSize = sqSize > cqSize ? sqSize : cqSize;
+      sqMap = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+      cqMap = single ? sqMap : mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+      sqes  = (io_uring_sqe*)mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+      if (sqMap == MAP_FAILED || cqMap == MAP_FAILED || sqes == MAP_FAILED) {
+        if (sqMap == MAP_FAILED) sqMap = nullptr;
+        if (cqMap == MAP_FAILED) cqMap = nullptr;
+        if (sqes == MAP_FAILED) sqes = nullptr;
+        teardown();
+        return false;
+      }
+      sqTail  = (unsigned*)((char*)sqMap + p.sq_off.tail);
+      sqMask  = (unsigned*)((char*)sqMap + p.sq_off.ring_mask);
+      sqArray = (unsigned*)((char*)sqMap + p.sq_off.array);
+      cqHead  = (unsigned*)((char*)cqMap + p.cq_off.head);
+      cqTail  = (unsigned*)((char*)cqMap + p.cq_off.tail);
+      cqMask  = (unsigned*)((char*)cqMap + p.cq_off.ring_mask);
+      cqes    = (io_uring_cqe*)((char*)cqMap + p.cq_off.cqes);
+      return true;
+    }
+
+    void teardown() {
+      if (fd < 0) return;
+      if (sqes) munmap(sqes, sqeSize);
+      if (cqMap && cqMap != sqMap) munmap(cqMap, cqSize);
+      if (sqMap) munmap(sqMap, sqSize);
+      ::close(fd);
+      fd = -1;
+    }
+
+    bool write(int file, const char* data, unsigned len, uint64_t at, uint64_t tag) {
+      unsigned tail = *sqTail;
+      unsigned slot = tail & *sqMask;
+      io_uring_sqe& sqe = sqes[slot];
+      memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode    = IORING_OP_WRITE;
+      sqe.flags     = IOSQE_ASYNC;                                                                      // Buffered writes would otherwise run inside the submit
+      sqe.fd        = file;
+      sqe.off       = at;
+      sqe.addr      = (uint64_t)(uintptr_t)data;
+      sqe.len       = len;
+      sqe.user_data = tag;
+      sqArray[slot] = slot;
+      __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+      long r;
+      while ((r = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0)) < 0 && errno == EINTR) {}
+      if (r != 1) __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);                                     // Not consumed: a later enter must not submit it
+      return r == 1;
+    }
+
+    template <typename F> void reap(F&& done) {                                                         // No syscall, the completions are in shared memory
+      unsigned head = *cqHead;
+      while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+        const io_uring_cqe& cqe = cqes[head & *cqMask];
+        uint64_t tag = cqe.user_data;
+        int res      = cqe.res;
+        __atomic_store_n(cqHead, ++head, __ATOMIC_RELEASE);
+        done(tag, res);
+      }
+    }
+
+    void wait() { syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0); }
+  };
+
+  Ring ring;
+#endif
+
+  ChronoLogSink            handle;
+  mutable std::mutex       lock;
+  std::condition_variable  work;                                                                        // Wakes the writer thread
+  std::condition_variable  done;                                                                        // A buffer came back
+  std::thread              writer;
+  Buffer                   buffers[CHRONOLOG_FILE_BUFFERS] = {};
+  Stats                    counters = {};
+  char                     name[256] = {};
+  uint64_t                 limit    = 0;
+  uint64_t                 offset   = 0;
+  unsigned                 history  = 0;
+  int                      fd       = -1;
+  int                      retired  = -1;                                                               // Previous file, closed once its writes finish
+  int                      current  = -1;                                                               // Buffer being filled
+  int                      inRing   = 0;                                                                // Writes submitted to io_uring
+  uint64_t                 sequence = 0;                                                                // Buffers submitted so far
+  uint32_t                 filledAt = 0;
+  bool                     stopping = false;
+
+  static bool writeEntry(void* self, const char* data, size_t len) { return static_cast<ChronoLogFileSink*>(self)->write(data, len); }
+  static void flushEntry(void* self)                               { static_cast<ChronoLogFileSink*>(self)->flush(); }
+
+  bool idle(int file) const {                                                                           // No write in flight for file, or for any file with -1
+    for (const Buffer& b : buffers) {
+      if ((b.state == PENDING || b.state == BUSY) && (file < 0 || b.fd == file)) return false;
+    }
+    return true;
+  }
+
+  void submit(int i) {                                                                                  // Called with the lock held; the writer thread places it
+    Buffer& b = buffers[i];
+    if (i == current) current = -1;
+    if (b.len == 0) {
+      b.state = FREE;
+      return;
+    }
+    b.seq   = ++sequence;
+    b.fd    = -1;
+    b.done  = 0;
+    b.state = PENDING;
+    counters.writes++;
+    work.notify_one();
+  }
+
+  int next() const {                                                                                    // A placed PENDING buffer, else the oldest unplaced one
+    int pick = -1;
+    for (int k = 0; k < CHRONOLOG_FILE_BUFFERS; k++) {
+      const Buffer& b = buffers[k];
+      if (b.state != PENDING) continue;
+      if (b.fd >= 0) return k;
+      if (pick < 0 || b.seq < buffers[pick].seq) pick = k;
+    }
+    return pick;
+  }
+
+  // Gives b its file and offset, rotating first if b would pass the limit. Without history the file
+  // is truncated in place, which waits until no write to it is in flight: false until then.
+  bool place(std::unique_lock<std::mutex>& g, Buffer& b) {
+    if (limit && offset > 0 && offset + b.len > limit && retired < 0) {                                 // An older file still being written: try on the next buffer
+      if (history == 0 && !idle(fd)) return false;
+      g.unlock();
+      int fresh = rotate();
+      g.lock();
+      if (fresh < 0) {
+        counters.errors++;                                                                              // Keep writing past the limit
+      } else {
+        if (idle(fd)) ::close(fd);
+        else          retired = fd;
+        fd     = fresh;
+        offset = 0;
+        counters.rotations++;
+      }
+    }
+    b.fd     = fd;
+    b.offset = offset;
+    offset  += b.len;
+    return true;
+  }
+
+  void finish(int i) {
+    Buffer& b = buffers[i];
+    b.state = FREE;
+    b.len   = 0;
+    if (b.fd == retired && idle(retired)) {
+      ::close(retired);
+      retired = -1;
+    }
+    done.notify_all();
+  }
+
+  void reap() {
+  #if defined(CHRONOLOG_HAS_URING)
+    ring.reap([this](uint64_t tag, int res) {
+      Buffer& b = buffers[tag];
+      inRing--;
+      if (res == -EINTR || res == -EAGAIN) res = 0;
+      if (res == -EINVAL && counters.bytes == 0) {                                                      // No IORING_OP_WRITE before Linux 5.6
+        counters.uring = false;
+        b.state = PENDING;
+        return;
+      }
+      if (res < 0) {
+        counters.errors++;
+        finish((int)tag);
+        return;
+      }
+      b.done += (size_t)res;
+      counters.bytes += (uint64_t)res;
+      if (b.done < b.len) b.state = PENDING;                                                            // Short write: queue the rest
+      else                finish((int)tag);
+    });
+    if (!counters.uring && inRing == 0) ring.teardown();
+  #endif
+  }
+
+  int rotate() const {                                                                                  // Renames and reopens without the lock; returns the new file
+    char from[sizeof(name) + 12];
+    char to[sizeof(name) + 12];
+    for (unsigned k = history; k > 1; k--) {
+      snprintf(from, sizeof(from), "%s.%u", name, k - 1);
+      snprintf(to, sizeof(to), "%s.%u", name, k);
+      rename(from, to);
+    }
+    if (history > 0) {
+      snprintf(to, sizeof(to), "%s.1", name);
+      rename(name, to);
+    }
+    return ::open(name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  }
+
+  void run() {                                                                                          // The only thread touching the ring, fd and offset
+    std::unique_lock<std::mutex> g(lock);
+    while (!stopping) {
+      int i = next();
+      if (i >= 0 && buffers[i].fd < 0 && !place(g, buffers[i])) i = -1;                                 // Waits for the writes to the file it truncates
+      if (i >= 0) {
+        Buffer& b = buffers[i];
+        b.state   = BUSY;
+      #if defined(CHRONOLOG_HAS_URING)
+        if (counters.uring) {
+          g.unlock();
+          bool queued = ring.write(b.fd, b.data + b.done, (unsigned)(b.len - b.done), b.offset + b.done, (uint64_t)i);
+          g.lock();
+          if (queued) {
+            inRing++;
+            continue;
+          }
+        }
+      #endif
+        bool ok       = true;
+        size_t before = b.done;
+        g.unlock();
+        while (b.done < b.len) {
+          ssize_t n = pwrite(b.fd, b.data + b.done, b.len - b.done, (off_t)(b.offset + b.done));
+          if (n < 0 && errno == EINTR) continue;
+          if (n <= 0) {
+            ok = false;
+            break;
+          }
+          b.done += (size_t)n;
+        }
+        g.lock();
+        counters.bytes += b.done - before;
+        if (!ok) counters.errors++;
+        finish(i);
+        continue;
+      }
+      if (current >= 0 && chronoLogUptimeMs() - filledAt >= CHRONOLOG_FILE_FLUSH_MS) {
+        submit(current);
+        continue;
+      }
+    #if defined(CHRONOLOG_HAS_URING)
+      if (inRing > 0) {                                                                                 // New buffers wait for the next completion
+        g.unlock();
+        ring.wait();
+        g.lock();
+        reap();
+        continue;
+      }
+    #endif
+      work.wait_for(g, std::chrono::milliseconds(CHRONOLOG_FILE_FLUSH_MS));
+    }
+  }
+};
+#endif
+
+inline ChronoLogRegistry::Subject ChronoLogRegistry::subject(const ChronoLogModule& logger) {
+  return Subject{logger.name, logger.baseLevel.load(), logger.sinksCeiling};
+}
+
+inline uint8_t ChronoLogRegistry::resolve(const Rules& rules, const Subject& logger) {
+  const char* name  = logger.name;
+  size_t      len   = strlen(name);
+  size_t      best  = 0;
+  uint8_t     level = logger.base;
+  for (size_t i = 0; i < rules.count; i++) {
+    const Rule& r = rules.rule[i];
+    size_t score  = 0;
+    if (!r.wildcard) {
+      if (len == r.len && memcmp(name, r.pattern, len) == 0) score = (size_t)-1;
+    } else if (len >= r.len && memcmp(name, r.pattern, r.len) == 0) {
+      score = r.len + 2u;
+    } else if (r.len && r.pattern[r.len - 1] == '.' && len == r.len - 1u && memcmp(name, r.pattern, len) == 0) {
+      score = r.len + 1u;                                                                               // "net.*" also covers "net"
+    }
+    if (score && score >= best) {
+      best  = score;
+      level = (uint8_t)r.level;
+    }
+  }
+  return cap(logger.sinksCeiling, level);
+}
+
+// Loggers writing through ChronoLogSinks stop at the most verbose level any output takes; loggers
+// with their own Sink policy take every level their rules give them.
+inline uint8_t ChronoLogRegistry::cap(bool sinksCeiling, uint8_t level) {
+  uint8_t ceiling = sinksCeiling ? ChronoLogSinks::ceiling() : (uint8_t)CHRONOLOG_LEVEL_DEBUG;
+  return level < ceiling ? level : ceiling;
+}
+
+// Links the logger once, then resolves it against a copy of the rules. A walk() that starts in the
+// meantime may already have stored a newer level; the copy is then taken again.
+inline uint8_t ChronoLogRegistry::attach(const ChronoLogModule& logger) {
+  State& s = state();
+  for (;;) {
+    Rules    rules;
+    Subject  who;
+    uint32_t version;
+    {
+      ChronoLogCritical guard;
+      uint8_t current = logger.chronoLogLevel.load();
+      if (current < ChronoLogModule::RESOLVING) return current;
+      if (current == ChronoLogModule::UNRESOLVED) {                                                     // Another task may be resolving it already
+        logger.registryNext = s.head;
+        s.head              = &logger;
+        logger.chronoLogLevel.store(ChronoLogModule::RESOLVING);
+      }
+      rules   = s.rules;
+      who     = subject(logger);
+      version = s.version;
+    }
+    uint8_t level = resolve(rules, who);
+    ChronoLogCritical guard;
+    if (s.version == version && logger.baseLevel.load() == who.base) {
+      logger.chronoLogLevel.store(level);
+      return level;
+    }
+  }
+}
+
+inline void ChronoLogRegistry::detach(const ChronoLogModule& logger) {
+  if (logger.chronoLogLevel.load() == ChronoLogModule::UNRESOLVED) return;                                 // Never registered
+  ChronoLogCritical guard;
+  State& s = state();
+  for (const ChronoLogModule** link = &s.head; *link; link = &(*link)->registryNext) {
+    if (*link == &logger) {
+      *link = logger.registryNext;
+      break;
+    }
+  }
+  if (s.cursor == &logger) s.cursor = logger.registryNext;                                              // walk() goes on from there
+}
+
+inline void ChronoLogRegistry::assign(ChronoLogModule& logger, ChronoLogLevel level) {
+  attach(logger);
+  ChronoLogCritical guard;
+  logger.baseLevel.store((uint8_t)level);
+  logger.chronoLogLevel.store(cap(logger.sinksCeiling, (uint8_t)level));
+}
+
+inline void ChronoLogRegistry::refresh() { walk(nullptr); }
+
+// Installs fresh rules (or keeps the current ones) and resolves every linked logger, one at a time.
+// The critical section only moves the cursor and stores the result; a newer walk() makes this one
+// stop, since it covers every logger itself.
+inline void ChronoLogRegistry::walk(const Rules* fresh) {
+  State& s = state();
+  Rules    rules;
+  Subject  who = Subject();
+  uint32_t version;
+  const ChronoLogModule* l;
+  {
+    ChronoLogCritical guard;
+    if (fresh) s.rules = *fresh;
+    rules   = s.rules;
+    version = ++s.version;
+    l = s.cursor = s.head;
+    if (l) who = subject(*l);
+  }
+  while (l) {
+    uint8_t level = resolve(rules, who);
+    ChronoLogCritical guard;
+    if (s.version != version) return;
+    if (s.cursor == l) {                                                                                // Still linked
+      if (l->baseLevel.load() == who.base) l->chronoLogLevel.store(level);
+      s.cursor = l->registryNext;
+    }
+    l = s.cursor;
+    if (l) who = subject(*l);
+  }
+}
+
+inline bool ChronoLogRegistry::parseLevel(const char* text, size_t len, ChronoLogLevel& level) {
+  static const struct { const char* name; ChronoLogLevel level; } names[] = {
+    {"none", CHRONOLOG_LEVEL_NONE},   {"off", CHRONOLOG_LEVEL_NONE},   {"fatal", CHRONOLOG_LEVEL_FATAL},
+    {"error", CHRONOLOG_LEVEL_ERROR}, {"warn", CHRONOLOG_LEVEL_WARN},  {"warning", CHRONOLOG_LEVEL_WARN},
+    {"info", CHRONOLOG_LEVEL_INFO},   {"debug", CHRONOLOG_LEVEL_DEBUG},
+  };
+  if (len == 1 && text[0] >= '0' && text[0] <= '0' + CHRONOLOG_LEVEL_DEBUG) {
+    level = (ChronoLogLevel)(text[0] - '0');
+    return true;
+  }
+  for (const auto& n : names) {
+    size_t i = 0;
+    while (i < len && n.name[i] && (text[i] | 0x20) == n.name[i]) i++;
+    if (i == len && !n.name[i]) {
+      level = n.level;
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool ChronoLogRegistry::setRules(const char* spec) {
+  Rules  parsed;
+  size_t count = 0;
+  for (const char* p = spec ? spec : ""; *p;) {
+    const char* end = p;
+    while (*end && *end != ',' && *end != ';') end++;
+    const char* eq = p;
+    while (eq < end && *eq != '=') eq++;
+    const char* pat    = p;
+    const char* patEnd = eq < end ? eq : p;                                                             // A bare level means "*"
+    const char* lvl    = eq < end ? eq + 1 : p;
+    const char* lvlEnd = end;
+    while (pat < patEnd && *pat == ' ') pat++;
+    while (patEnd > pat && patEnd[-1] == ' ') patEnd--;
+    while (lvl < lvlEnd && *lvl == ' ') lvl++;
+    while (lvlEnd > lvl && lvlEnd[-1] == ' ') lvlEnd--;
+    p = *end ? end + 1 : end;
+    if (eq == end && lvl == lvlEnd) continue;                                                           // Empty entry
+    if (count == CHRONOLOG_MAX_RULES) return false;
+    Rule& r = parsed.rule[count];
+    if (!parseLevel(lvl, (size_t)(lvlEnd - lvl), r.level)) return false;
+    r.wildcard = eq == end || (patEnd > pat && patEnd[-1] == '*');
+    if (eq < end && r.wildcard) patEnd--;
+    size_t len = (size_t)(patEnd - pat);
+    if ((len == 0 && !r.wildcard) || len >= sizeof(r.pattern) || memchr(pat, '*', len)) return false;
+    memcpy(r.pattern, pat, len);
+    r.pattern[len] = '\0';
+    r.len          = (uint8_t)len;
+    count++;
+  }
+  parsed.count = count;
+  walk(&parsed);
+  return true;
+}
+
+inline bool ChronoLogSinks::add(const ChronoLogSink& sink, ChronoLogLevel level) {
+  {
+    ChronoLogCritical guard;
+    Table& t   = table();
+    Slot* slot = find(&sink);
+    if (!slot) {
+      slot = find(nullptr);
+      if (!slot) return false;
+      slot->drops.store(0);
+      slot->sink.store(&sink);
+      t.used.store((uint8_t)(t.used.load() + 1));
+    }
+    slot->level.store((uint8_t)level);
+  }
+  changed();
+  return true;
+}
+
+inline void ChronoLogSinks::remove(const ChronoLogSink& sink) {
+  {
+    ChronoLogCritical guard;
+    Table& t   = table();
+    Slot* slot = find(&sink);
+    if (!slot) return;
+    slot->sink.store(nullptr);
+    t.used.store((uint8_t)(t.used.load() - 1));
+  }
+  changed();
+}
+
+inline void ChronoLogSinks::setTransportLevel(ChronoLogLevel level) {
+  table().transport.store((uint8_t)level);
+  changed();
+}
+
+inline void ChronoLogSinks::changed() {
+  {
+    ChronoLogCritical guard;
+    Table& t        = table();
+    uint8_t ceiling = t.transport.load();
+    for (size_t i = 0; i < CHRONOLOG_MAX_SINKS; i++) {
+      if (t.slots[i].sink.load() && t.slots[i].level.load() > ceiling) ceiling = t.slots[i].level.load();
+    }
+    t.ceiling.store(ceiling);
+  }
+  #if CHRONOLOG_BINARY
+    ChronoLogBinary::reset();                                                                           // A new or unmuted output has seen no definitions
+  #endif
+  ChronoLogRegistry::refresh();
+}
+
+// Binary mode: string ids are defined once for all outputs, so the DEF frames in front of a line go
+// to every output that is not muted, whatever its level. A sink that refuses them makes every
+// string be defined again.
+inline size_t ChronoLogSinks::fanOut(ChronoLogLevel level, const char* data, size_t len) {
+  #if CHRONOLOG_BINARY
+    size_t defs = ChronoLogBinary::definitions((const uint8_t*)data, len);
+  #else
+    const size_t defs = 0;
+  #endif
+  Table& t = table();
+  if (t.used.load()) {
+    for (size_t i = 0; i < CHRONOLOG_MAX_SINKS; i++) {
+      Slot& slot                = t.slots[i];
+      const ChronoLogSink* sink = slot.sink.load();
+      if (!sink) continue;
+      uint8_t wants = slot.level.load();
+      size_t  n     = level <= wants ? len : (wants != CHRONOLOG_LEVEL_NONE ? defs : 0);
+      if (n && !sink->write(sink->context, data, n)) {
+        if (n == len) slot.drops.store(slot.drops.load() + 1);                                          // Counts may race; they are diagnostics
+        #if CHRONOLOG_BINARY
+          if (defs) ChronoLogBinary::reset();
+        #endif
+      }
+    }
+  }
+  uint8_t transport = t.transport.load();
+  return level <= transport ? len : (transport != CHRONOLOG_LEVEL_NONE ? defs : 0);
+}
+
+inline size_t ChronoLogRegistry::list(const ChronoLogModule** out, size_t max) {
+  ChronoLogCritical guard;
+  size_t n = 0;
+  for (const ChronoLogModule* l = state().head; l; l = l->registryNext, n++) {
+    if (n < max) out[n] = l;
+  }
+  return n;
+}
+
+inline const ChronoLogModule* ChronoLogRegistry::find(const char* name) {
+  ChronoLogCritical guard;
+  for (const ChronoLogModule* l = state().head; l; l = l->registryNext) {
+    if (strcmp(l->name, name) == 0) return l;
+  }
+  return nullptr;
+}
+
+#if CHRONOLOG_ISR || CHRONOLOG_DEFERRED
+inline size_t chronoLogDrainRecords() {
+  size_t count = 0;
+  ChronoLogRecord rec;
+  auto take = [&rec](ChronoLogRecord& slot) {
+    memcpy(&rec, &slot, offsetof(ChronoLogRecord, args) + slot.size);
+  };
+  #if CHRONOLOG_ISR
+    while (ChronoLogIsr::queue.ring.pop(take)) {
+      rec.replay(rec);
+      count++;
+    }
+  #endif
+  #if CHRONOLOG_DEFERRED
+    while (ChronoLogDeferred::queue.ring.pop(take)) {
+      rec.replay(rec);
+      count++;
+    }
+  #endif
+  return count;
+}
+
+// The lost record shows up in ChronoLogAsync::droppedCount() and in the next drop marker.
+inline void chronoLogRecordDropped(ChronoLogLevel level) {
+  #if CHRONOLOG_ASYNC
+    ChronoLogAsync::instance().recordDropped(level);
+  #else
+    (void)level;
+  #endif
+}
+#endif
+
+#if CHRONOLOG_ASYNC
+// Text mode writes "*** 12 messages dropped ***". Binary mode sends the same text as a LOG frame with
+// inline module, task and format strings, so the decoder prints it without any table entry.
+inline void ChronoLogAsync::reportDrops(ChronoLogTarget target) {
+  uint32_t n = chronoLogExchange(unreported, 0);
+  if (n == 0) return;
+  #if CHRONOLOG_BINARY
+    uint8_t buf[64];
+    ChronoLogBinary::Frame frame{buf, sizeof(buf)};
+    size_t at = frame.begin(ChronoLogBinary::FRAME_LOG);
+    frame.put((uint8_t)CHRONOLOG_LEVEL_WARN);
+    frame.varint(ChronoLogTimeCache::secondsOfDay());
+    ChronoLogBinary::ref(frame, ChronoLogBinary::inlineRef("ChronoLog"));
+    ChronoLogBinary::ref(frame, ChronoLogBinary::inlineRef("ChronoLog"));
+    ChronoLogBinary::ref(frame, ChronoLogBinary::inlineRef("*** %u messages dropped ***"));
+    frame.zigzag(n);
+    frame.end(at);
+    output(CHRONOLOG_LEVEL_WARN, target, (const char*)buf, frame.len);
+  #else
+    char text[48];
+    ChronoLogWriter::Out out = {text, text + sizeof(text)};
+    ChronoLogWriter::Field field = {'u', ' ', false, 0, false, 0, -1};
+    out.put("*** ", 4);
+    ChronoLogWriter::writeInt(out, field, n, false);
+    out.put(" messages dropped ***" CHRONOLOG_EOL, 21 + sizeof(CHRONOLOG_EOL) - 1);
+    output(CHRONOLOG_LEVEL_WARN, target, text, (size_t)(out.p - text));
+  #endif
+}
+#endif
+
+#else  // CHRONOLOG_MODE
+
+#define CHRONOLOG_STR(s) (s)
+
+#if defined(CHRONOLOG_PLATFORM_STM32_HAL)
+typedef UART_HandleTypeDef* ChronoLogTarget;
+#else
+typedef void* ChronoLogTarget;
+#endif
+
+#if CHRONOLOG_CALLSITES
+class ChronoLogSite {
+public:
+  const uint32_t    id  = 0;
+  const char* const fmt = "";
+  uint32_t hits() const               { return 0; }
+  const ChronoLogSite* next() const   { return nullptr; }
+  static const ChronoLogSite* first() { return nullptr; }
+};
+#endif
+
+class ChronoLogModule;
+
+class ChronoLogRegistry {
+public:
+  static bool setRules(const char*) { return true; }
+  static void clearRules() {}
+  static size_t list(const ChronoLogModule**, size_t) { return 0; }
+  static const ChronoLogModule* find(const char*) { return nullptr; }
+  static bool parseLevel(const char*, size_t, ChronoLogLevel&) { return false; }
+};
+
+struct ChronoLogSink {
+  bool (*write)(void* context, const char* data, size_t len);
+  void (*flush)(void* context);
+  void* context;
+};
+
+class ChronoLogSinks {
+public:
+  static bool add(const ChronoLogSink&, ChronoLogLevel = CHRONOLOG_LEVEL_DEBUG) { return true; }
+  static void remove(const ChronoLogSink&) {}
+  static void setLevel(const ChronoLogSink&, ChronoLogLevel) {}
+  static void setTransportLevel(ChronoLogLevel) {}
+  static uint32_t dropped(const ChronoLogSink&) { return 0; }
+  static void flush() {}
+};
+
+class ChronoLogModule {
+public:
+  void setLevel(ChronoLogLevel) {}
+  bool enabled(ChronoLogLevel) const { return false; }
+  ChronoLogLevel currentLevel() const { return CHRONOLOG_LEVEL_NONE; }
+  const char* moduleName() const { return ""; }
+  uint32_t id() const { return 0; }
+  static void taskRenamed() {}
+  static void taskExiting() {}
+#if CHRONOLOG_SUPPRESS
+  void setRateLimit(uint16_t, uint16_t) {}
+  void collapseRepeats(bool) {}
+#endif
+};
+
+class ChronoLogTimeColumn;
+class ChronoLogTaskField;
+class ChronoLogPrintf;
+
+template <typename Clock, typename TaskInfo, typename Sink, typename Formatter>
+class ChronoLoggerT : public ChronoLogModule {
+public:
+  constexpr ChronoLoggerT(const char*, ChronoLogLevel = CHRONOLOG_LEVEL_NONE) {}
+  template <typename... Args> void debug(const char*, Args...) const {}
+  template <typename... Args> void info(const char*, Args...)  const {}
+  template <typename... Args> void warn(const char*, Args...)  const {}
+  template <typename... Args> void error(const char*, Args...) const {}
+  template <typename... Args> void fatal(const char*, Args...) const {}
+  template <typename F> auto debug(const F& make) const -> decltype(chronoLogText(make()), void()) {}
+  template <typename F> auto info(const F& make) const  -> decltype(chronoLogText(make()), void()) {}
+  template <typename F> auto warn(const F& make) const  -> decltype(chronoLogText(make()), void()) {}
+  template <typename F> auto error(const F& make) const -> decltype(chronoLogText(make()), void()) {}
+  template <typename F> auto fatal(const F& make) const -> decltype(chronoLogText(make()), void()) {}
+  template <typename F> auto log(ChronoLogLevel, const F& make) const -> decltype(chronoLogText(make()), void()) {}
+  template <typename... Args> void log(ChronoLogLevel, const char*, Args...) const {}
+#if __cplusplus >= 201703L
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>> void debug(F, const Args&...) const {}
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>> void info(F, const Args&...)  const {}
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>> void warn(F, const Args&...)  const {}
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>> void error(F, const Args&...) const {}
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>> void fatal(F, const Args&...) const {}
+  template <typename F, typename... Args, typename = ChronoLogIfFmt<F>>
+  void log(ChronoLogLevel, F, const Args&...) const {}
+#endif
+  template <typename... Args> void logToken(ChronoLogLevel, const char*, Args...) const {}
+  template <typename... Args> void debugFromISR(const char*, Args...) const {}
+  template <typename... Args> void infoFromISR(const char*, Args...)  const {}
+  template <typename... Args> void warnFromISR(const char*, Args...)  const {}
+  template <typename... Args> void errorFromISR(const char*, Args...) const {}
+  template <typename... Args> void fatalFromISR(const char*, Args...) const {}
+};
+
+typedef ChronoLoggerT<ChronoLogTimeColumn, ChronoLogTaskField, ChronoLogSinks, ChronoLogPrintf> ChronoLogger;
+
+#if defined(CHRONOLOG_PLATFORM_POSIX)
+class ChronoLogSteadyClock;
+typedef ChronoLogTaskField ChronoLogThreadName;
+template <int Fd> class ChronoLogFdSink;
+
+typedef ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, ChronoLogFdSink<1>, ChronoLogPrintf> ChronoLogHostLogger;
+
+class ChronoLogFileSink {
+public:
+  struct Stats { uint64_t bytes; uint32_t writes, refused, errors, rotations; bool uring; };
+  bool open(const char*, uint64_t = 0, unsigned = 3) { return true; }
+  void close() {}
+  void flush() {}
+  bool write(const char*, size_t) { return true; }
+  const ChronoLogSink& sink() const { return handle; }
+  Stats stats() const { return Stats{0, 0, 0, 0, 0, false}; }
+private:
+  ChronoLogSink handle = {nullptr, nullptr, nullptr};
+};
+#endif
 
 #endif // CHRONOLOG_MODE
 
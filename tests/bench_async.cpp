@@ -0,0 +1,142 @@
+// Async engine cost: what a log call costs the caller when the drain task does the writing, and how
+// many lines per second the rings take from 1..N producers, each pinned to its own CPU so it lands in
+// its own per-core ring. Built three times: bench_async formats in the caller, bench_deferred
+// (CHRONOLOG_DEFERRED) only captures the arguments there, and bench_async_one_ring
+// (CHRONOLOG_ASYNC_CORES=1) puts every producer on one shared ring for comparison.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <atomic>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <thread>
+
+#if CHRONOLOG_DEFERRED
+  #define MODE "deferred"
+#else
+  #define MODE "eager"
+#endif
+
+#define STR_(x) #x
+#define STR(x)  STR_(x)
+#define RINGS   STR(CHRONOLOG_ASYNC_CORES) " ring(s)"
+
+static ChronoLogger          logger("bench");
+static std::atomic<uint64_t> written{0};
+
+static void hook(const char*, size_t) { written.fetch_add(1, std::memory_order_relaxed); }
+
+static uint64_t accounted() {                                                                           // Lines written or dropped so far, deferred ones included
+  return written.load(std::memory_order_relaxed) + ChronoLogAsync::instance().droppedCount();
+}
+
+static void waitFor(uint64_t lines) {
+  while (accounted() < lines) std::this_thread::yield();
+}
+
+// Bursts short enough to fit the queue, so every call measured is a successful enqueue.
+static void callerCost() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  engine.setPolicy(CHRONOLOG_POLICY_DROP_NEWEST);
+  const long rounds = 2000 * benchScale();
+  const int  burst  = 16;
+  BenchSamples samples;
+  uint64_t total = 0, sent = accounted();
+  for (long r = 0; r < rounds; r++) {
+    for (int i = 0; i < burst; i++) {
+      uint64_t start = benchNowNs();
+      logger.info("sensor %d temp %.2f state %s", i, 21.5 + i, "ok");
+      uint64_t ns = benchNowNs() - start;
+      samples.add(ns);
+      total += ns;
+    }
+    sent += burst;
+    waitFor(sent);
+  }
+  benchReport("caller ns/line, " MODE, (double)total / (double)(rounds * burst), "ns");
+  benchReport("caller p99, " MODE, samples.percentile(99), "ns");
+}
+
+#if CHRONOLOG_DEFERRED
+static void format(char* out, size_t cap, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(out, cap, fmt, args);
+  va_end(args);
+}
+
+static void capture(uint8_t* out, size_t cap, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  ChronoLogVaSource src(args);
+  uint16_t used = 0;
+  ChronoLogFmt::capture(fmt, src, out, cap, used);
+  va_end(args);
+}
+
+// The step deferral replaces: vsnprintf in the caller against copying the raw argument words.
+static void captureVsFormat() {
+  const long n = 200000 * benchScale();
+  char     text[CHRONOLOG_BUFFER_LEN];
+  uint8_t  words[CHRONOLOG_RECORD_ARG_BYTES];
+  double f = benchNsPerOp(n, [&](long i) { format(text, sizeof(text), "sensor %d temp %.2f state %s", (int)i, 21.5, "ok"); benchKeep(text); });
+  double c = benchNsPerOp(n, [&](long i) { capture(words, sizeof(words), "sensor %d temp %.2f state %s", (int)i, 21.5, "ok"); benchKeep(words); });
+  benchReport("vsnprintf ns/call", f, "ns");
+  benchReport("argument capture ns/call", c, "ns");
+}
+#endif
+
+static void pin(unsigned cpu) {                                                                         // No-op on a single CPU
+  unsigned cpus = std::thread::hardware_concurrency();
+  if (cpus < 2) return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu % cpus, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// Producers log flat out under the block policy; lines/s counts only what reached the write hook.
+// Producer t runs on CPU t + 1, leaving CPU 0 to the drain thread where there are enough of them.
+static void throughput() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  engine.setPolicy(CHRONOLOG_POLICY_BLOCK);
+  const int perThread = 20000 * (int)benchScale();
+  unsigned cpus = std::thread::hardware_concurrency();
+  unsigned most = cpus > 2 ? cpus - 1 : 2;                                                              // At least two, so sharing is measured
+  for (unsigned threads = 1; threads <= most && threads <= 16; threads *= 2) {
+    uint64_t target = accounted() + (uint64_t)threads * perThread;
+    uint64_t before = written.load();
+    uint64_t start  = benchNowNs();
+    std::vector<std::thread> producers;
+    for (unsigned t = 0; t < threads; t++) {
+      producers.emplace_back([perThread, t] {
+        pin(t + 1);
+        for (int i = 0; i < perThread; i++) logger.info("sensor %d temp %.2f state %s", i, 21.5, "ok");
+      });
+    }
+    for (std::thread& p : producers) p.join();
+    waitFor(target);
+    double   seconds = (double)(benchNowNs() - start) / 1e9;
+    uint64_t lines   = written.load() - before;
+    char name[64];
+    snprintf(name, sizeof(name), "lines/s, %u producer%s, " MODE ", " RINGS, threads, threads > 1 ? "s" : "");
+    benchReport(name, (double)lines / seconds, "lines/s");
+    snprintf(name, sizeof(name), "dropped, %u producer%s, " MODE ", " RINGS, threads, threads > 1 ? "s" : "");
+    benchReport(name, (double)((uint64_t)threads * perThread - lines), "lines");
+  }
+}
+
+int main() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  engine.setWriteHook(hook);
+  if (!engine.start()) return 1;
+  callerCost();
+  throughput();
+  engine.stop();
+#if CHRONOLOG_DEFERRED
+  captureVsFormat();
+#endif
+  return 0;
+}
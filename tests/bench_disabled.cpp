@@ -0,0 +1,43 @@
+// Cost of a call whose level is disabled at run time: the inlined level test with plain, expensive
+// and lazy (lambda) arguments, and through CHRONOLOG_LOG, against an empty loop. The lazy form and
+// the plain one should stay within a couple of ns of the loop; the eager checksum shows what lazy
+// evaluation saves.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+static ChronoLogger logger("bench");
+static uint8_t      frame[256];
+
+static uint32_t checksum(const uint8_t* data, size_t len) {                                             // Stand-in for an argument worth skipping
+  uint32_t sum = 0;
+  for (size_t i = 0; i < len; i++) sum = (sum << 5) + sum + data[i];
+  return sum;
+}
+
+int main() {
+  logger.setLevel(CHRONOLOG_LEVEL_INFO);
+  for (size_t i = 0; i < sizeof(frame); i++) frame[i] = (uint8_t)i;
+  const long n = 20000000 * benchScale();
+
+  double loop  = benchNsPerOp(n, [&](long i) { benchKeep(i); });
+  double plain = benchNsPerOp(n, [&](long i) { logger.debug("frame %ld", i); benchKeep(i); });
+  double macro = benchNsPerOp(n, [&](long i) { CHRONOLOG_LOG(logger, CHRONOLOG_LEVEL_DEBUG, "frame %ld", i); benchKeep(i); });
+  double lazy  = benchNsPerOp(n, [&](long i) {
+    logger.debug([&] {
+      static char text[32];
+      snprintf(text, sizeof(text), "frame %ld crc %08x", i, (unsigned)checksum(frame, sizeof(frame)));
+      return text;
+    });
+    benchKeep(i);
+  });
+  double eager = benchNsPerOp(n / 100, [&](long i) { logger.debug("frame %ld crc %08x", i, (unsigned)checksum(frame, sizeof(frame))); benchKeep(i); });
+
+  benchReport("empty loop", loop, "ns");
+  benchReport("disabled debug(), plain arguments", plain, "ns");
+  benchReport("disabled CHRONOLOG_LOG", macro, "ns");
+  benchReport("disabled debug([&] { ... }), lazy checksum", lazy, "ns");
+  benchReport("disabled debug(), eager checksum", eager, "ns");
+  benchReport("disabled call over empty loop, worst", std::max(std::max(plain, macro), lazy) - loop, "ns");
+  return 0;
+}
@@ -0,0 +1,119 @@
+// ChronoLogFileSink against a plain sink that fwrite()s each line to a FILE, both behind
+// ChronoLogSinks with the transport muted: the caller's latency per line (mean and percentiles, one
+// thread) and lines per second from 1 and 4 threads, the final flush or close included. Built twice:
+// bench_file_sink uses io_uring where the kernel has it, bench_file_sink_pwrite
+// (CHRONOLOG_FILE_URING=0) writes from the sink's thread with pwrite().
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <thread>
+#include <unistd.h>
+
+#if CHRONOLOG_FILE_URING
+  #define MODE "io_uring"
+#else
+  #define MODE "pwrite"
+#endif
+
+static ChronoLogger logger("bench");
+static char         path[] = "/tmp/chronolog_bench_file_XXXXXX";
+
+static bool fwriteEntry(void* context, const char* data, size_t len) { return fwrite(data, 1, len, (FILE*)context) == len; }
+
+// One output under test: add() attaches it, finish() writes out what it still holds.
+struct Output {
+  const char*         name;
+  bool                stdio;                                                                            // fwrite() sink instead of ChronoLogFileSink
+  ChronoLogFileSink   file;
+  FILE*               plain = nullptr;
+  ChronoLogSink       sink  = {nullptr, nullptr, nullptr};
+
+  Output(const char* label, bool usesStdio) : name(label), stdio(usesStdio) {}
+
+  void add() {
+    if (stdio) {
+      plain = fopen(path, "w");
+      sink  = ChronoLogSink{fwriteEntry, nullptr, plain};
+    } else {
+      int rc = truncate(path, 0);                                                                       // open() appends
+      (void)rc;
+      file.open(path);
+      sink = file.sink();
+    }
+    ChronoLogSinks::add(sink, CHRONOLOG_LEVEL_DEBUG);
+  }
+
+  uint32_t finish() {                                                                                   // Lines refused by the file sink
+    ChronoLogSinks::remove(sink);
+    if (stdio) {
+      fclose(plain);
+      return 0;
+    }
+    uint32_t refused = file.stats().refused;
+    file.close();
+    return refused;
+  }
+};
+
+static void latency(Output& out, long n) {
+  BenchSamples samples;
+  uint64_t total = 0;
+  out.add();
+  for (long i = 0; i < n; i++) {
+    uint64_t start = benchNowNs();
+    logger.info("sensor %ld temp %.2f state %s", i, 21.5, "ok");
+    uint64_t ns = benchNowNs() - start;
+    samples.add(ns);
+    total += ns;
+  }
+  uint32_t refused = out.finish();
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s: caller ns/line", out.name);
+  benchReport(label, (double)total / (double)n, "ns");
+  const double points[] = {50, 99, 99.9};
+  for (double p : points) {
+    snprintf(label, sizeof(label), "%s: caller p%g", out.name, p);
+    benchReport(label, samples.percentile(p), "ns");
+  }
+  snprintf(label, sizeof(label), "%s: lines refused", out.name);
+  benchReport(label, refused, "lines");
+}
+
+static void throughput(Output& out, int threads, long n) {
+  const long perThread = n / threads;
+  std::vector<std::thread> workers;
+  out.add();
+  uint64_t start = benchNowNs();
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([perThread] {
+      for (long i = 0; i < perThread; i++) logger.info("sensor %ld temp %.2f state %s", i, 21.5, "ok");
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  uint32_t refused = out.finish();                                                                      // Time until the data is in the file
+  double seconds = (double)(benchNowNs() - start) / 1e9;
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s: %d thread%s", out.name, threads, threads == 1 ? "" : "s");
+  benchReport(label, (double)(perThread * threads - refused) / seconds, "lines/s");
+}
+
+int main() {
+  const long n = 100000 * benchScale();
+  close(mkstemp(path));
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+
+  Output file("ChronoLogFileSink, " MODE, false);
+  Output plain("fwrite sink", true);
+
+  latency(file, n);
+  latency(plain, n);
+  for (int threads : {1, 4}) {
+    throughput(file, threads, n);
+    throughput(plain, threads, n);
+  }
+  unlink(path);
+  return 0;
+}
@@ -0,0 +1,99 @@
+// Formatting cost: the {}-style engine (CHRONOLOG_FMT) against libc vsnprintf and the print()
+// backend on the same message, the backend's cost per output byte for integer and float fields,
+// and whole lines through a logger whose sink drops them. Built twice: bench_format with the libc
+// backend, bench_printf with the built-in ChronoLogWriter one (CHRONOLOG_PRINTF).
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <stdarg.h>
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
+
+#if CHRONOLOG_PRINTF
+  #define BACKEND "built-in"
+#else
+  #define BACKEND "libc"
+#endif
+
+struct NullSink {
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { benchKeep(data); benchKeep(len); }
+};
+
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, NullSink, ChronoLogPrintf> logger("bench");
+
+static int libc(char* out, size_t cap, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(out, cap, fmt, args);
+  va_end(args);
+  return n;
+}
+
+static int builtin(char* out, size_t cap, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = chronoLogVsnprintf(out, cap, fmt, args);
+  va_end(args);
+  return n;
+}
+
+static void message() {
+  const long n = 500000 * benchScale();
+  char text[CHRONOLOG_BUFFER_LEN];
+  double l = benchNsPerOp(n, [&](long i) { libc(text, sizeof(text), "sensor %d temp %.2f state %s", (int)i, 21.5, "ok"); benchKeep(text); });
+  double b = benchNsPerOp(n, [&](long i) { builtin(text, sizeof(text), "sensor %d temp %.2f state %s", (int)i, 21.5, "ok"); benchKeep(text); });
+  double f = benchNsPerOp(n, [&](long i) { ChronoLogFormat::format(CHRONOLOG_FMT("sensor {} temp {:.2f} state {}"), text, sizeof(text), (int)i, 21.5, "ok"); benchKeep(text); });
+  benchReport("message, libc vsnprintf", l, "ns");
+  benchReport("message, print() backend, " BACKEND, b, "ns");
+  benchReport("message, {} format", f, "ns");
+}
+
+static uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;                                                                                             // Reported as 0 where there is no cycle counter
+#endif
+}
+
+// Cost per byte written, so integer and float fields of different lengths compare directly.
+template <typename Format>
+static void perByte(const char* name, Format format) {
+  const long n = 500000 * benchScale();
+  char   text[CHRONOLOG_BUFFER_LEN];
+  size_t bytes = 0;
+  for (long i = 0; i < n / 16; i++) format(text, sizeof(text), i);                                    // Warm-up
+  uint64_t start = benchNowNs(), startCycles = cycles();
+  for (long i = 0; i < n; i++) bytes += (size_t)format(text, sizeof(text), i);
+  uint64_t ns = benchNowNs() - start, used = cycles() - startCycles;
+  benchKeep(text);
+  char label[64];
+  snprintf(label, sizeof(label), "%s ns/byte", name);
+  benchReport(label, (double)ns / (double)bytes, "ns");
+  snprintf(label, sizeof(label), "%s cycles/byte", name);
+  benchReport(label, (double)used / (double)bytes, "cycles");
+}
+
+static void bytes() {
+  perByte("integers, libc snprintf", [](char* out, size_t cap, long i) { return libc(out, cap, "id=%d n=%lu x=%08x", (int)i, 4000000000ul - i, (unsigned)i); });
+  perByte("integers, " BACKEND " backend", [](char* out, size_t cap, long i) { return builtin(out, cap, "id=%d n=%lu x=%08x", (int)i, 4000000000ul - i, (unsigned)i); });
+  perByte("floats, libc snprintf", [](char* out, size_t cap, long i) { return libc(out, cap, "t=%.2f v=%f", 21.375 + (double)(i & 63), -0.125 * (double)i); });
+  perByte("floats, " BACKEND " backend", [](char* out, size_t cap, long i) { return builtin(out, cap, "t=%.2f v=%f", 21.375 + (double)(i & 63), -0.125 * (double)i); });
+}
+
+static void line() {
+  const long n = 200000 * benchScale();
+  double p = benchNsPerOp(n, [&](long i) { logger.info("sensor %d temp %.2f state %s", (int)i, 21.5, "ok"); });
+  double f = benchNsPerOp(n, [&](long i) { logger.info(CHRONOLOG_FMT("sensor {} temp {:.2f} state {}"), (int)i, 21.5, "ok"); });
+  benchReport("line, printf API", p, "ns");
+  benchReport("line, {} API", f, "ns");
+}
+
+int main() {
+  message();
+  bytes();
+  line();
+  return 0;
+}
@@ -0,0 +1,55 @@
+// Header cost: the time | module | level | task columns built with snprintf("%-15s ...") as print()
+// used to, against the memcpy of the pre-rendered module column, level tag and cached task field.
+// Both produce the same bytes; the benchmark checks that before timing them.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <string.h>
+
+static const char* const levels[] = {"DEBUG   ", "FATAL   ", "ERROR   ", "WARNING ", "INFO    ", "DEBUG   "};
+static const char* const colors[] = {CHRONOLOG_COLOR_DEBUG, CHRONOLOG_COLOR_FATAL, CHRONOLOG_COLOR_ERROR,
+                                     CHRONOLOG_COLOR_WARN,  CHRONOLOG_COLOR_INFO,  CHRONOLOG_COLOR_DEBUG};
+
+static const char*                 module = "power.management";                                         // Longer than the column: cut
+static const ChronoLogModuleColumn column(module);
+
+static size_t formatted(char* buf, size_t cap, const char* time, ChronoLogLevel level, const char* task) {
+  int n = snprintf(buf, cap, "%s | %-15.15s | %s%s%s | %s | ", time, module, colors[level], levels[level],
+                   CHRONOLOG_COLOR_RESET, task);
+  return (n < 0) ? 0 : ((size_t)n < cap ? (size_t)n : cap - 1);
+}
+
+static size_t copied(char* buf, size_t cap, const char* time, ChronoLogLevel level, const ChronoLogTaskField::Field& task) {
+  const ChronoLogLevelTag& tag = ChronoLogLevelTag::of(level);
+  ChronoLogWriter::Out out = {buf, buf + cap};
+  out.put(time, strlen(time));
+  out.put(column.text, sizeof(column.text));
+  out.put(tag.text, tag.len);
+  out.put(task.text, task.len);
+  out.put(" | ", 3);
+  return (size_t)(out.p - buf);
+}
+
+int main() {
+  const long n = 1000000 * benchScale();
+  const char* time = "12:34:56.789";
+  ChronoLogTaskField::Field task;
+  ChronoLogTaskField::render(task, "sensor-task");
+
+  char a[CHRONOLOG_BUFFER_LEN], b[CHRONOLOG_BUFFER_LEN];
+  for (int level = CHRONOLOG_LEVEL_FATAL; level <= CHRONOLOG_LEVEL_DEBUG; level++) {
+    size_t la = formatted(a, sizeof(a), time, (ChronoLogLevel)level, task.text);
+    size_t lb = copied(b, sizeof(b), time, (ChronoLogLevel)level, task);
+    if (la != lb || memcmp(a, b, la) != 0) {
+      fprintf(stderr, "headers differ:\n%.*s\n%.*s\n", (int)la, a, (int)lb, b);
+      return 1;
+    }
+  }
+
+  double f = benchNsPerOp(n, [&](long i) { benchKeep(formatted(a, sizeof(a), time, (ChronoLogLevel)(1 + i % 5), task.text)); benchKeep(a); });
+  double c = benchNsPerOp(n, [&](long i) { benchKeep(copied(b, sizeof(b), time, (ChronoLogLevel)(1 + i % 5), task)); benchKeep(b); });
+  benchReport("header, snprintf %-15s (before)", f, "ns");
+  benchReport("header, pre-rendered memcpy", c, "ns");
+  return 0;
+}
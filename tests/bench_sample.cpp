@@ -0,0 +1,55 @@
+// Cost of a sampled call that is skipped, against an empty loop and a call that is written into a
+// sink that only counts bytes: CHRONOLOG_EVERY_N between lines, CHRONOLOG_FIRST_N once used up,
+// CHRONOLOG_EVERY_MS inside its window, and CHRONOLOG_ON_CHANGE with an unchanged int and string.
+// Also CHRONOLOG_EVERY_N from four threads on one site, where the shared counter is contended.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <thread>
+
+static size_t bytes;
+
+struct CountSink {                                                                                      // Sink policy that only counts
+  static void write(ChronoLogLevel, ChronoLogTarget, const char*, size_t len) { bytes += len; }
+};
+
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, CountSink, ChronoLogPrintf> logger("bench");
+
+static void sharedSite(long i) { CHRONOLOG_EVERY_N(logger, CHRONOLOG_LEVEL_DEBUG, 1000000000, "n %ld", i); }
+
+int main() {
+  const long n = 20000000 * benchScale();
+  const char* state = "calibrating";
+
+  double loop    = benchNsPerOp(n, [&](long i) { benchKeep(i); });
+  double written = benchNsPerOp(n / 100, [&](long i) { logger.debug("gyro z=%ld", i); });
+  double everyN  = benchNsPerOp(n, [&](long i) { CHRONOLOG_EVERY_N(logger, CHRONOLOG_LEVEL_DEBUG, 1000000000, "gyro z=%ld", i); benchKeep(i); });
+  double firstN  = benchNsPerOp(n, [&](long i) { CHRONOLOG_FIRST_N(logger, CHRONOLOG_LEVEL_DEBUG, 1, "gyro z=%ld", i); benchKeep(i); });
+  double everyMs = benchNsPerOp(n, [&](long i) { CHRONOLOG_EVERY_MS(logger, CHRONOLOG_LEVEL_DEBUG, 3600000, "gyro z=%ld", i); benchKeep(i); });
+  double sameInt = benchNsPerOp(n, [&](long i) { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_DEBUG, 3, "mode %d", 3); benchKeep(i); });
+  double sameStr = benchNsPerOp(n, [&](long i) { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_DEBUG, state, "state %s", state); benchKeep(i); });
+
+  const int threads = 4;
+  const long perThread = n / threads;
+  std::vector<std::thread> workers;
+  uint64_t start = benchNowNs();
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([perThread] {
+      for (long i = 0; i < perThread; i++) sharedSite(i);
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  double shared = (double)(benchNowNs() - start) / (double)(perThread * threads);
+  benchKeep(bytes);
+
+  benchReport("empty loop", loop, "ns");
+  benchReport("written debug line", written, "ns");
+  benchReport("CHRONOLOG_EVERY_N, skipped", everyN, "ns");
+  benchReport("CHRONOLOG_FIRST_N, used up", firstN, "ns");
+  benchReport("CHRONOLOG_EVERY_MS, inside the window", everyMs, "ns");
+  benchReport("CHRONOLOG_ON_CHANGE, same int", sameInt, "ns");
+  benchReport("CHRONOLOG_ON_CHANGE, same 11-char string", sameStr, "ns");
+  benchReport("CHRONOLOG_EVERY_N, 4 threads, one site", shared, "ns");
+  return 0;
+}
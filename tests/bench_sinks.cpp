@@ -0,0 +1,47 @@
+// Cost of the sink fan-out per line, with the transport muted so only dispatch is timed: a direct
+// ChronoLogSinks::write() with 0 to 4 sinks that take the line, with 4 sinks whose level filters it
+// out, and a whole logger call (header and formatting included) reaching 1 and 4 sinks.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+static ChronoLogger logger("bench");
+static size_t       bytes[4];
+
+static bool countWrite(void* context, const char*, size_t len) {
+  *static_cast<size_t*>(context) += len;
+  return true;
+}
+
+static const ChronoLogSink sinks[4] = {
+  {countWrite, nullptr, &bytes[0]}, {countWrite, nullptr, &bytes[1]},
+  {countWrite, nullptr, &bytes[2]}, {countWrite, nullptr, &bytes[3]},
+};
+
+int main() {
+  const long n = 5000000 * benchScale();
+  static const char line[] = "    1234567 | bench           | INFO    | main             | v=42\n";
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+
+  char label[64];
+  double full[5];
+  for (int k = 0; k <= 4; k++) {
+    if (k) ChronoLogSinks::add(sinks[k - 1], CHRONOLOG_LEVEL_DEBUG);
+    full[k] = benchNsPerOp(n, [&](long) { ChronoLogSinks::write(CHRONOLOG_LEVEL_INFO, nullptr, line, sizeof(line) - 1); });
+    snprintf(label, sizeof(label), "write() to %d sink%s", k, k == 1 ? "" : "s");
+    benchReport(label, full[k], "ns");
+  }
+  for (const ChronoLogSink& sink : sinks) ChronoLogSinks::setLevel(sink, CHRONOLOG_LEVEL_WARN);
+  double filtered = benchNsPerOp(n, [&](long) { ChronoLogSinks::write(CHRONOLOG_LEVEL_INFO, nullptr, line, sizeof(line) - 1); });
+  benchReport("write() to 4 sinks below their level", filtered, "ns");
+  benchReport("per added sink", (full[4] - full[0]) / 4, "ns");
+
+  for (const ChronoLogSink& sink : sinks) ChronoLogSinks::setLevel(sink, CHRONOLOG_LEVEL_DEBUG);
+  double four = benchNsPerOp(n / 10, [&](long i) { logger.info("v=%ld", i); });
+  for (int k = 1; k < 4; k++) ChronoLogSinks::remove(sinks[k]);
+  double one = benchNsPerOp(n / 10, [&](long i) { logger.info("v=%ld", i); });
+  benchReport("logger line to 1 sink", one, "ns");
+  benchReport("logger line to 4 sinks", four, "ns");
+  benchKeep(bytes);
+  return 0;
+}
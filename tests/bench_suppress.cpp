@@ -0,0 +1,42 @@
+// Cost of CHRONOLOG_SUPPRESS per call, into a sink that only counts bytes: a plain line with
+// collapsing off, the same line changing every call (key built and compared, then written), a
+// collapsed repeat (key compared, nothing formatted), a repeat with a long string argument, and a
+// CHRONOLOG_LIMIT() site within and past its budget.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+static size_t bytes;
+
+struct CountSink {                                                                                      // Sink policy that only counts
+  static void write(ChronoLogLevel, ChronoLogTarget, const char*, size_t len) { bytes += len; }
+};
+
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, CountSink, ChronoLogPrintf> logger("bench");
+
+int main() {
+  const long n = 200000 * benchScale();
+  const char* name = "sensor-bus-0";
+
+  logger.collapseRepeats(false);
+  double plain = benchNsPerOp(n, [&](long i) { logger.info("sample %ld on %s", i, name); });
+  logger.collapseRepeats(true);
+  double changing = benchNsPerOp(n, [&](long i) { logger.info("sample %ld on %s", i, name); });
+  double repeat   = benchNsPerOp(n * 10, [&](long) { logger.info("sample %ld on %s", 7L, name); });
+  double longArg  = benchNsPerOp(n * 10, [&](long) { logger.info("bus %s state %d", "i2c1 timeout, controller reset pending", 3); });
+
+  logger.setRateLimit(0, 0);                                                                            // Unlimited: every call takes a token
+  double limited = benchNsPerOp(n, [&](long i) { CHRONOLOG_LIMIT(logger, CHRONOLOG_LEVEL_INFO, "sample %ld", i); });
+  logger.setRateLimit(1, 1);
+  double refused = benchNsPerOp(n * 10, [&](long i) { CHRONOLOG_LIMIT(logger, CHRONOLOG_LEVEL_INFO, "sample %ld", i); });
+  benchKeep(bytes);
+
+  benchReport("plain line, collapsing off", plain, "ns");
+  benchReport("changing line, collapsing on", changing, "ns");
+  benchReport("collapsed repeat", repeat, "ns");
+  benchReport("collapsed repeat, 38-char string", longArg, "ns");
+  benchReport("CHRONOLOG_LIMIT, unlimited", limited, "ns");
+  benchReport("CHRONOLOG_LIMIT, refused", refused, "ns");
+  benchReport("collapse check on a written line", changing - plain, "ns");
+  return 0;
+}
@@ -0,0 +1,55 @@
+// Timestamp column cost: ChronoLogTimeCache (one compare and a copy while the second lasts) against
+// gettimeofday + localtime_r + snprintf on every line, single threaded and with every thread
+// stamping at once.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <thread>
+
+static void libc(char* out, size_t cap) {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  struct tm parts;
+  localtime_r(&tv.tv_sec, &parts);
+  snprintf(out, cap, "%02d:%02d:%02d.%03d", parts.tm_hour, parts.tm_min, parts.tm_sec, (int)(tv.tv_usec / 1000));
+}
+
+static void singleThread() {
+  const long n = 1000000 * benchScale();
+  char text[24];
+  double l = benchNsPerOp(n, [&](long) { libc(text, sizeof(text)); benchKeep(text); });
+  double c = benchNsPerOp(n, [&](long) { ChronoLogTimeCache::format(text, sizeof(text), true); benchKeep(text); });
+  double s = benchNsPerOp(n, [&](long) { ChronoLogTimeCache::format(text, sizeof(text), false); benchKeep(text); });
+  benchReport("timestamp, localtime_r + snprintf", l, "ns");
+  benchReport("timestamp, cached HH:MM:SS.mmm", c, "ns");
+  benchReport("timestamp, cached HH:MM:SS", s, "ns");
+}
+
+static void allThreads() {
+  unsigned threads = std::thread::hardware_concurrency();
+  if (threads < 2) threads = 2;
+  if (threads > 8) threads = 8;
+  const long n = 200000 * benchScale();
+  std::vector<std::thread> stampers;
+  uint64_t start = benchNowNs();
+  for (unsigned t = 0; t < threads; t++) {
+    stampers.emplace_back([n] {
+      char text[24];
+      for (long i = 0; i < n; i++) {
+        ChronoLogTimeCache::format(text, sizeof(text), true);
+        benchKeep(text);
+      }
+    });
+  }
+  for (std::thread& s : stampers) s.join();
+  char name[64];
+  snprintf(name, sizeof(name), "timestamp, cached, %u threads", threads);
+  benchReport(name, (double)(benchNowNs() - start) / (double)(n * threads), "ns");
+}
+
+int main() {
+  singleThread();
+  allThreads();
+  return 0;
+}
@@ -0,0 +1,85 @@
+// POSIX output path against the printf() approach of the ESP-IDF branch, into /dev/null and into a
+// regular file. The output alone: a line in three pieces (header, payload, newline) as one writev(2),
+// against printf() of the same pieces on a line-buffered stdout. Whole logger lines: ChronoLogger,
+// whose transport writes with writev(2), against the same policies with a Sink calling printf(),
+// from one thread and from four threads, where every printf() also takes the FILE lock.
+
+#include "ChronoLog.h"
+#include "chronolog_bench.h"
+
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
+struct PrintfSink {                                                                                     // What the ESP-IDF branch does with a line
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { printf("%.*s", (int)len, data); }
+};
+
+static ChronoLogger                                                                 logger("bench");
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, PrintfSink, ChronoLogPrintf> printfLogger("bench");
+
+static const char header[]  = "    1234567 | bench           | INFO    | main             | ";
+static const char payload[] = "sensor 3 temp 24.50 state ok";
+
+// Runs body with descriptor 1 pointing at path, then puts the terminal back for the report.
+template <typename Body>
+static double redirected(const char* path, Body&& body) {
+  fflush(stdout);
+  int saved = dup(1);
+  int fd    = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  dup2(fd, 1);
+  close(fd);
+  double ns = body();
+  fflush(stdout);
+  dup2(saved, 1);
+  close(saved);
+  return ns;
+}
+
+template <typename Call>
+static double threaded(int threads, long perThread, Call call) {
+  std::vector<std::thread> workers;
+  uint64_t start = benchNowNs();
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([perThread, call] {
+      for (long i = 0; i < perThread; i++) call(i);
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  return (double)(benchNowNs() - start) / (double)(perThread * threads);
+}
+
+static void run(const char* target, const char* path, long n) {
+  const ChronoLogPart parts[3] = {{header, sizeof(header) - 1}, {payload, sizeof(payload) - 1}, {"\n", 1}};
+  double gather = redirected(path, [&] { return benchNsPerOp(n, [&](long) { chronoLogWritev(parts, 3); }); });
+  double pieces = redirected(path, [&] { return benchNsPerOp(n, [&](long) { printf("%s%s\n", header, payload); }); });
+  double chrono = redirected(path, [&] { return benchNsPerOp(n, [&](long i) { logger.info("sensor %ld temp %.2f state %s", i, 24.5, "ok"); }); });
+  double viaPrintf = redirected(path, [&] { return benchNsPerOp(n, [&](long i) { printfLogger.info("sensor %ld temp %.2f state %s", i, 24.5, "ok"); }); });
+  double chrono4 = redirected(path, [&] { return threaded(4, n / 4, [](long i) { logger.info("sensor %ld temp %.2f state %s", i, 24.5, "ok"); }); });
+  double printf4 = redirected(path, [&] { return threaded(4, n / 4, [](long i) { printfLogger.info("sensor %ld temp %.2f state %s", i, 24.5, "ok"); }); });
+
+  char label[64];
+  snprintf(label, sizeof(label), "%s: writev, 3 pieces", target);
+  benchReport(label, gather, "ns");
+  snprintf(label, sizeof(label), "%s: printf, 3 pieces", target);
+  benchReport(label, pieces, "ns");
+  snprintf(label, sizeof(label), "%s: ChronoLogger line", target);
+  benchReport(label, chrono, "ns");
+  snprintf(label, sizeof(label), "%s: printf sink line", target);
+  benchReport(label, viaPrintf, "ns");
+  snprintf(label, sizeof(label), "%s: ChronoLogger, 4 threads", target);
+  benchReport(label, chrono4, "ns");
+  snprintf(label, sizeof(label), "%s: printf sink, 4 threads", target);
+  benchReport(label, printf4, "ns");
+}
+
+int main() {
+  setvbuf(stdout, nullptr, _IOLBF, BUFSIZ);                                                             // A console stdout, as on the ESP-IDF
+  const long n = 200000 * benchScale();
+  char path[] = "/tmp/chronolog_bench_writev_XXXXXX";
+  close(mkstemp(path));
+  run("/dev/null", "/dev/null", n);
+  run("file", path, n / 4);
+  unlink(path);
+  return 0;
+}
@@ -0,0 +1,28 @@
+# ChronoLog/tests/binary_roundtrip.cmake
+# cmake -DENCODER=<test_binary> -DDECODER=<chronolog_decode> -DOBJDUMP=<objdump> -DWORK=<dir> -P binary_roundtrip.cmake
+
+file(MAKE_DIRECTORY ${WORK})
+
+execute_process(COMMAND ${OBJDUMP} -h ${ENCODER} OUTPUT_VARIABLE sections RESULT_VARIABLE rc)
+string(REGEX MATCH "chronolog_fmt[^\n]*\n[^\n]*" fmt_section "${sections}")
+if(NOT rc EQUAL 0 OR fmt_section STREQUAL "")
+    message(FATAL_ERROR "no chronolog_fmt section in ${ENCODER}")
+endif()
+if(fmt_section MATCHES "ALLOC")
+    message(FATAL_ERROR "chronolog_fmt is loaded into memory:\n${fmt_section}")
+endif()
+
+execute_process(COMMAND ${ENCODER} ${WORK}/expected.txt OUTPUT_FILE ${WORK}/frames.bin RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "encoder failed: ${rc}")
+endif()
+
+execute_process(COMMAND ${DECODER} -e ${ENCODER} ${WORK}/frames.bin OUTPUT_FILE ${WORK}/decoded.txt RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "decoder failed: ${rc}")
+endif()
+
+execute_process(COMMAND ${ENCODER} --compare ${WORK}/expected.txt ${WORK}/decoded.txt RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "decoded text differs, see ${WORK}")
+endif()
@@ -0,0 +1,91 @@
+/*
+ ====================================================================================================
+ * File:        chronolog_bench.h
+ * Author:      Hamas Saeed
+ * Version:     Rev_1.0.0
+ * Date:        Oct 17 2026
+ * Brief:       Timing helpers shared by the ChronoLog host benchmarks
+ * 
+ ====================================================================================================
+ * License: 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Hamas Saeed
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ * For any inquiries, contact Hamas Saeed at hamasaeed@gmail.com
+ *
+ ====================================================================================================
+ */
+
+#ifndef CHRONOLOG_BENCH_H
+#define CHRONOLOG_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+// Work multiplier: ctest runs every benchmark once as a smoke test at scale 1, real measurements
+// set CHRONOLOG_BENCH_SCALE (e.g. 20) in the environment.
+static inline long benchScale() {
+  const char* text = getenv("CHRONOLOG_BENCH_SCALE");
+  long scale = text ? atol(text) : 1;
+  return scale > 0 ? scale : 1;
+}
+
+static inline uint64_t benchNowNs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Keeps the compiler from discarding a result the benchmark does not otherwise use.
+template <typename T> static inline void benchKeep(const T& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+// Mean cost of one call of body(), over iterations calls after a short warm-up.
+template <typename Body>
+static inline double benchNsPerOp(long iterations, Body&& body) {
+  for (long i = 0; i < iterations / 16 + 1; i++) body(i);
+  uint64_t start = benchNowNs();
+  for (long i = 0; i < iterations; i++) body(i);
+  return (double)(benchNowNs() - start) / (double)iterations;
+}
+
+// Latency samples in ns, reported as percentiles.
+struct BenchSamples {
+  std::vector<uint32_t> ns;
+
+  void add(uint64_t value) { ns.push_back(value > UINT32_MAX ? UINT32_MAX : (uint32_t)value); }
+
+  uint32_t percentile(double p) {
+    if (ns.empty()) return 0;
+    std::sort(ns.begin(), ns.end());
+    return ns[(size_t)(p / 100.0 * (double)(ns.size() - 1))];
+  }
+};
+
+static inline void benchReport(const char* name, double value, const char* unit) {
+  printf("%-44s %12.1f %s\n", name, value, unit);
+}
+
+#endif // CHRONOLOG_BENCH_H
@@ -0,0 +1,170 @@
+/*
+ ====================================================================================================
+ * File:        chronolog_test.h
+ * Author:      Hamas Saeed
+ * Version:     Rev_1.0.0
+ * Date:        Oct 17 2026
+ * Brief:       Minimal check macros and mock outputs shared by the ChronoLog host tests
+ * 
+ ====================================================================================================
+ * License: 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Hamas Saeed
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ * For any inquiries, contact Hamas Saeed at hamasaeed@gmail.com
+ *
+ ====================================================================================================
+ */
+
+#ifndef CHRONOLOG_TEST_H
+#define CHRONOLOG_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <unistd.h>
+
+static int chronolog_test_failures = 0;
+
+#define CHECK(cond)                                                                                   \
+  do {                                                                                                \
+    if (!(cond)) {                                                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);                        \
+      chronolog_test_failures++;                                                                      \
+    }                                                                                                 \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                                                \
+  do {                                                                                                \
+    long long chronolog_a = (long long)(a), chronolog_b = (long long)(b);                             \
+    if (chronolog_a != chronolog_b) {                                                                 \
+      fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b,   \
+              chronolog_a, chronolog_b);                                                              \
+      chronolog_test_failures++;                                                                      \
+    }                                                                                                 \
+  } while (0)
+
+#define CHECK_STR(haystack, needle)                                                                   \
+  do {                                                                                                \
+    std::string chronolog_h = (haystack);                                                             \
+    if (chronolog_h.find(needle) == std::string::npos) {                                              \
+      fprintf(stderr, "%s:%d: \"%s\" not found in \"%s\"\n", __FILE__, __LINE__, (const char*)(needle), \
+              chronolog_h.c_str());                                                                   \
+      chronolog_test_failures++;                                                                      \
+    }                                                                                                 \
+  } while (0)
+
+// Each test is a plain function; main() runs them in order and reports the failure count.
+#define RUN(test)                                                                                     \
+  do {                                                                                                \
+    int chronolog_before = chronolog_test_failures;                                                   \
+    test();                                                                                           \
+    printf("%-40s %s\n", #test, chronolog_test_failures == chronolog_before ? "ok" : "FAILED");     \
+  } while (0)
+
+#define TEST_RESULT() (chronolog_test_failures == 0 ? 0 : 1)
+
+/*
+ * Output that records every line it is given, for ChronoLogSinks::add(), as a ChronoLoggerT Sink
+ * policy (through a static instance) or as a ChronoLogAsync write hook.
+ */
+struct MockSink {
+  std::mutex               lock;
+  std::vector<std::string> lines;
+  size_t                   writes = 0;
+  bool                     accept = true;
+
+  bool write(const char* data, size_t len) {
+    std::lock_guard<std::mutex> g(lock);
+    writes++;
+    if (!accept) return false;
+    lines.emplace_back(data, len);
+    return true;
+  }
+
+  size_t count() {
+    std::lock_guard<std::mutex> g(lock);
+    return lines.size();
+  }
+
+  std::string text() {
+    std::lock_guard<std::mutex> g(lock);
+    std::string all;
+    for (const std::string& l : lines) all += l;
+    return all;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> g(lock);
+    lines.clear();
+    writes = 0;
+  }
+
+  static bool entry(void* self, const char* data, size_t len) { return static_cast<MockSink*>(self)->write(data, len); }
+};
+
+// Redirects stdout (fd 1), where the POSIX transport writes, into a temporary file.
+struct StdoutCapture {
+  int   saved;
+  FILE* file;
+
+  StdoutCapture() {
+    fflush(stdout);
+    saved = dup(1);
+    file  = tmpfile();
+    dup2(fileno(file), 1);
+  }
+
+  ~StdoutCapture() { restore(); }
+
+  std::string take() {
+    fflush(stdout);
+    std::string out;
+    char chunk[4096];
+    size_t n;
+    fseek(file, 0, SEEK_SET);
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) out.append(chunk, n);
+    int rc = ftruncate(fileno(file), 0);
+    (void)rc;
+    fseek(file, 0, SEEK_SET);
+    return out;
+  }
+
+  void restore() {
+    if (saved < 0) return;
+    fflush(stdout);
+    dup2(saved, 1);
+    close(saved);
+    saved = -1;
+  }
+};
+
+static inline size_t countLines(const std::string& text) {
+  size_t n = 0;
+  for (char c : text) n += (c == '\n');
+  return n;
+}
+
+#endif // CHRONOLOG_TEST_H
@@ -0,0 +1,38 @@
+# ChronoLog/tests/min_level_size.cmake
+# cmake -DFILTERED=<test_min_level> -DFULL=<test_min_level_all> -DOBJDUMP=<objdump> -P min_level_size.cmake
+
+file(STRINGS ${FILTERED} filtered_strings REGEX "floor marker")
+file(STRINGS ${FULL} full_strings REGEX "floor marker")
+foreach(removed "floor marker debug" "floor marker module info" "floor marker module warn")
+    if(NOT full_strings MATCHES "${removed}")
+        message(FATAL_ERROR "\"${removed}\" missing from ${FULL}, the check would prove nothing")
+    endif()
+    if(filtered_strings MATCHES "${removed}")
+        message(FATAL_ERROR "\"${removed}\" is still in ${FILTERED}")
+    endif()
+endforeach()
+foreach(kept "floor marker info" "floor marker module error")
+    if(NOT filtered_strings MATCHES "${kept}")
+        message(FATAL_ERROR "\"${kept}\" missing from ${FILTERED}")
+    endif()
+endforeach()
+
+# Size of one section, from objdump -h
+function(section_size image section out)
+    execute_process(COMMAND ${OBJDUMP} -h ${image} OUTPUT_VARIABLE headers RESULT_VARIABLE rc)
+    string(REGEX MATCH " ${section} +([0-9a-f]+)" row "${headers}")
+    if(NOT rc EQUAL 0 OR row STREQUAL "")
+        message(FATAL_ERROR "no ${section} section in ${image}")
+    endif()
+    math(EXPR bytes "0x${CMAKE_MATCH_1}")
+    set(${out} ${bytes} PARENT_SCOPE)
+endfunction()
+
+foreach(section .text .rodata)
+    section_size(${FILTERED} ${section} filtered_size)
+    section_size(${FULL} ${section} full_size)
+    message(STATUS "${section}: ${filtered_size} bytes filtered, ${full_size} bytes with every level")
+    if(NOT filtered_size LESS full_size)
+        message(FATAL_ERROR "${section} did not shrink: ${filtered_size} >= ${full_size}")
+    endif()
+endforeach()
@@ -0,0 +1,63 @@
+// Host stand-in for the CMSIS-RTOS/FreeRTOS headers an STM32Cube project includes: each std::thread
+// is a task with its own name and thread-local-storage pointers. Tests build on mock/stm32/main.h.
+//
+// A task ends with mock_task_delete(), which runs the TLS delete callbacks when the build defines
+// configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS, as vTaskDelete() does on kernels that have them.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#define osCMSIS 0x20001
+
+#ifndef configNUM_THREAD_LOCAL_STORAGE_POINTERS
+  #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 2
+#endif
+
+typedef long  BaseType_t;
+typedef void* TaskHandle_t;
+typedef void (*TlsDeleteCallbackFunction_t)(int, void*);
+
+#define taskSCHEDULER_SUSPENDED   0
+#define taskSCHEDULER_NOT_STARTED 1
+#define taskSCHEDULER_RUNNING     2
+
+struct MockTask {
+  char                        name[16] = "";
+  void*                       tls[configNUM_THREAD_LOCAL_STORAGE_POINTERS] = {};
+  TlsDeleteCallbackFunction_t onDelete[configNUM_THREAD_LOCAL_STORAGE_POINTERS] = {};
+};
+
+inline bool                 mock_scheduler = false;                                                    // Set once the "scheduler" runs
+inline thread_local MockTask mock_task;
+
+inline void mock_task_name(const char* name) {
+  size_t n = strnlen(name, sizeof(mock_task.name) - 1);
+  memcpy(mock_task.name, name, n);
+  mock_task.name[n] = '\0';
+}
+
+inline BaseType_t xTaskGetSchedulerState() { return mock_scheduler ? taskSCHEDULER_RUNNING : taskSCHEDULER_NOT_STARTED; }
+inline char*      pcTaskGetName(TaskHandle_t) { return mock_task.name; }
+inline void       vTaskDelay(uint32_t) {}
+
+inline void* pvTaskGetThreadLocalStoragePointer(TaskHandle_t, BaseType_t i) { return mock_task.tls[i]; }
+
+inline void vTaskSetThreadLocalStoragePointer(TaskHandle_t, BaseType_t i, void* p) { mock_task.tls[i] = p; }
+
+inline void vTaskSetThreadLocalStoragePointerAndDelCallback(TaskHandle_t, BaseType_t i, void* p,
+                                                            TlsDeleteCallbackFunction_t callback) {
+  mock_task.tls[i]      = p;
+  mock_task.onDelete[i] = callback;
+}
+
+inline void mock_task_delete() {
+  for (int i = 0; i < configNUM_THREAD_LOCAL_STORAGE_POINTERS; i++) {
+  #if defined(configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS) && configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS
+    if (mock_task.onDelete[i]) mock_task.onDelete[i](i, mock_task.tls[i]);
+  #endif
+    mock_task.tls[i]      = nullptr;
+    mock_task.onDelete[i] = nullptr;
+  }
+}
@@ -0,0 +1,20 @@
+// Host stand-in for FreeRTOS semphr.h: mutexes are std::mutex.
+
+#pragma once
+
+#include <mutex>
+
+typedef std::mutex* SemaphoreHandle_t;
+
+#define pdTRUE        1
+#define portMAX_DELAY 0xFFFFFFFFu
+
+inline SemaphoreHandle_t xSemaphoreCreateMutex()             { return new std::mutex; }
+inline void              vSemaphoreDelete(SemaphoreHandle_t m) { delete m; }
+inline BaseType_t        xSemaphoreGive(SemaphoreHandle_t m)   { m->unlock(); return pdTRUE; }
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t m, uint32_t ticks) {
+  if (ticks == 0) return m->try_lock() ? pdTRUE : 0;
+  m->lock();
+  return pdTRUE;
+}
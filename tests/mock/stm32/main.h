@@ -0,0 +1,79 @@
+// Host stand-in for an STM32Cube main.h: just enough of the HAL for ChronoLog's UART paths.
+//
+// A transfer started with HAL_UART_Transmit_DMA/_IT completes after `latency` ticks of simulated
+// time. Time advances by one tick on every HAL_GetTick() call, so a writer that polls the tick
+// while waiting lets the "interrupt" fire, unless PRIMASK is set or the caller is an ISR.
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+
+typedef enum { HAL_OK, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+#define HAL_DMA_MODULE_ENABLED
+#define HAL_MAX_DELAY 0xFFFFFFFFu
+
+struct DMA_HandleTypeDef { int channel; };
+
+struct UART_HandleTypeDef {
+  DMA_HandleTypeDef* hdmatx  = nullptr;
+  HAL_StatusTypeDef  refuse    = HAL_OK;                                                               // Returned by the next starts instead of starting
+  uint32_t           latency   = 4;                                                                    // Ticks per transfer, 0: never completes
+  const uint8_t*     data      = nullptr;
+  uint16_t           size      = 0;
+  bool               pending   = false;
+  uint32_t           startedAt = 0;
+  int                starts    = 0;
+  std::string        out;
+};
+
+inline uint32_t            mock_primask = 0;
+inline uint32_t            mock_ipsr    = 0;                                                           // Non-zero: running in an "ISR"
+inline uint32_t            mock_tick    = 0;
+inline UART_HandleTypeDef* mock_uart    = nullptr;                                                     // The UART the tick services
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);                                              // Defined by the test, as in a real project
+
+inline uint32_t __get_PRIMASK()           { return mock_primask; }
+inline void     __set_PRIMASK(uint32_t p) { mock_primask = p; }
+inline void     __disable_irq()           { mock_primask = 1; }
+inline uint32_t __get_IPSR()              { return mock_ipsr; }
+
+inline void mock_complete(UART_HandleTypeDef* h) {                                                    // The TX complete interrupt
+  h->out.append((const char*)h->data, h->size);
+  h->pending = false;
+  uint32_t ipsr = mock_ipsr;
+  mock_ipsr = 16 + 37;
+  HAL_UART_TxCpltCallback(h);
+  mock_ipsr = ipsr;
+}
+
+inline uint32_t HAL_GetTick() {
+  mock_tick++;
+  UART_HandleTypeDef* h = mock_uart;
+  if (h && h->pending && h->latency && mock_primask == 0 && mock_ipsr == 0 && mock_tick - h->startedAt >= h->latency) {
+    mock_complete(h);
+  }
+  return mock_tick;
+}
+
+inline HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* h, uint8_t* data, uint16_t size, uint32_t) {
+  h->out.append((const char*)data, size);
+  return HAL_OK;
+}
+
+inline HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* h, const uint8_t* data, uint16_t size) {
+  if (h->refuse != HAL_OK) return h->refuse;
+  if (h->pending) return HAL_BUSY;
+  h->data      = data;
+  h->size      = size;
+  h->pending   = true;
+  h->startedAt = mock_tick;
+  h->starts++;
+  return HAL_OK;
+}
+
+inline HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* h, const uint8_t* data, uint16_t size) {
+  return HAL_UART_Transmit_DMA(h, data, size);
+}
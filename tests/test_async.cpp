@@ -0,0 +1,106 @@
+// Async engine (CHRONOLOG_ASYNC): lines reach a mock output through the drain thread, in order per
+// producer, and the ring reports how full it got.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <map>
+#include <thread>
+
+static MockSink          drained;
+static std::atomic<bool> slow{false};
+
+static void hook(const char* data, size_t len) {
+  if (slow.load()) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  drained.write(data, len);
+}
+
+static ChronoLogger logger("async");
+
+static void syncByDefault() {
+  MockSink direct;
+  static ChronoLogSink sink;
+  sink = ChronoLogSink{MockSink::entry, nullptr, &direct};
+  ChronoLogSinks::add(sink);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+
+  CHECK(!ChronoLogAsync::instance().running());
+  logger.info("written before %s returns", "info()");
+  CHECK_EQ(direct.count(), 1);
+  CHECK_STR(direct.text(), "written before info() returns\n");
+
+  ChronoLogSinks::remove(sink);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_DEBUG);
+}
+
+static void everyLineInProducerOrder() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  drained.clear();
+  engine.setWriteHook(hook);
+  engine.setPolicy(CHRONOLOG_POLICY_BLOCK);
+  CHECK(engine.start());
+
+  const int threads = 4, perThread = 5000;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < threads; t++) {
+    producers.emplace_back([t] {
+      for (int i = 0; i < perThread; i++) logger.info("t%d %d", t, i);
+    });
+  }
+  for (std::thread& p : producers) p.join();
+  engine.stop();
+
+  CHECK_EQ(drained.count(), threads * perThread);
+  CHECK_EQ(engine.droppedCount(), 0);
+  std::map<int, int> last;
+  int outOfOrder = 0;
+  for (const std::string& line : drained.lines) {
+    size_t at = line.rfind("| t");
+    int t = -1, i = -1;
+    if (at == std::string::npos || sscanf(line.c_str() + at + 3, "%d %d", &t, &i) != 2) {
+      outOfOrder++;
+      continue;
+    }
+    if (last.count(t) && last[t] + 1 != i) outOfOrder++;
+    last[t] = i;
+  }
+  CHECK_EQ(outOfOrder, 0);
+  CHECK(engine.highWaterMark() >= 1);
+  CHECK(engine.highWaterMark() <= CHRONOLOG_ASYNC_QUEUE_LEN);
+}
+
+static void highWaterMarkWithSlowOutput() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  drained.clear();
+  slow = true;
+  engine.setPolicy(CHRONOLOG_POLICY_DROP_NEWEST);
+  uint32_t droppedBefore = engine.droppedCount();
+  CHECK(engine.start());
+
+  cpu_set_t one;                                                                                        // Keep every line on one core's ring
+  CPU_ZERO(&one);
+  CPU_SET(sched_getcpu() > 0 ? sched_getcpu() : 0, &one);
+  sched_setaffinity(0, sizeof(one), &one);
+
+  const int burst = CHRONOLOG_ASYNC_QUEUE_LEN * 4;
+  for (int i = 0; i < burst; i++) logger.info("burst %d", i);
+  CHECK_EQ(engine.highWaterMark(), CHRONOLOG_ASYNC_QUEUE_LEN);
+  engine.stop();
+  slow = false;
+
+  uint32_t dropped = engine.droppedCount() - droppedBefore;
+  CHECK(dropped > 0);
+  CHECK_EQ(engine.pending(), 0);
+  size_t marker = 0;
+  for (const std::string& line : drained.lines) marker += line.find("messages dropped") != std::string::npos;
+  CHECK_EQ(drained.count() - marker + dropped, burst);
+  engine.setWriteHook(nullptr);
+}
+
+int main() {
+  RUN(syncByDefault);
+  RUN(everyLineInProducerOrder);
+  RUN(highWaterMarkWithSlowOutput);
+  return TEST_RESULT();
+}
@@ -0,0 +1,155 @@
+// Binary mode (CHRONOLOG_BINARY) round trip, driven by binary_roundtrip.cmake:
+//   test_binary expected.txt > frames.bin      logs through the binary transport on stdout
+//   chronolog_decode -e test_binary frames.bin > decoded.txt
+//   test_binary --compare expected.txt decoded.txt
+// The image is linked with tools/chronolog_fmt.ld, so CHRONOLOG_STR() text is not even loaded: any
+// read of it on the encoding side would crash. The async build also drops frames on purpose.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <fstream>
+#include <thread>
+
+static ChronoLogger radio("radio");
+static ChronoLogger power("power.mgmt");
+static FILE*        expected = nullptr;
+
+static const char* const levelNames[] = {"", "FATAL", "ERROR", "WARNING", "INFO", "DEBUG"};
+
+template <typename... Args>
+static void expect(const ChronoLogger& logger, ChronoLogLevel level, const char* fmt, Args... args) {
+  char message[CHRONOLOG_BUFFER_LEN];
+  snprintf(message, sizeof(message), fmt, args...);
+  fprintf(expected, "%s\t%s\t%s\n", logger.moduleName(), levelNames[level], message);
+}
+
+// The literal goes to snprintf for the expected text and, wrapped or not, to the logger.
+#define SECTION(logger, level, fmt, ...)                                                              \
+  do {                                                                                                \
+    expect(logger, level, fmt, ##__VA_ARGS__);                                                        \
+    (logger).log(level, CHRONOLOG_STR(fmt), ##__VA_ARGS__);                                           \
+  } while (0)
+
+#define TABLE(logger, level, fmt, ...)                                                                \
+  do {                                                                                                \
+    expect(logger, level, fmt, ##__VA_ARGS__);                                                        \
+    (logger).log(level, fmt, ##__VA_ARGS__);                                                          \
+  } while (0)
+
+#define SITE(logger, level, fmt, ...)                                                                 \
+  do {                                                                                                \
+    expect(logger, level, fmt, ##__VA_ARGS__);                                                        \
+    CHRONOLOG_LOG(logger, level, fmt, ##__VA_ARGS__);                                                 \
+  } while (0)
+
+static void logEverything() {
+  int local = 0;
+  SECTION(radio, CHRONOLOG_LEVEL_INFO, "rssi=%d ch=%u", -71, 11u);
+  SECTION(radio, CHRONOLOG_LEVEL_WARN, "temp=%.2f limit=%5.1f", 21.5, 85.0);
+  SECTION(radio, CHRONOLOG_LEVEL_ERROR, "id=%08x big=%lld tiny=%hhd", 0xBEEFu, -1234567890123ll, (signed char)-5);
+  SECTION(power, CHRONOLOG_LEVEL_DEBUG, "state %s char %c at %p", "sleep", 'z', (void*)&local);
+  SECTION(power, CHRONOLOG_LEVEL_FATAL, "no arguments, 100%% literal");
+  TABLE(radio, CHRONOLOG_LEVEL_INFO, "table %d", 1);
+  TABLE(radio, CHRONOLOG_LEVEL_INFO, "table %d", 2);                                                   // Second use goes by id
+  SITE(power, CHRONOLOG_LEVEL_INFO, "site %d of %s", 3, "macro");
+  SITE(power, CHRONOLOG_LEVEL_WARN, "site without arguments");
+  for (int i = 0; i < 3 * CHRONOLOG_BINARY_STRINGS; i++) {                                            // More strings than table slots
+    char fmt[32];
+    snprintf(fmt, sizeof(fmt), "dynamic %d %%s", i);
+    const char* text = strdup(fmt);                                                                     // Distinct, long-lived strings
+    TABLE(radio, CHRONOLOG_LEVEL_DEBUG, text, "arg");
+  }
+}
+
+#if CHRONOLOG_ASYNC
+// Each round brings a new format string in while the small queue is full, so the frame defining
+// it is the one at risk. Lost lines are fine, but no frame that survives may refer to an id whose
+// definition was dropped or evicted.
+static void burst(ChronoLogPolicy policy) {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  engine.setPolicy(policy);
+  for (int round = 0; round < 20; round++) {
+    char fmt[24];
+    snprintf(fmt, sizeof(fmt), "burst %d %%d", round);
+    const char* text = strdup(fmt);                                                                     // Distinct, long-lived strings
+    ChronoLogBinary::reset();                                                                           // Free table slots, strings are defined again
+    for (int i = 0; i < CHRONOLOG_ASYNC_QUEUE_LEN * 2; i++) TABLE(power, CHRONOLOG_LEVEL_INFO, "filler %d", i);
+    for (int i = 0; i < CHRONOLOG_ASYNC_QUEUE_LEN * 2; i++) TABLE(power, CHRONOLOG_LEVEL_INFO, text, i);
+    while (engine.pending() > 0) std::this_thread::yield();
+    TABLE(power, CHRONOLOG_LEVEL_INFO, text, -1);
+    while (engine.pending() > 0) std::this_thread::yield();
+  }
+}
+#endif
+
+static std::vector<std::string> readLines(const char* path) {
+  std::vector<std::string> lines;
+  std::ifstream in(path);
+  for (std::string line; std::getline(in, line);) lines.push_back(line);
+  return lines;
+}
+
+// Every decoded line must be the next expected line still pending; lines may only be missing in
+// the async build, where each one is counted as dropped and announced by a drop marker frame.
+static int compare(const char* expectedPath, const char* decodedPath) {
+  std::vector<std::string> want = readLines(expectedPath);
+  std::vector<std::string> got  = readLines(decodedPath);
+  long dropped = 0, announced = 0;
+  if (!want.empty() && sscanf(want.back().c_str(), "dropped %ld", &dropped) == 1) want.pop_back();
+
+  size_t w = 0, matched = 0;
+  for (const std::string& line : got) {
+    CHECK(line.find("<?") == std::string::npos);
+    size_t marker = line.find("| *** ");
+    long n = 0;
+    if (marker != std::string::npos && sscanf(line.c_str() + marker, "| *** %ld messages dropped ***", &n) == 1) {
+      CHECK_STR(line, " ChronoLog ");
+      announced += n;
+      continue;
+    }
+    bool found = false;
+    while (w < want.size() && !found) {
+      const std::string& e = want[w++];
+      size_t tab1 = e.find('\t'), tab2 = e.find('\t', tab1 + 1);
+      std::string module = e.substr(0, tab1), level = e.substr(tab1 + 1, tab2 - tab1 - 1);
+      std::string tail   = "| " + e.substr(tab2 + 1);
+      found = line.size() >= tail.size() && line.compare(line.size() - tail.size(), tail.size(), tail) == 0 &&
+              line.find(" " + module + " ") != std::string::npos && line.find(level) != std::string::npos;
+    }
+    if (!found) fprintf(stderr, "unexpected line: %s\n", line.c_str());
+    CHECK(found);
+    matched++;
+  }
+  CHECK_EQ(matched + dropped, want.size());
+  CHECK_EQ(announced, dropped);
+  printf("%zu lines decoded, %ld dropped, %ld announced\n", matched, dropped, announced);
+  return TEST_RESULT();
+}
+
+int main(int argc, char** argv) {
+  if (argc == 4 && strcmp(argv[1], "--compare") == 0) return compare(argv[2], argv[3]);
+  if (argc != 2 || !(expected = fopen(argv[1], "w"))) {
+    fprintf(stderr, "usage: %s expected.txt > frames.bin\n", argv[0]);
+    return 2;
+  }
+
+#if CHRONOLOG_ASYNC
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  if (!engine.start()) return 1;
+  logEverything();
+  burst(CHRONOLOG_POLICY_DROP_NEWEST);
+  burst(CHRONOLOG_POLICY_DROP_OLDEST);
+  engine.stop();
+  fprintf(expected, "dropped %u\n", (unsigned)engine.droppedCount());
+  fclose(expected);
+#else
+  logEverything();
+  fclose(expected);
+  if (ChronoLogBinary::inlined() == 0) {                                                              // The spill path must have run
+    fprintf(stderr, "string table never filled up\n");
+    return 1;
+  }
+#endif
+  return 0;
+}
@@ -0,0 +1,108 @@
+// ChronoLogClock on a fake counter (setSource): the 32-bit counter and the millisecond tick both
+// wrap, reads are up to thousands of counter periods apart, and nowUs() must still follow the exact
+// 64-bit time, never stepping backwards.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <random>
+
+static uint64_t fakeTicks = 0;                                                                          // Exact time, in counts of fakeHz
+static uint32_t fakeHz    = 1000000;
+
+static uint32_t fakeCounter() { return (uint32_t)fakeTicks; }
+static uint32_t fakeMillis()  { return (uint32_t)((unsigned __int128)fakeTicks * 1000 / fakeHz); }
+
+static uint64_t exactUs() { return (uint64_t)((unsigned __int128)fakeTicks * 1000000 / fakeHz); }
+
+// Starts the fake clock at ticks and returns the offset between nowUs() and the exact time.
+static int64_t start(const ChronoLogClockSource& source, uint64_t ticks) {
+  fakeTicks = ticks;
+  fakeHz    = source.hz;
+  ChronoLogClock::setSource(&source);
+  return (int64_t)ChronoLogClock::nowUs() - (int64_t)exactUs();
+}
+
+// Random steps from a few counts to maxWraps counter periods (kept under the 49.7 days after which
+// the millisecond tick wraps as well); every read must sit within 1 us of the exact time plus the
+// seed offset.
+static void follow(const ChronoLogClockSource& source, uint64_t startTicks, uint32_t maxWraps, int steps) {
+  std::mt19937_64 rng(source.hz);
+  int64_t  offset = start(source, startTicks);
+  uint64_t last   = ChronoLogClock::nowUs();
+  int bad = 0, backwards = 0;
+  for (int i = 0; i < steps; i++) {
+    switch (rng() % 4) {
+      case 0:  fakeTicks += rng() % 64; break;
+      case 1:  fakeTicks += rng() % fakeHz; break;
+      case 2:  fakeTicks += rng() % 0x100000000ull; break;                                             // Up to one counter period
+      default: fakeTicks += rng() % (0x100000000ull * maxWraps + 1); break;                            // Wraps the counter did not see
+    }
+    uint64_t now = ChronoLogClock::nowUs();
+    int64_t  err = (int64_t)now - (int64_t)exactUs() - offset;
+    bad       += (err < -1 || err > 1);
+    backwards += (now < last);
+    last = now;
+  }
+  CHECK_EQ(bad, 0);
+  CHECK_EQ(backwards, 0);
+}
+
+static void microsecondCounter() {                                                                      // micros(): wraps every 71.6 minutes
+  static const ChronoLogClockSource source = {fakeCounter, fakeMillis, 1000000};
+  follow(source, 0xFFFFF000ull, 900, 200000);
+}
+
+static void cycleCounter() {                                                                            // DWT CYCCNT at 168 MHz: wraps every 25.6 s
+  static const ChronoLogClockSource source = {fakeCounter, fakeMillis, 168000000};
+  follow(source, 0xFFFFFFFFull - 1000, 4000, 200000);
+}
+
+static void oddRateCounter() {                                                                          // Not a whole number of MHz
+  static const ChronoLogClockSource source = {fakeCounter, fakeMillis, 32768};
+  follow(source, 12345, 2, 200000);
+}
+
+static void millisecondTickWraps() {                                                                    // HAL_GetTick() after 49.7 days
+  static const ChronoLogClockSource source = {fakeCounter, fakeMillis, 1000000};
+  uint64_t beforeWrap = (0xFFFFFFFFull - 2000) * 1000;                                                  // 2 s before the ms tick wraps
+  int64_t  offset     = start(source, beforeWrap);
+  uint64_t last       = ChronoLogClock::nowUs();
+  for (int i = 0; i < 4000; i++) {
+    fakeTicks += 1000;
+    uint64_t now = ChronoLogClock::nowUs();
+    CHECK(now > last);
+    last = now;
+  }
+  CHECK(fakeMillis() < 3000);                                                                           // The tick did wrap
+  CHECK_EQ((int64_t)last - (int64_t)exactUs(), offset);
+  CHECK(last > 0xFFFFFFFFull * 1000);                                                                   // 64 bits, past 49.7 days
+}
+
+static void wrapOnlyCounter() {                                                                         // No ms tick: reads must come once per period
+  static const ChronoLogClockSource source = {fakeCounter, nullptr, 1000000};
+  int64_t offset = start(source, 0xFFFFFF00ull);
+  for (int i = 0; i < 100; i++) {
+    fakeTicks += 0x80000000ull;                                                                         // Half a period per read
+    CHECK_EQ((int64_t)ChronoLogClock::nowUs() - (int64_t)exactUs(), offset);
+  }
+}
+
+static void deltaSinceLastLine() {
+  static const ChronoLogClockSource source = {fakeCounter, fakeMillis, 1000000};
+  start(source, 0xFFFFFFF0ull);
+  ChronoLogClock::sinceLastUs(ChronoLogClock::nowUs());
+  fakeTicks += 1234;                                                                                    // Across the counter wrap
+  CHECK_EQ(ChronoLogClock::sinceLastUs(ChronoLogClock::nowUs()), 1234u);
+}
+
+int main() {
+  RUN(microsecondCounter);
+  RUN(cycleCounter);
+  RUN(oddRateCounter);
+  RUN(millisecondTickWraps);
+  RUN(wrapOnlyCounter);
+  RUN(deltaSinceLastLine);
+  ChronoLogClock::setSource(nullptr);
+  return TEST_RESULT();
+}
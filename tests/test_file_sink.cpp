@@ -0,0 +1,302 @@
+// ChronoLogFileSink: what reaches the file, rotation to path.1 .. path.keep (also while earlier
+// buffers are still being written), and the pwrite() writer that takes over when io_uring is
+// unavailable. Built twice: test_file_sink uses io_uring where the
+// kernel has it, test_file_sink_pwrite (CHRONOLOG_FILE_URING=0) never tries. The refused-io_uring
+// cases run in a forked child under a seccomp filter, since a filter cannot be removed again.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include <thread>
+#if defined(CHRONOLOG_HAS_URING)
+  #include <sys/prctl.h>
+  #include <sys/wait.h>
+  #include <linux/filter.h>
+  #include <linux/seccomp.h>
+#endif
+
+static ChronoLogger logger("file");
+static char         dir[] = "/tmp/chronolog_file_sink_XXXXXX";
+
+static std::string pathOf(const char* name, int k = 0) {
+  std::string p = std::string(dir) + "/" + name;
+  if (k > 0) p += "." + std::to_string(k);
+  return p;
+}
+
+static bool exists(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+static std::string slurp(const std::string& path) {
+  std::string out;
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return out;
+  char chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) out.append(chunk, n);
+  fclose(f);
+  return out;
+}
+
+static void removeAll(const char* name, int keep) {
+  for (int k = 0; k <= keep + 1; k++) unlink(pathOf(name, k).c_str());
+}
+
+// Line i is exactly 20 bytes, so a file's size says how many lines it holds.
+static void writeLines(ChronoLogFileSink& file, int from, int count) {
+  char line[32];
+  for (int i = from; i < from + count; i++) {
+    snprintf(line, sizeof(line), "line %08d ......\n", i);
+    CHECK(file.write(line, 20));
+  }
+}
+
+// The numbers of the lines in text, which must run on from first without a gap.
+static bool consecutive(const std::string& text, int first) {
+  if (text.size() % 20 != 0) return false;
+  for (size_t at = 0; at < text.size(); at += 20) {
+    if (atoi(text.c_str() + at + 5) != first++) return false;
+  }
+  return true;
+}
+
+static void linesReachTheFileInOrder() {
+  removeAll("plain.log", 0);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("plain.log").c_str()));
+  writeLines(file, 0, 5000);
+  file.close();
+  std::string text = slurp(pathOf("plain.log"));
+  CHECK_EQ(text.size(), 5000u * 20);
+  CHECK(consecutive(text, 0));
+  CHECK(!exists(pathOf("plain.log", 1)));
+  removeAll("plain.log", 0);
+}
+
+static void openAppends() {
+  removeAll("append.log", 0);
+  FILE* f = fopen(pathOf("append.log").c_str(), "w");
+  fputs("earlier run\n", f);
+  fclose(f);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("append.log").c_str()));
+  writeLines(file, 0, 10);
+  file.close();
+  std::string text = slurp(pathOf("append.log"));
+  CHECK(text.compare(0, 12, "earlier run\n") == 0);
+  CHECK(consecutive(text.substr(12), 0));
+  removeAll("append.log", 0);
+}
+
+// Each flush() hands over one 200-byte buffer, so a 1000-byte limit puts five in every file.
+static void rotationKeepsTheNewestFiles() {
+  removeAll("rot.log", 3);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("rot.log").c_str(), 1000, 3));
+  for (int chunk = 0; chunk < 100; chunk++) {
+    writeLines(file, chunk * 10, 10);
+    file.flush();
+  }
+  ChronoLogFileSink::Stats stats = file.stats();
+  file.close();
+  CHECK_EQ(stats.rotations, 19u);
+  CHECK_EQ(stats.bytes, 20000u);
+  CHECK_EQ(stats.errors, 0u);
+  CHECK(!exists(pathOf("rot.log", 4)));
+  int first = 1000;
+  for (int k = 0; k <= 3; k++) {                                                                        // Newest first: rot.log, rot.log.1, ...
+    std::string text = slurp(pathOf("rot.log", k));
+    CHECK_EQ(text.size(), 1000u);
+    first -= 50;
+    CHECK(consecutive(text, first));
+  }
+  removeAll("rot.log", 3);
+}
+
+static void rotationWithoutHistoryTruncates() {
+  removeAll("trunc.log", 1);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("trunc.log").c_str(), 1000, 0));
+  for (int chunk = 0; chunk < 12; chunk++) {
+    writeLines(file, chunk * 10, 10);
+    file.flush();
+  }
+  CHECK_EQ(file.stats().rotations, 2u);
+  file.close();
+  CHECK(!exists(pathOf("trunc.log", 1)));
+  std::string text = slurp(pathOf("trunc.log"));
+  CHECK_EQ(text.size(), 400u);
+  CHECK(consecutive(text, 100));
+  removeAll("trunc.log", 1);
+}
+
+// Lines from..from+count, formatted up front and handed over chunk lines per write() as fast as the
+// sink takes them; a write that finds every buffer busy is offered again.
+static void writeChunks(ChronoLogFileSink& file, int from, int count, int chunk) {
+  char line[32];
+  std::string text;
+  for (int i = from; i < from + count; i++) {
+    snprintf(line, sizeof(line), "line %08d ......\n", i);
+    text.append(line, 20);
+  }
+  for (size_t at = 0; at < text.size(); at += (size_t)chunk * 20) {
+    size_t n = std::min(text.size() - at, (size_t)chunk * 20);
+    while (!file.write(text.data() + at, n)) std::this_thread::yield();
+  }
+}
+
+// No flush() between buffers, so rotations happen while earlier buffers are still in flight. A
+// file truncated under such a write would get a hole of zeros or a stale line.
+static void rotationWithWritesInFlight() {
+  for (unsigned keep : {0u, 2u}) {
+    removeAll("busy.log", keep);
+    ChronoLogFileSink file;
+    CHECK(file.open(pathOf("busy.log").c_str(), 600000, keep));
+    writeChunks(file, 0, 200000, 10000);                                                                // 200 kB: one per buffer
+    ChronoLogFileSink::Stats stats = file.stats();
+    file.close();
+    CHECK(stats.rotations > 0);
+    CHECK_EQ(stats.errors, 0u);
+    std::string text;
+    for (int k = (int)keep; k >= 0; k--) text += slurp(pathOf("busy.log", k));                          // Oldest first
+    CHECK(!text.empty());
+    CHECK(consecutive(text, 200000 - (int)(text.size() / 20)));
+    CHECK(slurp(pathOf("busy.log")).size() <= 600000u + CHRONOLOG_FILE_BUFFER_LEN);
+    removeAll("busy.log", keep);
+  }
+}
+
+static void noLimitNeverRotates() {
+  removeAll("big.log", 1);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("big.log").c_str(), 0, 3));
+  for (int chunk = 0; chunk < 20; chunk++) {
+    writeLines(file, chunk * 100, 100);
+    file.flush();
+  }
+  CHECK_EQ(file.stats().rotations, 0u);
+  file.close();
+  CHECK(!exists(pathOf("big.log", 1)));
+  CHECK_EQ(slurp(pathOf("big.log")).size(), 2000u * 20);
+  removeAll("big.log", 1);
+}
+
+static void loggerLinesThroughSinks() {
+  removeAll("sink.log", 0);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("sink.log").c_str()));
+  ChronoLogSinks::add(file.sink(), CHRONOLOG_LEVEL_INFO);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+  for (int i = 0; i < 300; i++) logger.info("reading %d", i);
+  logger.debug("below the sink's level");
+  ChronoLogSinks::remove(file.sink());
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_DEBUG);
+  file.close();
+  std::string text = slurp(pathOf("sink.log"));
+  CHECK_EQ(countLines(text), 300u);
+  CHECK_STR(text, "| file ");
+  CHECK_STR(text, "| reading 299\n");
+  CHECK(text.find("below") == std::string::npos);
+  removeAll("sink.log", 0);
+}
+
+static void closedSinkRefusesLines() {
+  ChronoLogFileSink file;
+  CHECK(!file.write("x\n", 2));
+  CHECK(!file.open((std::string(dir) + "/missing/dir.log").c_str()));
+  CHECK(!file.write("x\n", 2));
+}
+
+#if defined(CHRONOLOG_HAS_URING)
+// Makes one system call fail with err in this thread and every thread it starts later.
+static bool refuse(long nr, int err) {
+  struct sock_filter code[] = {
+    BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, (unsigned)nr, 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | ((unsigned)err & SECCOMP_RET_DATA)),
+    BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW),
+  };
+  struct sock_fprog prog = {(unsigned short)(sizeof(code) / sizeof(code[0])), code};
+  return prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) == 0 && prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &prog) == 0;
+}
+
+// Runs the rotation workload in a child with nr refused, and returns the child's failure count.
+static int withoutSyscall(const char* name, long nr, int err, bool uring) {
+  removeAll(name, 2);
+  pid_t pid = fork();
+  if (pid == 0) {
+    if (!refuse(nr, err)) _exit(100);
+    ChronoLogFileSink file;
+    CHECK(file.open(pathOf(name).c_str(), 1000, 2));
+    CHECK_EQ(file.stats().uring, uring);
+    for (int chunk = 0; chunk < 30; chunk++) {
+      writeLines(file, chunk * 10, 10);
+      file.flush();
+    }
+    ChronoLogFileSink::Stats stats = file.stats();
+    file.close();
+    CHECK_EQ(stats.bytes, 6000u);
+    CHECK_EQ(stats.errors, 0u);
+    CHECK_EQ(stats.rotations, 5u);
+    CHECK(consecutive(slurp(pathOf(name, 2)) + slurp(pathOf(name, 1)) + slurp(pathOf(name)), 150));
+    _exit(chronolog_test_failures);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  removeAll(name, 2);
+  if (WIFEXITED(status) && WEXITSTATUS(status) == 100) {
+    printf("  (seccomp unavailable, %s skipped)\n", name);
+    return 0;
+  }
+  return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+// Seccomp-style refusal of io_uring_setup: the sink never uses the ring and pwrite() writes it all.
+static void pwriteWhenRingIsRefused() {
+  CHECK_EQ(withoutSyscall("nosetup.log", __NR_io_uring_setup, ENOSYS, false), 0);
+}
+
+// The ring comes up but every submission fails: each buffer falls back to pwrite() on its own.
+static void pwriteWhenSubmitFails() {
+  CHECK_EQ(withoutSyscall("noenter.log", __NR_io_uring_enter, EPERM, CHRONOLOG_FILE_URING != 0), 0);
+}
+#endif
+
+static void ringUseFollowsTheBuild() {
+  removeAll("mode.log", 0);
+  ChronoLogFileSink file;
+  CHECK(file.open(pathOf("mode.log").c_str()));
+  bool uring = file.stats().uring;
+  file.close();
+#if !CHRONOLOG_FILE_URING
+  CHECK(!uring);
+#else
+  printf("  (io_uring %s)\n", uring ? "in use" : "unavailable, pwrite() used");
+#endif
+  removeAll("mode.log", 0);
+}
+
+int main() {
+  if (!mkdtemp(dir)) return 1;
+  RUN(linesReachTheFileInOrder);
+  RUN(openAppends);
+  RUN(rotationKeepsTheNewestFiles);
+  RUN(rotationWithoutHistoryTruncates);
+  RUN(rotationWithWritesInFlight);
+  RUN(noLimitNeverRotates);
+  RUN(loggerLinesThroughSinks);
+  RUN(closedSinkRefusesLines);
+  RUN(ringUseFollowsTheBuild);
+#if defined(CHRONOLOG_HAS_URING)
+  RUN(pwriteWhenRingIsRefused);
+  RUN(pwriteWhenSubmitFails);
+#endif
+  rmdir(dir);
+  return TEST_RESULT();
+}
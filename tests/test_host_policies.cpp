@@ -0,0 +1,114 @@
+// Host policies and custom policy sets of ChronoLoggerT: the steady clock column, ChronoLogFdSink
+// through ChronoLogHostLogger, user-written Clock, Sink and Formatter policies, and the level cap.
+// Only loggers writing through ChronoLogSinks stop at its ceiling; a logger with its own Sink keeps
+// every level its rules and setLevel() give it, while registry rules still apply to it.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <ctype.h>
+#include <thread>
+
+static MockSink lines;
+
+struct LineSink {                                                                                       // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { lines.write(data, len); }
+};
+
+struct FixedClock {
+  static void format(char* buf, size_t size) { snprintf(buf, size, "T+0"); }
+};
+
+struct ShoutFormatter {                                                                                 // printf, then upper case
+  static int format(char* buf, size_t size, const char* fmt, va_list args) {
+    int n = vsnprintf(buf, size, fmt, args);
+    for (char* p = buf; *p; p++) *p = (char)toupper((unsigned char)*p);
+    return n;
+  }
+};
+
+static ChronoLogger                                                                  shared("shared");
+static ChronoLogHostLogger                                                           host("host");
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, LineSink, ChronoLogPrintf> captured("captured");
+static ChronoLoggerT<FixedClock, ChronoLogThreadName, LineSink, ShoutFormatter>      custom("custom");
+
+static void steadyClockColumn() {
+  char a[16], b[16];
+  ChronoLogSteadyClock::format(a, sizeof(a));
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  ChronoLogSteadyClock::format(b, sizeof(b));
+  CHECK_EQ(strlen(a), 12u);
+  CHECK_EQ(strlen(b), 12u);
+  CHECK(atoll(b) - atoll(a) >= 2000);                                                                   // Microseconds
+  char tiny[4];
+  ChronoLogSteadyClock::format(tiny, sizeof(tiny));                                                     // Cut short, still terminated
+  CHECK(strlen(tiny) < sizeof(tiny));
+}
+
+static void hostLoggerWritesToStdout() {
+  StdoutCapture capture;
+  host.info("over fd %d", 1);
+  std::string out = capture.take();
+  capture.restore();
+  CHECK_EQ(countLines(out), 1u);
+  CHECK_STR(out, "| host ");
+  CHECK_STR(out, "| over fd 1\n");
+}
+
+static void customPoliciesCompose() {
+  lines.clear();
+  custom.warn("value %d of %s", 7, "limit");
+  CHECK_EQ(lines.count(), 1u);
+  std::string line = lines.text();
+  CHECK(line.compare(0, 3, "T+0") == 0);
+  CHECK_STR(line, "| custom ");
+  CHECK_STR(line, "| VALUE 7 OF LIMIT\n");
+}
+
+// A transport at ERROR with no sinks caps ChronoLogSinks loggers at ERROR, and nothing else.
+static void sinksCeilingCapsOnlyItsLoggers() {
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_ERROR);
+  CHECK_EQ(shared.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+  CHECK_EQ(captured.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+  CHECK_EQ(host.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+
+  lines.clear();
+  captured.debug("still written");
+  CHECK_EQ(lines.count(), 1u);
+
+  captured.setLevel(CHRONOLOG_LEVEL_INFO);
+  shared.setLevel(CHRONOLOG_LEVEL_INFO);
+  CHECK_EQ(captured.currentLevel(), CHRONOLOG_LEVEL_INFO);
+  CHECK_EQ(shared.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+
+  CHECK(ChronoLogRegistry::setRules("*=debug"));
+  CHECK_EQ(captured.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+  CHECK_EQ(shared.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_DEBUG);
+  CHECK_EQ(shared.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+  ChronoLogRegistry::clearRules();
+  captured.setLevel(CHRONOLOG_LEVEL_DEBUG);
+  shared.setLevel(CHRONOLOG_LEVEL_DEBUG);
+}
+
+static void rulesApplyToEveryPolicySet() {
+  CHECK(ChronoLogRegistry::setRules("host=warn, c*=error"));
+  CHECK_EQ(host.currentLevel(), CHRONOLOG_LEVEL_WARN);
+  CHECK_EQ(captured.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+  CHECK_EQ(custom.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+  lines.clear();
+  custom.warn("filtered");
+  CHECK_EQ(lines.count(), 0u);
+  ChronoLogRegistry::clearRules();
+  CHECK_EQ(custom.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+}
+
+int main() {
+  RUN(steadyClockColumn);
+  RUN(hostLoggerWritesToStdout);
+  RUN(customPoliciesCompose);
+  RUN(sinksCeilingCapsOnlyItsLoggers);
+  RUN(rulesApplyToEveryPolicySet);
+  return TEST_RESULT();
+}
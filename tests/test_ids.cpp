@@ -0,0 +1,59 @@
+// Compile-time string ids across translation units: test_ids_peer.cpp hashes and registers the same
+// literals, which must give the same ids and not count as collisions. The test_ids_collide build adds
+// two distinct strings with one id in different units, which ChronoLogIds::collisions() and
+// `chronolog_decode --check-ids` must both report.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+uint32_t peerFormatId();
+uint32_t peerModuleId();
+void     peerLog();
+
+CHRONOLOG_MODULE(static ChronoLogger, radio, "radio");
+CHRONOLOG_MODULE(static ChronoLogger, power, "power", CHRONOLOG_LEVEL_WARN);
+
+static_assert(CHRONOLOG_ID("frame 72659") == CHRONOLOG_ID("frame 513806"), "known FNV-1a collision");
+
+static size_t entries(uint32_t id) {                                                                    // chronolog_ids entries carrying id
+  size_t n = 0;
+  for (const ChronoLogIdEntry* e = __start_chronolog_ids; e < __stop_chronolog_ids; e++) n += e->id == id;
+  return n;
+}
+
+static void idsMatchAcrossUnits() {
+  CHECK_EQ(peerFormatId(), CHRONOLOG_ID("rssi=%d ch=%u"));
+  CHECK_EQ(peerModuleId(), radio.id());
+  CHECK_EQ(radio.id(), CHRONOLOG_ID("radio"));
+  CHECK_EQ(power.id(), chronoLogHash(power.moduleName()));
+}
+
+static void everySiteIsRegistered() {
+  CHRONOLOG_LOG(radio, CHRONOLOG_LEVEL_INFO, "rssi=%d ch=%u", -70, 11u);
+  CHRONOLOG_LIMIT(radio, CHRONOLOG_LEVEL_WARN, "retry %d", 4);
+  radio.info(CHRONOLOG_FMT("link {} up"), 2);
+  peerLog();
+
+  CHECK(__start_chronolog_ids != nullptr);
+  CHECK_EQ(entries(CHRONOLOG_ID("radio")), 2u);                                                         // One CHRONOLOG_MODULE() per unit
+  CHECK_EQ(entries(CHRONOLOG_ID("power")), 1u);
+  CHECK_EQ(entries(CHRONOLOG_ID("rssi=%d ch=%u")), 2u);
+  CHECK_EQ(entries(CHRONOLOG_ID("retry %d")), 2u);
+  CHECK_EQ(entries(CHRONOLOG_ID("link {} up")), 2u);
+}
+
+static void collisionsAreFound() {
+#if CHRONOLOG_TEST_COLLIDE
+  CHRONOLOG_LOG(power, CHRONOLOG_LEVEL_INFO, "frame 513806");
+  CHECK_EQ(ChronoLogIds::collisions(), 1u);
+#else
+  CHECK_EQ(ChronoLogIds::collisions(), 0u);
+#endif
+}
+
+int main() {
+  RUN(idsMatchAcrossUnits);
+  RUN(everySiteIsRegistered);
+  RUN(collisionsAreFound);
+  return TEST_RESULT();
+}
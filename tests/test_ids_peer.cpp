@@ -0,0 +1,18 @@
+// Second translation unit of test_ids: the same literals and module name as test_ids.cpp, hashed and
+// registered here on their own.
+
+#include "ChronoLog.h"
+
+CHRONOLOG_MODULE(static ChronoLogger, radio, "radio");
+
+uint32_t peerFormatId() { return CHRONOLOG_ID("rssi=%d ch=%u"); }
+uint32_t peerModuleId() { return radio.id(); }
+
+void peerLog() {
+  CHRONOLOG_LOG(radio, CHRONOLOG_LEVEL_INFO, "rssi=%d ch=%u", -71, 11u);
+  CHRONOLOG_LIMIT(radio, CHRONOLOG_LEVEL_WARN, "retry %d", 3);
+  radio.info(CHRONOLOG_FMT("link {} up"), 1);
+#if CHRONOLOG_TEST_COLLIDE
+  CHRONOLOG_LOG(radio, CHRONOLOG_LEVEL_INFO, "frame 72659");                                         // Same FNV-1a id as "frame 513806"
+#endif
+}
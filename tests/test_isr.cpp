@@ -0,0 +1,139 @@
+// Interrupt entry points (CHRONOLOG_ISR) hammered from signal handlers: every record posted is
+// replayed exactly once or counted as dropped, and while the async engine runs only its drain
+// replays them. A record the queue cannot take is counted by the engine per level and reported by
+// its drop marker.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <set>
+#include <signal.h>
+#include <thread>
+
+static ChronoLogger          logger("isr");
+static std::atomic<int>      posted{0};
+static std::atomic<bool>     producing{false};
+static MockSink              drained;
+static std::mutex            writersLock;
+static std::set<std::thread::id> writers;                                                               // Threads the hook ran on
+
+static void onSignal(int) {
+  logger.infoFromISR("sig %d", posted.fetch_add(1, std::memory_order_relaxed));
+}
+
+static void hook(const char* data, size_t len) {
+  {
+    std::lock_guard<std::mutex> g(writersLock);
+    writers.insert(std::this_thread::get_id());
+  }
+  drained.write(data, len);
+}
+
+// Two producers log regular lines while a third thread interrupts them with SIGUSR1.
+static void hammer(std::vector<std::thread::id>& ids) {
+  const int signals = 20000;
+  producing = true;
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 2; t++) {
+    producers.emplace_back([t] {
+      for (int i = 0; producing.load(); i++) logger.info("t%d %d", t, i);
+    });
+  }
+  for (std::thread& p : producers) ids.push_back(p.get_id());
+  for (int i = 0; i < signals; i++) {
+    pthread_kill(producers[i % 2].native_handle(), SIGUSR1);
+    if (i % 64 == 0) std::this_thread::yield();
+  }
+  producing = false;
+  for (std::thread& p : producers) p.join();
+}
+
+// Every sequence number appears at most once, and lines plus drops account for all of them.
+static void checkRecords(MockSink& sink, uint32_t droppedBefore) {
+  std::set<int> seen;
+  int duplicates = 0;
+  for (const std::string& line : sink.lines) {
+    size_t at = line.find("| sig ");
+    if (at == std::string::npos) continue;
+    CHECK_STR(line, "ISR");
+    if (!seen.insert(atoi(line.c_str() + at + 6)).second) duplicates++;
+  }
+  uint32_t dropped = ChronoLogIsr::queue.dropped.load() - droppedBefore;
+  CHECK_EQ(duplicates, 0);
+  CHECK(!seen.empty());
+  CHECK_EQ(seen.size() + dropped, posted.load());
+}
+
+static void synchronousReplay() {
+  static ChronoLogSink sink;
+  MockSink direct;
+  sink = ChronoLogSink{MockSink::entry, nullptr, &direct};
+  ChronoLogSinks::add(sink);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+  posted = 0;
+  uint32_t droppedBefore = ChronoLogIsr::queue.dropped.load();
+
+  std::vector<std::thread::id> ids;
+  hammer(ids);
+  logger.info("flush");                                                                                 // Replays what the last signals left
+  checkRecords(direct, droppedBefore);
+
+  ChronoLogSinks::remove(sink);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_DEBUG);
+}
+
+static void asyncReplaysOnDrainTask() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  drained.clear();
+  writers.clear();
+  engine.setWriteHook(hook);
+  engine.setPolicy(CHRONOLOG_POLICY_BLOCK);
+  CHECK(engine.start());
+  posted = 0;
+  uint32_t droppedBefore = ChronoLogIsr::queue.dropped.load();
+  uint32_t engineBefore  = engine.droppedCount();
+
+  std::vector<std::thread::id> ids;
+  hammer(ids);
+  engine.stop();
+  engine.setWriteHook(nullptr);
+
+  checkRecords(drained, droppedBefore);
+  CHECK(engine.droppedCount() - engineBefore >= ChronoLogIsr::queue.dropped.load() - droppedBefore);   // Counted by the engine too
+  for (std::thread::id id : ids) CHECK(writers.count(id) == 0);                                          // Producers never write themselves
+}
+
+// Thirteen ints do not fit CHRONOLOG_RECORD_ARG_BYTES (48), so the record cannot be captured.
+static void uncapturedRecordIsReported() {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  drained.clear();
+  engine.setWriteHook(hook);
+  CHECK(engine.start());
+  uint32_t queueBefore = ChronoLogIsr::queue.dropped.load();
+  uint32_t errorBefore = engine.droppedCount(CHRONOLOG_LEVEL_ERROR);
+  uint32_t totalBefore = engine.droppedCount();
+
+  logger.errorFromISR("%d %d %d %d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13);
+  CHECK_EQ(ChronoLogIsr::queue.dropped.load() - queueBefore, 1u);
+  CHECK_EQ(engine.droppedCount(CHRONOLOG_LEVEL_ERROR) - errorBefore, 1u);
+  CHECK_EQ(engine.droppedCount() - totalBefore, 1u);
+
+  logger.info("after");                                                                                 // The drain that writes it reports the loss
+  engine.stop();
+  engine.setWriteHook(nullptr);
+  CHECK_STR(drained.text(), "*** 1 messages dropped ***");
+}
+
+int main() {
+  struct sigaction sa = {};
+  sa.sa_handler = onSignal;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  sigaction(SIGUSR1, &sa, nullptr);
+
+  RUN(synchronousReplay);
+  RUN(asyncReplaysOnDrainTask);
+  RUN(uncapturedRecordIsReported);
+  return TEST_RESULT();
+}
@@ -0,0 +1,85 @@
+// Single-write line assembly: the sink is called once per line with header, message and newline in
+// one buffer, for short lines, lines longer than the stack buffer and concurrent writers, both as
+// a Sink policy and through ChronoLogSinks.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <thread>
+
+static MockSink counted;
+
+struct CountingSink {                                                                                   // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { counted.write(data, len); }
+};
+
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, CountingSink, ChronoLogPrintf> logger("lines");
+
+// One complete line: exactly one newline, at the end, after the header.
+static bool wholeLine(const std::string& text) {
+  size_t eol = sizeof(CHRONOLOG_EOL) - 1;
+  return text.size() > eol && text.compare(text.size() - eol, eol, CHRONOLOG_EOL) == 0 &&
+         countLines(text) == 1 && text.find(" | lines ") != std::string::npos;
+}
+
+static void oneWritePerLine() {
+  counted.clear();
+  const int lines = 1000;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lines; i++) logger.info("sensor %d temp %.2f state %s", i, 21.5, "ok");
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / lines;
+  CHECK_EQ(counted.writes, (size_t)lines);
+  for (const std::string& line : counted.lines) CHECK(wholeLine(line));
+  CHECK_STR(counted.lines.back(), "sensor 999 temp 21.50 state ok");
+  printf("sink calls/line %.2f, %.0f ns/line\n", (double)counted.writes / lines, ns);
+}
+
+static void longLineIsOneWrite() {                                                                      // Goes through the heap buffer
+  counted.clear();
+  std::string payload(CHRONOLOG_BUFFER_LEN * 3, 'x');
+  logger.warn("long %s end", payload.c_str());
+  CHECK_EQ(counted.writes, 1u);
+  CHECK(wholeLine(counted.lines[0]));
+  CHECK_STR(counted.lines[0], ("long " + payload + " end").c_str());
+}
+
+static void concurrentLinesStayWhole() {
+  counted.clear();
+  const int threads = 8, perThread = 2000;
+  std::vector<std::thread> writers;
+  for (int t = 0; t < threads; t++) {
+    writers.emplace_back([t] {
+      for (int i = 0; i < perThread; i++) logger.info("t%d line %d of a message long enough to be split", t, i);
+    });
+  }
+  for (std::thread& w : writers) w.join();
+  CHECK_EQ(counted.writes, (size_t)(threads * perThread));
+  size_t broken = 0;
+  for (const std::string& line : counted.lines) broken += !wholeLine(line);
+  CHECK_EQ(broken, 0u);
+}
+
+static void sinksGetOneWritePerLine() {
+  static ChronoLogSink sink;
+  static ChronoLogger  shared("lines");
+  MockSink direct;
+  sink = ChronoLogSink{MockSink::entry, nullptr, &direct};
+  ChronoLogSinks::add(sink);
+  StdoutCapture capture;
+  for (int i = 0; i < 100; i++) shared.info("shared %d", i);
+  std::string out = capture.take();
+  capture.restore();
+  ChronoLogSinks::remove(sink);
+
+  CHECK_EQ(direct.writes, 100u);
+  for (const std::string& line : direct.lines) CHECK(wholeLine(line));
+  CHECK_EQ(countLines(out), 100u);
+}
+
+int main() {
+  RUN(oneWritePerLine);
+  RUN(longLineIsOneWrite);
+  RUN(concurrentLinesStayWhole);
+  RUN(sinksGetOneWritePerLine);
+  return TEST_RESULT();
+}
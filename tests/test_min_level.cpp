@@ -0,0 +1,68 @@
+// Compile-time level floor (CHRONOLOG_MIN_LEVEL): calls above it must not run, must not evaluate their
+// arguments and must leave no trace in the image. Built at -O0, where nothing else would remove them,
+// once with an INFO floor and once with every level kept. min_level_size.cmake then checks the
+// filtered image has none of the marker strings and smaller .text and .rodata than the full one.
+
+#ifndef CHRONOLOG_TEST_KEEP_ALL
+  #define CHRONOLOG_TEST_KEEP_ALL 0
+#endif
+
+#define CHRONOLOG_MIN_LEVEL CHRONOLOG_LEVEL_INFO
+#if CHRONOLOG_TEST_KEEP_ALL
+  #undef  CHRONOLOG_MIN_LEVEL
+  #define CHRONOLOG_MIN_LEVEL CHRONOLOG_LEVEL_DEBUG
+#endif
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+static MockSink lines;
+
+struct LineSink {                                                                                       // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { lines.write(data, len); }
+};
+
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, LineSink, ChronoLogPrintf> logger("floor");
+static int        evaluated = 0;
+static bool       keepAll   = CHRONOLOG_TEST_KEEP_ALL;                                                  // Not const: -O0 would fold the checks on it
+
+static int sideEffect() { return ++evaluated; }
+
+static void globalFloor() {
+  CHRONOLOG_DEBUG(logger, "floor marker debug %d %d", sideEffect(), 1);
+  CHRONOLOG_DEBUG(logger, "floor marker debug %d %d", sideEffect(), 2);
+  CHRONOLOG_INFO(logger, "floor marker info %d", 3);
+}
+
+#undef  CHRONOLOG_MIN_LEVEL
+#if CHRONOLOG_TEST_KEEP_ALL
+  #define CHRONOLOG_MIN_LEVEL CHRONOLOG_LEVEL_DEBUG
+#else
+  #define CHRONOLOG_MIN_LEVEL CHRONOLOG_LEVEL_ERROR                                                     // The rest of this file: errors and up
+#endif
+
+static void moduleFloor() {
+  CHRONOLOG_INFO(logger, "floor marker module info %d", sideEffect());
+  CHRONOLOG_WARN(logger, "floor marker module warn %d", sideEffect());
+  CHRONOLOG_ERROR(logger, "floor marker module error %d", 4);
+}
+
+static void filtered() {
+  lines.clear();
+  evaluated = 0;
+  globalFloor();
+  moduleFloor();
+  std::string text = lines.text();
+  CHECK_EQ(lines.count(), keepAll ? 6u : 2u);                                                           // Same checks in both images, so
+  CHECK_EQ(evaluated, keepAll ? 4 : 0);                                                                 // only the log calls differ
+  CHECK(keepAll || text.find("debug") == std::string::npos);
+  CHECK(keepAll || text.find("module info") == std::string::npos);
+  CHECK(keepAll || text.find("module warn") == std::string::npos);
+  CHECK_STR(text, "floor marker info 3");
+  CHECK_STR(text, "floor marker module error 4");
+}
+
+int main() {
+  RUN(filtered);
+  return TEST_RESULT();
+}
@@ -0,0 +1,150 @@
+// Overflow policies against a slow sink: the drain is held inside the write hook while a burst fills
+// the 16 line ring, then released. Each policy must keep the lines it promises, count the rest per
+// level, and announce exactly that many in its "*** N messages dropped ***" markers.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <thread>
+
+static MockSink          drained;
+static std::atomic<bool> entered{false};
+static std::atomic<bool> opened{false};
+
+static void hook(const char* data, size_t len) {                                                        // Stalls on the "gate" line until opened
+  if (std::string(data, len).find("| gate") != std::string::npos) {
+    entered = true;
+    while (!opened.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  drained.write(data, len);
+}
+
+static ChronoLogger logger("policy");
+
+struct Burst {
+  std::vector<int> kept;                                                                                // Burst numbers that came out, in order
+  uint32_t         announced = 0;                                                                       // Sum of the drop markers
+  uint32_t         dropped[CHRONOLOG_LEVEL_DEBUG + 1] = {};
+  double           ms = 0;                                                                              // Time the producer spent in the burst
+};
+
+// Holds the drain in the hook, runs log(), opens the gate (at once, or after openAfterMs from another
+// thread) and stops the engine so everything is written.
+template <typename Log>
+static Burst run(ChronoLogPolicy policy, uint32_t waitMs, ChronoLogLevel keep, int openAfterMs, Log log) {
+  ChronoLogAsync& engine = ChronoLogAsync::instance();
+  uint32_t before[CHRONOLOG_LEVEL_DEBUG + 1];
+  for (int l = 0; l <= CHRONOLOG_LEVEL_DEBUG; l++) before[l] = engine.droppedCount((ChronoLogLevel)l);
+  drained.clear();
+  entered = false;
+  opened  = false;
+  engine.setWriteHook(hook);
+  engine.setPolicy(policy, waitMs, keep);
+  CHECK(engine.start());
+
+  logger.info("gate");
+  while (!entered.load()) std::this_thread::yield();
+  std::thread opener;
+  if (openAfterMs > 0) {
+    opener = std::thread([openAfterMs] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(openAfterMs));
+      opened = true;
+    });
+  }
+  Burst burst;
+  auto start = std::chrono::steady_clock::now();
+  log();
+  burst.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  if (opener.joinable()) opener.join();
+  opened = true;
+  engine.stop();
+  engine.setWriteHook(nullptr);
+
+  for (const std::string& line : drained.lines) {
+    unsigned n = 0;
+    size_t at  = line.find("*** ");
+    if (at != std::string::npos && sscanf(line.c_str() + at, "*** %u messages dropped ***", &n) == 1) {
+      burst.announced += n;
+      continue;
+    }
+    at = line.rfind("| n ");
+    if (at != std::string::npos) burst.kept.push_back(atoi(line.c_str() + at + 4));
+  }
+  for (int l = 0; l <= CHRONOLOG_LEVEL_DEBUG; l++) burst.dropped[l] = engine.droppedCount((ChronoLogLevel)l) - before[l];
+  return burst;
+}
+
+static uint32_t total(const Burst& burst) {
+  uint32_t n = 0;
+  for (uint32_t d : burst.dropped) n += d;
+  return n;
+}
+
+static bool consecutive(const Burst& burst, int first, int count) {
+  if ((int)burst.kept.size() != count) return false;
+  for (int i = 0; i < count; i++) {
+    if (burst.kept[i] != first + i) return false;
+  }
+  return true;
+}
+
+static void infoBurst(int lines) {
+  for (int i = 0; i < lines; i++) logger.info("n %d", i);
+}
+
+static void dropNewestKeepsTheFirst() {
+  Burst burst = run(CHRONOLOG_POLICY_DROP_NEWEST, 0, CHRONOLOG_LEVEL_WARN, 0, [] { infoBurst(40); });
+  CHECK(consecutive(burst, 0, CHRONOLOG_ASYNC_QUEUE_LEN));
+  CHECK_EQ(burst.dropped[CHRONOLOG_LEVEL_INFO], 40u - CHRONOLOG_ASYNC_QUEUE_LEN);
+  CHECK_EQ(burst.announced, total(burst));
+}
+
+// Eviction only needs the rings, which the stalled drain does not hold while writing.
+static void dropOldestKeepsTheLast() {
+  Burst burst = run(CHRONOLOG_POLICY_DROP_OLDEST, 0, CHRONOLOG_LEVEL_WARN, 0, [] { infoBurst(40); });
+  CHECK(consecutive(burst, 40 - CHRONOLOG_ASYNC_QUEUE_LEN, CHRONOLOG_ASYNC_QUEUE_LEN));
+  CHECK_EQ(burst.dropped[CHRONOLOG_LEVEL_INFO], 40u - CHRONOLOG_ASYNC_QUEUE_LEN);
+  CHECK_EQ(burst.announced, total(burst));
+}
+
+static void blockWaitsForTheSink() {
+  Burst burst = run(CHRONOLOG_POLICY_BLOCK, 0, CHRONOLOG_LEVEL_WARN, 50, [] { infoBurst(40); });
+  CHECK(consecutive(burst, 0, 40));
+  CHECK_EQ(total(burst), 0u);
+  CHECK_EQ(burst.announced, 0u);
+  CHECK(burst.ms >= 40);                                                                                // Held until the gate opened
+}
+
+static void blockTimeoutGivesUp() {
+  Burst burst = run(CHRONOLOG_POLICY_BLOCK_TIMEOUT, 5, CHRONOLOG_LEVEL_WARN, 0, [] { infoBurst(24); });
+  CHECK(consecutive(burst, 0, CHRONOLOG_ASYNC_QUEUE_LEN));
+  CHECK_EQ(burst.dropped[CHRONOLOG_LEVEL_INFO], 24u - CHRONOLOG_ASYNC_QUEUE_LEN);
+  CHECK(burst.ms >= 4.0 * (24 - CHRONOLOG_ASYNC_QUEUE_LEN));                                            // Each dropped line waited out waitMs, give or take a tick
+  CHECK_EQ(burst.announced, total(burst));
+}
+
+// The last quarter of the ring is kept for WARN and above; a full ring drops anything.
+static void dropBelowKeepsRoomForWarnings() {
+  Burst burst = run(CHRONOLOG_POLICY_DROP_BELOW, 0, CHRONOLOG_LEVEL_WARN, 0, [] {
+    int n = 0;
+    for (int i = 0; i < 14; i++) logger.info("n %d", n++);
+    for (int i = 0; i < 4; i++) logger.warn("n %d", n++);
+    for (int i = 0; i < 2; i++) logger.info("n %d", n++);
+    logger.warn("n %d", n++);
+  });
+  CHECK_EQ(burst.kept.size(), (size_t)CHRONOLOG_ASYNC_QUEUE_LEN);
+  CHECK_EQ(burst.kept.back(), 17);                                                                      // The four warnings made it
+  CHECK_EQ(burst.dropped[CHRONOLOG_LEVEL_INFO], 4u);
+  CHECK_EQ(burst.dropped[CHRONOLOG_LEVEL_WARN], 1u);
+  CHECK_EQ(burst.announced, total(burst));
+}
+
+int main() {
+  RUN(dropNewestKeepsTheFirst);
+  RUN(dropOldestKeepsTheLast);
+  RUN(blockWaitsForTheSink);
+  RUN(blockTimeoutGivesUp);
+  RUN(dropBelowKeepsRoomForWarnings);
+  return TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+// Built-in printf backend (CHRONOLOG_PRINTF): chronoLogVsnprintf() must produce what glibc snprintf
+// produces, byte for byte and in its return value, for randomized flags, widths, precisions,
+// length modifiers and values, plus the edge cases randomness rarely hits.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <math.h>
+#include <random>
+
+static std::mt19937_64 rng(7);
+static long            mismatches = 0;
+static long            compared   = 0;
+
+static int ours(char* out, size_t cap, const char* fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = chronoLogVsnprintf(out, cap, fmt, args);
+  va_end(args);
+  return n;
+}
+
+template <typename... Args>
+static void compare(const char* fmt, Args... args) {
+  char want[512], got[512];
+  int  wantLen = snprintf(want, sizeof(want), fmt, args...);
+  int  gotLen  = ours(got, sizeof(got), fmt, args...);
+  compared++;
+  if (wantLen == gotLen && strcmp(want, got) == 0) return;
+  if (mismatches++ < 20) fprintf(stderr, "\"%s\": libc [%s] %d, ours [%s] %d\n", fmt, want, wantLen, got, gotLen);
+}
+
+static const char* pick(const char* const* options, size_t count) { return options[rng() % count]; }
+
+static void randomized() {
+  static const char* const flags[]      = {"", "-", "+", " ", "#", "0", "-+", "+0", "#0", "- ", "0 ", "#-"};
+  static const char* const widths[]     = {"", "1", "5", "12", "20"};
+  static const char* const precisions[] = {"", ".0", ".1", ".3", ".6", ".10", "."};
+  const long before = mismatches;
+  for (int i = 0; i < 300000; i++) {
+    char fmt[32];
+    const char* f = pick(flags, 12);
+    const char* w = pick(widths, 5);
+    const char* p = pick(precisions, 7);
+    long long value = (long long)rng() >> (rng() % 64);                                               // Every magnitude, not just huge ones
+    if (rng() & 1) value = -value;
+    switch (rng() % 9) {
+      case 0: snprintf(fmt, sizeof(fmt), "%%%s%s%sd", f, w, p);   compare(fmt, (int)value); break;
+      case 1: snprintf(fmt, sizeof(fmt), "%%%s%s%slu", f, w, p);  compare(fmt, (unsigned long)value); break;
+      case 2: snprintf(fmt, sizeof(fmt), "%%%s%s%sllx", f, w, p); compare(fmt, value); break;
+      case 3: snprintf(fmt, sizeof(fmt), "%%%s%s%sX", f, w, p);   compare(fmt, (unsigned)value); break;
+      case 4: snprintf(fmt, sizeof(fmt), "%%%s%s%so", f, w, p);   compare(fmt, (unsigned)value); break;
+      case 5: snprintf(fmt, sizeof(fmt), "%%%s%s%shhd|%%hu", f, w, p); compare(fmt, (int)value, (int)value); break;
+      case 6: {
+        double d = ldexp((double)(rng() % 100000000) / 1e4, (int)(rng() % 40) - 20);
+        if (rng() & 1) d = -d;
+        snprintf(fmt, sizeof(fmt), "%%%s%s%s%c", f, w, p, "feEgG"[rng() % 5]);
+        compare(fmt, d);
+        break;
+      }
+      case 7: snprintf(fmt, sizeof(fmt), "%%%s%s%ss", (rng() & 1) ? "-" : "", w, p); compare(fmt, "hello world"); break;
+      case 8:
+        snprintf(fmt, sizeof(fmt), "%%%s%sc|%%*.*d", (rng() & 1) ? "-" : "", w);
+        compare(fmt, 'A' + (int)(rng() % 26), (int)(rng() % 20) - 10, (int)(rng() % 8) - 2, (int)value);
+        break;
+    }
+  }
+  CHECK_EQ(mismatches - before, 0);
+}
+
+static void edgeCases() {
+  const long before = mismatches;
+  compare("%f %e %g", 0.0, -0.0, 1e-300);
+  compare("%f", 1e20);
+  compare("%.3f", 123456789012345678.0);
+  compare("%g %g %g", 1e100, 123456.0, 1234567.0);
+  compare("%F %E %G", INFINITY, -INFINITY, NAN);
+  compare("%s %%%d%%", "lit", 5);
+  compare("%zu %td %jd", (size_t)7, (ptrdiff_t)-3, (intmax_t)9);
+  compare("%d %d %u", INT32_MIN, INT32_MAX, UINT32_MAX);
+  compare("%lld %llu", (long long)INT64_MIN, (unsigned long long)UINT64_MAX);
+  CHECK_EQ(mismatches - before, 0);
+}
+
+static void truncation() {                                                                             // Unlike snprintf, returns the length written
+  char small[8];
+  int n = ours(small, sizeof(small), "value=%d units", 123456);
+  CHECK_EQ(n, 7);
+  CHECK(strcmp(small, "value=1") == 0);
+  CHECK_EQ(ours(nullptr, 0, "%d", 42), 0);
+}
+
+int main() {
+  RUN(randomized);
+  RUN(edgeCases);
+  RUN(truncation);
+  printf("%ld/%ld mismatches\n", mismatches, compared);
+  return TEST_RESULT();
+}
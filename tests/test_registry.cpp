@@ -0,0 +1,165 @@
+// Logger registry under load: threads log through shared loggers and through short-lived local ones
+// while others swap wildcard rules and call setLevel(). No line may come out at a level that no
+// rule ever allowed, the list must only hold live loggers, and the last rules must be what every
+// logger ends up with, also when several threads set rules at once or use a new logger first at the
+// same moment.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+static MockSink lines;
+
+struct LineSink {                                                                                       // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { lines.write(data, len); }
+};
+
+typedef ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, LineSink, ChronoLogPrintf> Logger;
+
+static_assert(!std::is_copy_constructible<Logger>::value, "loggers are registered by address");
+static_assert(!std::is_copy_assignable<Logger>::value, "loggers are registered by address");
+
+static Logger radio("net.radio");
+static Logger mqtt("net.mqtt");
+static Logger app("app");
+static Logger imu("sensors.imu", CHRONOLOG_LEVEL_ERROR);
+
+// The two rule sets the writer alternates between. Under neither may app log DEBUG or imu log INFO.
+static const char* const ruleSets[] = {"net.*=debug, *=warn", "net.*=error, app=info, *=warn"};
+
+static size_t entries(const char* name) {
+  const ChronoLogModule* all[128];
+  size_t n = ChronoLogRegistry::list(all, 128);
+  size_t found = 0;
+  for (size_t i = 0; i < n && i < 128; i++) {
+    if (strcmp(all[i]->moduleName(), name) == 0) found++;
+  }
+  return found;
+}
+
+static bool listed(const char* name) { return entries(name) > 0; }
+
+static void rulesChangeWhileLogging() {
+  CHECK(ChronoLogRegistry::setRules(ruleSets[1]));                                                      // Before any logger can use its own level
+  lines.clear();
+  std::atomic<bool> running{true};
+  std::atomic<long> calls{0};
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 4; t++) {                                                                         // Loggers shared by every thread
+    threads.emplace_back([&, t] {
+      for (long i = 0; running.load(); i++) {
+        radio.debug("radio debug %d %ld", t, i);
+        mqtt.info("mqtt info %d %ld", t, i);
+        app.debug("app debug %d %ld", t, i);
+        app.info("app info %d %ld", t, i);
+        imu.info("imu info %d %ld", t, i);
+        imu.warn("imu warn %d %ld", t, i);
+        calls += 6;
+      }
+    });
+  }
+  for (int t = 0; t < 2; t++) {                                                                         // Loggers that register and leave
+    threads.emplace_back([&, t] {
+      for (long i = 0; running.load(); i++) {
+        Logger local(t ? "net.tmp" : "app.tmp");
+        local.debug("tmp debug %d %ld", t, i);
+        local.warn("tmp warn %d %ld", t, i);
+      }
+    });
+  }
+  threads.emplace_back([&] {                                                                            // setLevel() races the rules
+    for (long i = 0; running.load(); i++) radio.setLevel(i % 2 ? CHRONOLOG_LEVEL_DEBUG : CHRONOLOG_LEVEL_WARN);
+  });
+
+  for (int round = 0; round < 400; round++) {
+    CHECK(ChronoLogRegistry::setRules(ruleSets[round % 2]));
+    if (round % 64 == 0) std::this_thread::yield();
+  }
+  running = false;
+  for (std::thread& t : threads) t.join();
+
+  std::string text = lines.text();
+  CHECK(calls.load() > 0);
+  CHECK(text.find("| app debug") == std::string::npos);
+  CHECK(text.find("| imu info") == std::string::npos);
+  CHECK(text.find("| tmp debug 0") == std::string::npos);                                               // app.tmp: "*=warn" or "app=info"
+  CHECK_STR(text, "| radio debug");
+  CHECK_STR(text, "| app info");
+
+  CHECK(ChronoLogRegistry::setRules(ruleSets[0]));
+  CHECK_EQ(radio.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+  CHECK_EQ(mqtt.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+  CHECK_EQ(app.currentLevel(), CHRONOLOG_LEVEL_WARN);
+  CHECK_EQ(imu.currentLevel(), CHRONOLOG_LEVEL_WARN);
+  CHECK(listed("net.radio") && listed("app") && listed("sensors.imu"));
+  CHECK(!listed("net.tmp") && !listed("app.tmp"));                                                      // Gone with their scope
+}
+
+// Without rules every logger is back at its own level; setLevel() then applies at once.
+static void clearingRulesRestoresOwnLevels() {
+  ChronoLogRegistry::clearRules();
+  CHECK_EQ(imu.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+  CHECK_EQ(app.currentLevel(), CHRONOLOG_LEVEL_DEBUG);
+  app.setLevel(CHRONOLOG_LEVEL_FATAL);
+  CHECK_EQ(app.currentLevel(), CHRONOLOG_LEVEL_FATAL);
+  CHECK(!ChronoLogRegistry::setRules("net.*=loud"));                                                    // Rejected, nothing changes
+  CHECK_EQ(app.currentLevel(), CHRONOLOG_LEVEL_FATAL);
+}
+
+// Two threads set different rules over many loggers: whichever call comes last decides every level,
+// with no logger left at what the other call gave it.
+static void concurrentRulesAgree() {
+  std::vector<std::unique_ptr<Logger>> extra;
+  for (int i = 0; i < 64; i++) {
+    extra.emplace_back(new Logger("net.extra"));
+    extra.back()->currentLevel();                                                                       // Registered
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 2; t++) {
+    threads.emplace_back([t] {
+      for (int round = 0; round < 300; round++) CHECK(ChronoLogRegistry::setRules(ruleSets[t]));
+    });
+  }
+  for (std::thread& t : threads) t.join();
+
+  bool first = radio.currentLevel() == CHRONOLOG_LEVEL_DEBUG;                                           // ruleSets[0] came last
+  CHECK_EQ(radio.currentLevel(), first ? CHRONOLOG_LEVEL_DEBUG : CHRONOLOG_LEVEL_ERROR);
+  CHECK_EQ(mqtt.currentLevel(), first ? CHRONOLOG_LEVEL_DEBUG : CHRONOLOG_LEVEL_ERROR);
+  CHECK_EQ(app.currentLevel(), first ? CHRONOLOG_LEVEL_WARN : CHRONOLOG_LEVEL_INFO);
+  for (const std::unique_ptr<Logger>& l : extra) CHECK_EQ(l->currentLevel(), radio.currentLevel());
+  extra.clear();
+  CHECK(!listed("net.extra"));
+}
+
+// Threads that use a new logger at the same moment register it once, at the level the rules give.
+static void firstUseRegistersOnce() {
+  CHECK(ChronoLogRegistry::setRules(ruleSets[1]));
+  for (int round = 0; round < 100; round++) {
+    Logger fresh("net.fresh");
+    std::atomic<int> ready{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+      threads.emplace_back([&] {
+        ready++;
+        while (ready.load() < 4) std::this_thread::yield();
+        CHECK_EQ(fresh.currentLevel(), CHRONOLOG_LEVEL_ERROR);
+      });
+    }
+    for (std::thread& t : threads) t.join();
+    CHECK_EQ(entries("net.fresh"), 1u);
+  }
+  CHECK(!listed("net.fresh"));
+}
+
+int main() {
+  RUN(rulesChangeWhileLogging);
+  RUN(concurrentRulesAgree);
+  RUN(firstUseRegistersOnce);
+  RUN(clearingRulesRestoresOwnLevels);
+  return TEST_RESULT();
+}
@@ -0,0 +1,201 @@
+// Sampling macros (ChronoLogSample): which calls of a site are written, from one thread and from
+// several hammering the same site. CHRONOLOG_EVERY_N and CHRONOLOG_FIRST_N must stay exact under
+// contention, CHRONOLOG_EVERY_MS must never write twice in one window, and CHRONOLOG_ON_CHANGE must
+// write a change once even when several threads see it at the same time, compare values exactly
+// (no two values whose 32-bit hash collides are taken for each other) and write every value too
+// long to keep.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+static MockSink lines;
+
+struct LineSink {                                                                                       // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { lines.write(data, len); }
+};
+
+static ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, LineSink, ChronoLogPrintf> logger("imu");
+
+struct Blob {                                                                                           // One byte more than a site keeps
+  char bytes[CHRONOLOG_CHANGE_VALUE_LEN + 1];
+};
+
+// One call site each, shared by every thread that calls it.
+static void everyTenth(int i)                  { CHRONOLOG_EVERY_N(logger, CHRONOLOG_LEVEL_DEBUG, 10, "n %d", i); }
+static void everySeventh(int i)                { CHRONOLOG_EVERY_N(logger, CHRONOLOG_LEVEL_DEBUG, 7, "n %d", i); }
+static void firstFifty(int i)                  { CHRONOLOG_FIRST_N(logger, CHRONOLOG_LEVEL_WARN, 50, "n %d", i); }
+static void every50Ms(int i)                   { CHRONOLOG_EVERY_MS(logger, CHRONOLOG_LEVEL_INFO, 50, "n %d", i); }
+static void onChange(int mode)                 { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_INFO, mode, "mode %d", mode); }
+static void onChangeShared(int mode)           { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_INFO, mode, "mode %d", mode); }
+static void onChangeText(const char* state)    { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_INFO, state, "state %s", state ? state : "-"); }
+static void onChangeWide(unsigned long long v) { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_INFO, v, "v %llu", v); }
+static void onChangeBlob(const Blob& b)        { CHRONOLOG_ON_CHANGE(logger, CHRONOLOG_LEVEL_INFO, b, "blob %c", b.bytes[0]); }
+
+template <typename Body>
+static void hammer(int threads, Body body) {
+  std::atomic<int> ready{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      ready++;
+      while (ready.load() < threads) std::this_thread::yield();
+      body(t);
+    });
+  }
+  for (std::thread& w : workers) w.join();
+}
+
+static std::vector<int> numbers() {                                                                     // The %d after "| n " of every line
+  std::vector<int> out;
+  for (const std::string& line : lines.lines) {
+    size_t at = line.rfind("| n ");
+    if (at != std::string::npos) out.push_back(atoi(line.c_str() + at + 4));
+  }
+  return out;
+}
+
+static void everyNWritesEveryTenthCall() {
+  lines.clear();
+  for (int i = 0; i < 1000; i++) everyTenth(i);
+  std::vector<int> written = numbers();
+  CHECK_EQ(written.size(), 100u);
+  for (size_t k = 0; k < written.size(); k++) CHECK_EQ(written[k], (int)k * 10);
+}
+
+// The count only advances while the level is enabled: the site is due, and stays due.
+static void disabledCallsAreNotCounted() {
+  lines.clear();
+  logger.setLevel(CHRONOLOG_LEVEL_INFO);
+  for (int i = 0; i < 5; i++) everyTenth(i);
+  logger.setLevel(CHRONOLOG_LEVEL_DEBUG);
+  everyTenth(5);
+  CHECK_EQ(lines.count(), 1u);
+}
+
+static void everyNIsExactUnderContention() {
+  lines.clear();
+  const int threads = 4, perThread = 10000;
+  hammer(threads, [](int) {
+    for (int i = 0; i < perThread; i++) everySeventh(i);
+  });
+  CHECK_EQ(lines.count(), (size_t)((threads * perThread + 6) / 7));
+}
+
+static void firstNIsExactUnderContention() {
+  lines.clear();
+  hammer(8, [](int) {
+    for (int i = 0; i < 1000; i++) firstFifty(i);
+  });
+  CHECK_EQ(lines.count(), 50u);
+  for (int i = 0; i < 100; i++) firstFifty(i);                                                          // Stays saturated
+  CHECK_EQ(lines.count(), 50u);
+}
+
+// At most one line per 50 ms window, whichever thread gets there first.
+static void everyMsKeepsItsWindowUnderContention() {
+  lines.clear();
+  auto start = std::chrono::steady_clock::now();
+  hammer(4, [start](int t) {
+    for (int i = 0; std::chrono::steady_clock::now() - start < std::chrono::milliseconds(250); i++) every50Ms(t * 1000000 + i);
+  });
+  double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  size_t n = lines.count();
+  CHECK(n >= 2);
+  CHECK(n <= (size_t)(elapsed / 50) + 1);
+}
+
+static void onChangeWritesChangesOnly() {
+  lines.clear();
+  const int modes[] = {0, 0, 1, 1, 1, 0, 2, 2, 0};                                                      // 0 first: logged though nothing came before
+  for (int mode : modes) onChange(mode);
+  CHECK_EQ(lines.count(), 5u);
+  CHECK_STR(lines.text(), "mode 0");
+
+  char buf[8] = "idle";
+  lines.clear();
+  onChangeText("idle");
+  onChangeText(buf);                                                                                    // Same text, other buffer
+  buf[0] = 'I';
+  onChangeText(buf);
+  onChangeText("busy");
+  onChangeText("busy");
+  CHECK_EQ(lines.count(), 3u);
+}
+
+// FNV-1a over the eight bytes of v, the kind of hash a site could have kept instead of the value.
+static uint32_t fnv(unsigned long long v) {
+  const uint8_t* p = (const uint8_t*)&v;
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < sizeof(v); i++) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+// Two values with the same 32-bit hash, alternated: each call is a change and is written.
+static void onChangeComparesExactly() {
+  std::unordered_map<uint32_t, unsigned long long> seen;
+  unsigned long long x = 0, y = 0;
+  for (unsigned long long i = 1; i < (1ull << 24); i++) {
+    unsigned long long v = i * 0x9E3779B97F4A7C15ull;                                                   // Spread over all eight bytes
+    auto ins = seen.emplace(fnv(v), v);
+    if (!ins.second) {
+      x = ins.first->second;
+      y = v;
+      break;
+    }
+  }
+  CHECK(y != 0);
+  lines.clear();
+  onChangeWide(x);
+  onChangeWide(y);
+  onChangeWide(x);
+  CHECK_EQ(lines.count(), 3u);
+
+  lines.clear();
+  onChangeText(nullptr);
+  onChangeText("");
+  onChangeText(nullptr);
+  onChangeText(nullptr);
+  CHECK_EQ(lines.count(), 3u);
+}
+
+static void valuesTooLongToKeepAreAlwaysWritten() {
+  Blob b;
+  memset(b.bytes, 'a', sizeof(b.bytes));
+  lines.clear();
+  for (int i = 0; i < 5; i++) onChangeBlob(b);
+  CHECK_EQ(lines.count(), 5u);
+
+  std::string text(CHRONOLOG_CHANGE_VALUE_LEN + 10, 'x');
+  lines.clear();
+  for (int i = 0; i < 5; i++) onChangeText(text.c_str());
+  onChangeText("short");
+  onChangeText("short");
+  CHECK_EQ(lines.count(), 6u);
+}
+
+// Every thread sees the same change at the same time: one of them writes it.
+static void onChangeWritesOnceUnderContention() {
+  for (int round = 0; round < 200; round++) {
+    lines.clear();
+    hammer(4, [round](int) { onChangeShared(round); });
+    CHECK_EQ(lines.count(), 1u);
+    if (lines.count() != 1) break;
+  }
+}
+
+int main() {
+  RUN(everyNWritesEveryTenthCall);
+  RUN(disabledCallsAreNotCounted);
+  RUN(everyNIsExactUnderContention);
+  RUN(firstNIsExactUnderContention);
+  RUN(everyMsKeepsItsWindowUnderContention);
+  RUN(onChangeWritesChangesOnly);
+  RUN(onChangeComparesExactly);
+  RUN(valuesTooLongToKeepAreAlwaysWritten);
+  RUN(onChangeWritesOnceUnderContention);
+  return TEST_RESULT();
+}
@@ -0,0 +1,241 @@
+// Sink fan-out (ChronoLogSinks) to three mock sinks at DEBUG, WARN and ERROR next to the transport.
+// Text build: each output gets the lines of its level, loggers are capped at the most verbose one,
+// and a sink that refuses loses lines only for itself. Binary build (test_sinks_binary): every
+// sink's byte stream decodes on its own, although string ids are defined by whichever line used a
+// string first, at any level; that holds when a sink refused the definitions or was added late.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <map>
+
+static ChronoLogger logger("fan");
+
+static MockSink ram, uart, crit;
+static const ChronoLogSink ramSink  = {MockSink::entry, nullptr, &ram};
+static const ChronoLogSink uartSink = {MockSink::entry, nullptr, &uart};
+static const ChronoLogSink critSink = {MockSink::entry, nullptr, &crit};
+
+static void addThree() {
+  ram.clear();
+  uart.clear();
+  crit.clear();
+  ChronoLogSinks::add(ramSink, CHRONOLOG_LEVEL_DEBUG);
+  ChronoLogSinks::add(uartSink, CHRONOLOG_LEVEL_WARN);
+  ChronoLogSinks::add(critSink, CHRONOLOG_LEVEL_ERROR);
+}
+
+static void removeThree() {
+  ChronoLogSinks::remove(ramSink);
+  ChronoLogSinks::remove(uartSink);
+  ChronoLogSinks::remove(critSink);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_DEBUG);
+}
+
+#if !CHRONOLOG_BINARY
+static void eachOutputGetsItsLevels() {
+  addThree();
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_INFO);
+  StdoutCapture capture;
+  logger.debug("d");
+  logger.info("i");
+  logger.warn("w");
+  logger.error("e");
+  logger.fatal("f");
+  std::string out = capture.take();
+  capture.restore();
+
+  CHECK_EQ(ram.count(), 5u);
+  CHECK_EQ(uart.count(), 3u);
+  CHECK_EQ(crit.count(), 2u);
+  CHECK_EQ(countLines(out), 4u);
+  CHECK_STR(ram.text(), "| d\n");
+  CHECK_STR(uart.text(), "| w\n");
+  CHECK(crit.text().find("| w\n") == std::string::npos);
+  CHECK(out.find("| d\n") == std::string::npos);
+  removeThree();
+}
+
+// With the DEBUG sink gone nobody takes DEBUG: the logger is capped and a lazy argument never runs.
+static void loggersAreCappedAtTheMostVerboseOutput() {
+  addThree();
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_INFO);
+  StdoutCapture capture;
+  int evaluated = 0;
+  auto lazy = [&] {
+    evaluated++;
+    return "lazy";
+  };
+  ChronoLogSinks::remove(ramSink);
+  CHECK_EQ(ChronoLogSinks::ceiling(), CHRONOLOG_LEVEL_INFO);
+  CHECK_EQ(logger.currentLevel(), CHRONOLOG_LEVEL_INFO);
+  logger.debug(lazy);
+  CHECK_EQ(evaluated, 0);
+  ChronoLogSinks::add(ramSink, CHRONOLOG_LEVEL_DEBUG);
+  logger.debug(lazy);
+  CHECK_EQ(evaluated, 1);
+  CHECK_EQ(ram.count(), 1u);
+  capture.restore();
+  removeThree();
+}
+
+static void refusingSinkLosesItsOwnLines() {
+  addThree();
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+  uart.accept = false;
+  for (int i = 0; i < 10; i++) logger.error("burst %d", i);
+  uart.accept = true;
+  CHECK_EQ(ChronoLogSinks::dropped(uartSink), 10u);
+  CHECK_EQ(ChronoLogSinks::dropped(ramSink), 0u);
+  CHECK_EQ(ram.count(), 10u);
+  CHECK_EQ(crit.count(), 10u);
+
+  ChronoLogSinks::setLevel(critSink, CHRONOLOG_LEVEL_FATAL);                                           // Only this sink changes
+  logger.error("after");
+  CHECK_EQ(crit.count(), 10u);
+  CHECK_EQ(uart.count(), 1u);
+  removeThree();
+}
+#else
+// What one sink received, read the way chronolog_decode reads it.
+struct Stream {
+  std::map<int, size_t> logs;                                                                           // LOG frames per level
+  size_t                unresolved = 0;                                                                 // Table refs with no DEF before them
+  size_t                wrong      = 0;                                                                 // Format that does not match its argument
+  size_t                garbage    = 0;
+};
+
+struct Reader {
+  const uint8_t* p;
+  const uint8_t* end;
+
+  uint64_t varint() {
+    uint64_t v = 0;
+    for (int shift = 0; p < end; shift += 7) {
+      uint8_t b = *p++;
+      v |= (uint64_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) break;
+    }
+    return v;
+  }
+};
+
+static Stream decode(const std::string& bytes) {
+  Stream s;
+  std::map<uint64_t, std::string> strings;
+  const uint8_t* d = (const uint8_t*)bytes.data();
+  size_t p = 0;
+  while (p < bytes.size()) {
+    if (bytes.size() - p < 4 || d[p] != ChronoLogBinary::SYNC) {
+      s.garbage++;
+      break;
+    }
+    size_t n = (size_t)((d[p + 1] & 0x7F) | (d[p + 2] & 0x7F) << 7);
+    Reader r = {d + p + 4, d + p + 3 + n};
+    uint8_t type = d[p + 3];
+    p += 3 + n;
+    if (type == ChronoLogBinary::FRAME_DEF) {
+      uint64_t id = r.varint();
+      strings[id].assign((const char*)r.p, (size_t)(r.end - r.p));
+      continue;
+    }
+    int level = *r.p++ & ~ChronoLogBinary::LEVEL_TRUNCATED;
+    r.varint();                                                                                         // Second of day
+    std::string text[3];
+    for (std::string& t : text) {
+      uint64_t ref = r.varint();
+      uint64_t tag = ref & 3;
+      if (tag == ChronoLogBinary::REF_TABLE) {
+        if (strings.count(ref >> 2)) t = strings[ref >> 2];
+        else                         s.unresolved++;
+      } else if (tag == ChronoLogBinary::REF_INLINE) {
+        t.assign((const char*)r.p, (size_t)(ref >> 2));
+        r.p += ref >> 2;
+      }
+    }
+    s.logs[level]++;
+    if (text[0] != "fan") s.wrong++;
+    int64_t arg = (int64_t)(r.varint() >> 1);                                                           // "f<j> %d" with j * 1000 + i
+    char want[16];
+    snprintf(want, sizeof(want), "f%d %%d", (int)(arg / 1000));
+    if (text[2].compare(0, std::string::npos, want) != 0) s.wrong++;
+  }
+  return s;
+}
+
+static const char* const formats[] = {"f0 %d", "f1 %d", "f2 %d", "f3 %d", "f4 %d", "f5 %d"};
+
+// Line i uses format i % 6 at level i % 5 + 1, so every format is first used at some level one of
+// the sinks does not take.
+static void logMixed(int lines, int offset = 0) {
+  for (int i = 0; i < lines; i++) {
+    int j = (i + offset) % 6;
+    logger.log((ChronoLogLevel)((i + offset) % 5 + 1), formats[j], j * 1000 + i);
+  }
+}
+
+static void checkStream(MockSink& sink, ChronoLogLevel level, int lines) {
+  Stream s = decode(sink.text());
+  size_t total = 0;
+  for (const auto& entry : s.logs) {
+    CHECK(entry.first <= level);
+    total += entry.second;
+  }
+  CHECK_EQ(total, (size_t)(lines * level / 5));
+  CHECK_EQ(s.unresolved, 0u);
+  CHECK_EQ(s.wrong, 0u);
+  CHECK_EQ(s.garbage, 0u);
+}
+
+static void everySinkDecodesOnItsOwn() {
+  addThree();
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+  logMixed(100);
+  checkStream(ram, CHRONOLOG_LEVEL_DEBUG, 100);
+  checkStream(uart, CHRONOLOG_LEVEL_WARN, 100);
+  checkStream(crit, CHRONOLOG_LEVEL_ERROR, 100);
+  removeThree();
+}
+
+// A sink that refuses a definition makes every string be defined again, so it still decodes once
+// it takes lines again.
+static void refusedDefinitionsAreSentAgain() {
+  addThree();
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+  crit.accept = false;
+  logMixed(10);
+  crit.accept = true;
+  logMixed(100, 10);
+  Stream s = decode(crit.text());
+  CHECK(s.logs[CHRONOLOG_LEVEL_ERROR] > 0);
+  CHECK_EQ(s.unresolved, 0u);
+  CHECK_EQ(s.wrong, 0u);
+  removeThree();
+}
+
+// A sink added after the strings were defined gets them defined again.
+static void lateSinkGetsDefinitions() {
+  addThree();
+  ChronoLogSinks::remove(critSink);
+  ChronoLogSinks::setTransportLevel(CHRONOLOG_LEVEL_NONE);
+  logMixed(30);
+  crit.clear();
+  ChronoLogSinks::add(critSink, CHRONOLOG_LEVEL_ERROR);
+  logMixed(30);
+  checkStream(crit, CHRONOLOG_LEVEL_ERROR, 30);
+  removeThree();
+}
+#endif
+
+int main() {
+#if !CHRONOLOG_BINARY
+  RUN(eachOutputGetsItsLevels);
+  RUN(loggersAreCappedAtTheMostVerboseOutput);
+  RUN(refusingSinkLosesItsOwnLines);
+#else
+  RUN(everySinkDecodesOnItsOwn);
+  RUN(refusedDefinitionsAreSentAgain);
+  RUN(lateSinkGetsDefinitions);
+#endif
+  return TEST_RESULT();
+}
@@ -0,0 +1,188 @@
+// CHRONOLOG_SUPPRESS: identical calls collapse into "last message repeated N times", different ones
+// never do (not even when a 32-bit hash of their arguments would collide), and CHRONOLOG_LIMIT()
+// sites keep to their budget and report what they refused. Built with CHRONOLOG_REPEAT_FLUSH_MS=20.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+static MockSink lines;
+
+struct LineSink {                                                                                       // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { lines.write(data, len); }
+};
+
+typedef ChronoLoggerT<ChronoLogSteadyClock, ChronoLogThreadName, LineSink, ChronoLogPrintf> Logger;
+
+static Logger logger("bus");
+
+// Lines written apart from summaries, and the calls the summaries stand for.
+struct Tally {
+  size_t   written   = 0;
+  uint32_t repeated  = 0;
+  size_t   summaries = 0;
+};
+
+static Tally tally(const char* text) {
+  Tally t;
+  for (const std::string& line : lines.lines) {
+    unsigned long n = 0;
+    size_t at = line.find("last message repeated ");
+    if (at != std::string::npos && sscanf(line.c_str() + at, "last message repeated %lu times", &n) == 1) {
+      t.repeated += (uint32_t)n;
+      t.summaries++;
+    } else if (line.find(text) != std::string::npos) {
+      t.written++;
+    }
+  }
+  return t;
+}
+
+// A line of its own first, so a summary still pending from the previous test is written and cleared.
+static void begin(const char* test) {
+  logger.info("start of %s", test);
+  lines.clear();
+}
+
+static void identicalCallsCollapse() {
+  begin(__func__);
+  for (int i = 0; i < 1000; i++) logger.error("i2c timeout on %d", 0x40);
+  logger.info("done");
+  CHECK_EQ(lines.count(), 3u);
+  CHECK_STR(lines.lines[1], "last message repeated 999 times");
+  CHECK_STR(lines.lines[1], "ERROR");                                                                   // At the level of the repeated call
+  CHECK_STR(lines.lines[2], "| done");
+}
+
+static void differentCallsAreWritten() {
+  char a[8] = "abc", b[8] = "abc";
+  begin(__func__);
+  logger.info("v %d", 1);
+  logger.info("v %d", 2);
+  logger.info("v %d", 2);                                                                               // Repeat
+  logger.warn("v %d", 2);                                                                               // Same values, other level
+  logger.warn("f %.3f", 0.1);
+  logger.warn("f %.3f", 0.1 + 1e-12);                                                                   // Equal once printed, different values
+  logger.warn("s %s", a);
+  logger.warn("s %s", b);                                                                               // Same text in another buffer: repeat
+  b[2] = 'd';
+  logger.warn("s %s", b);
+  logger.warn("s %s", (const char*)nullptr);
+  logger.warn("s %s", "");
+  logger.info("done");
+  Tally t = tally("|");
+  CHECK_EQ(t.repeated, 2u);
+  CHECK_EQ(t.written, 10u);
+}
+
+// FNV-1a step over the bytes of a value.
+template <typename T>
+static uint32_t mix(uint32_t h, const T& value) {
+  const uint8_t* p = (const uint8_t*)&value;
+  for (size_t i = 0; i < sizeof(T); i++) h = (h ^ p[i]) * 16777619u;
+  return h;
+}
+
+// Two argument values whose hash over the logger, level and format address matches: with a
+// hash-keyed comparison the second line would have been counted as a repeat of the first.
+static void hashCollisionsAreWritten() {
+  static const char* const fmt = "value %llu";
+  uint32_t seed = mix(mix(logger.id(), (uint8_t)CHRONOLOG_LEVEL_ERROR), (const void*)fmt);
+  std::unordered_map<uint32_t, unsigned long long> seen;
+  unsigned long long x = 0, y = 0;
+  for (unsigned long long i = 1; i < (1ull << 24); i++) {
+    unsigned long long v = i * 0x9E3779B97F4A7C15ull;                                                   // Spread over all eight bytes
+    auto ins = seen.emplace(mix(seed, v), v);
+    if (!ins.second) {
+      x = ins.first->second;
+      y = v;
+      break;
+    }
+  }
+  CHECK(y != 0);
+  begin(__func__);
+  logger.error(fmt, x);
+  logger.error(fmt, y);
+  CHECK_EQ(lines.count(), 2u);
+  CHECK(lines.text().find("last message repeated") == std::string::npos);
+}
+
+// Keys that do not fit CHRONOLOG_REPEAT_KEY_LEN are never compared, so every call is written.
+static void longArgumentsAreAlwaysWritten() {
+  std::string payload(CHRONOLOG_REPEAT_KEY_LEN + 10, 'x');
+  begin(__func__);
+  for (int i = 0; i < 5; i++) logger.info("blob %s", payload.c_str());
+  CHECK_EQ(lines.count(), 5u);
+}
+
+static void collapsingCanBeTurnedOff() {
+  begin(__func__);
+  logger.collapseRepeats(false);
+  for (int i = 0; i < 10; i++) logger.info("same");
+  logger.collapseRepeats(true);
+  CHECK_EQ(lines.count(), 10u);
+}
+
+static void longRunsAreSummarisedPeriodically() {
+  begin(__func__);
+  int calls = 0;
+  auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  while (std::chrono::steady_clock::now() < until) {
+    logger.warn("fan stalled");
+    calls++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  size_t before = tally("fan stalled").summaries;                                                       // Written while the run went on
+  logger.info("done");
+  Tally t = tally("fan stalled");
+  CHECK(before >= 2);
+  CHECK_EQ(t.written, 1u);
+  CHECK_EQ(t.written + t.repeated, (size_t)calls);
+}
+
+// From several threads every call is either written or counted in a summary, never lost.
+static void threadsAccountForEveryCall() {
+  begin(__func__);
+  const int threads = 4, perThread = 20000;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([] {
+      for (int i = 0; i < perThread; i++) logger.warn("link down");
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  logger.info("done");
+  Tally t = tally("link down");
+  CHECK_EQ(t.written + t.repeated, (size_t)(threads * perThread));
+  CHECK(t.written < (size_t)(threads * perThread) / 2);                                                // Mostly collapsed
+}
+
+static void tick(int i) { CHRONOLOG_LIMIT(logger, CHRONOLOG_LEVEL_ERROR, "tick %d", i); }                 // One site
+
+static void rateLimitedSite() {
+  begin(__func__);
+  logger.setRateLimit(10, 5);                                                                           // One line per 100 ms, bursts of 5
+  for (int i = 0; i < 50; i++) tick(i);
+  CHECK_EQ(lines.count(), 5u);
+  std::this_thread::sleep_for(std::chrono::milliseconds(120));
+  tick(50);
+  CHECK_EQ(lines.count(), 7u);
+  CHECK_STR(lines.lines[5], "rate limit: 45 messages suppressed");
+  CHECK_STR(lines.lines[6], "| tick 50");
+  logger.setRateLimit(CHRONOLOG_LIMIT_RATE, CHRONOLOG_LIMIT_BURST);
+}
+
+int main() {
+  RUN(identicalCallsCollapse);
+  RUN(differentCallsAreWritten);
+  RUN(hashCollisionsAreWritten);
+  RUN(longArgumentsAreAlwaysWritten);
+  RUN(collapsingCanBeTurnedOff);
+  RUN(longRunsAreSummarisedPeriodically);
+  RUN(threadsAccountForEveryCall);
+  RUN(rateLimitedSite);
+  return TEST_RESULT();
+}
@@ -0,0 +1,170 @@
+// Task column cache (ChronoLogTaskField): every thread sees its own name, renamed() is picked up on
+// the next line, and short-lived threads do not use up slots. Built for the host (thread_local,
+// pthread names) and against mock/freertos as an STM32 FreeRTOS project, where the slot is a pooled
+// entry behind TLS pointer CHRONOLOG_TASK_TLS_INDEX, given back by taskExiting() or by the TLS
+// delete callback.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <atomic>
+#include <thread>
+
+static MockSink lines;
+
+struct LineSink {                                                                                       // Sink policy feeding the static mock
+  static void write(ChronoLogLevel, ChronoLogTarget, const char* data, size_t len) { lines.write(data, len); }
+};
+
+static ChronoLoggerT<ChronoLogTimeColumn, ChronoLogTaskField, LineSink, ChronoLogPrintf> logger("task");
+
+#if defined(CHRONOLOG_STM32_FREERTOS)
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef*) {}                                                   // Required by mock/stm32, no UART here
+
+static void nameThread(const char* name) { mock_task_name(name); }
+
+static void endThread() {                                                                               // What a task does before vTaskDelete(NULL)
+  #if !configTHREAD_LOCAL_STORAGE_DELETE_CALLBACKS
+    ChronoLogger::taskExiting();
+  #endif
+  mock_task_delete();
+}
+
+static bool hasSlot() { return pvTaskGetThreadLocalStoragePointer(NULL, CHRONOLOG_TASK_TLS_INDEX) != nullptr; }
+#else
+static void nameThread(const char* name) { pthread_setname_np(pthread_self(), name); }
+static void endThread() { ChronoLogger::taskExiting(); }
+static bool hasSlot() { return true; }
+#endif
+
+static std::string column() {
+  ChronoLogTaskField::Field scratch;
+  const ChronoLogTaskField::Field& field = ChronoLogTaskField::current(scratch);
+  return std::string(field.text, field.len);
+}
+
+static std::string padded(const char* name) {
+  std::string text(name);
+  if (text.size() < ChronoLogTaskField::WIDTH) text.resize(ChronoLogTaskField::WIDTH, ' ');
+  return text;
+}
+
+// Threads named at the same time, each checked many times while the others run.
+static void eachThreadSeesItsOwnName() {
+  const int threads = 6;
+  std::atomic<int> ready{0};
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      char name[16];
+      snprintf(name, sizeof(name), "worker-%d", t);
+      nameThread(name);
+      ready++;
+      while (ready.load() < threads) std::this_thread::yield();
+      for (int i = 0; i < 2000; i++) {
+        if (column() != padded(name)) wrong++;
+      }
+      endThread();
+    });
+  }
+  for (std::thread& w : workers) w.join();
+  CHECK_EQ(wrong.load(), 0);
+}
+
+// The copy is kept until taskRenamed(), then rebuilt once.
+static void renameIsPickedUp() {
+  std::thread([] {
+    nameThread("before");
+    CHECK(column() == padded("before"));
+    nameThread("after");
+    CHECK(column() == padded("before"));                                                                // Still the cached copy
+    ChronoLogger::taskRenamed();
+    CHECK(column() == padded("after"));
+
+    lines.clear();
+    logger.info("renamed");
+    CHECK_EQ(lines.count(), 1u);
+    CHECK_STR(lines.text(), padded("after").c_str());
+    endThread();
+  }).join();
+}
+
+// Far more threads than slots, one after another: every one of them still gets a slot.
+static void shortLivedThreadsReuseSlots() {
+  int wrong = 0, slotless = 0;
+  for (int t = 0; t < 20 * CHRONOLOG_TASK_SLOTS; t++) {
+    std::thread([&, t] {
+      char name[16];
+      snprintf(name, sizeof(name), "short-%d", t);
+      nameThread(name);
+      if (column() != padded(name)) wrong++;
+      if (!hasSlot()) slotless++;
+      endThread();
+    }).join();
+  }
+  CHECK_EQ(wrong, 0);
+  CHECK_EQ(slotless, 0);
+}
+
+#if defined(CHRONOLOG_STM32_FREERTOS)
+// Before the scheduler starts there is only main(); tasks past the pool look their name up per line.
+static void poolRunsOut() {
+  mock_scheduler = false;
+  CHECK(column() == padded("MainTask"));
+  mock_scheduler = true;
+
+  const int threads = CHRONOLOG_TASK_SLOTS + 3;
+  std::atomic<int> named{0}, slotted{0}, wrong{0};
+  std::atomic<bool> done{false};
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      char name[16];
+      snprintf(name, sizeof(name), "held-%d", t);
+      nameThread(name);
+      if (column() != padded(name)) wrong++;
+      if (hasSlot()) slotted++;
+      named++;
+      while (!done.load()) std::this_thread::yield();
+      if (column() != padded(name)) wrong++;
+      endThread();
+    });
+  }
+  while (named.load() < threads) std::this_thread::yield();
+  CHECK_EQ(slotted.load(), CHRONOLOG_TASK_SLOTS);
+  done = true;
+  for (std::thread& w : workers) w.join();
+  CHECK_EQ(wrong.load(), 0);
+}
+
+// Only CHRONOLOG_TASK_TLS_INDEX is used; the application's own TLS pointers are left alone.
+static void otherTlsSlotsUntouched() {
+  std::thread([] {
+    int mine = 0;
+    const int other = CHRONOLOG_TASK_TLS_INDEX == 0 ? 1 : 0;
+    vTaskSetThreadLocalStoragePointer(NULL, other, &mine);
+    nameThread("tls");
+    CHECK(column() == padded("tls"));
+    CHECK(pvTaskGetThreadLocalStoragePointer(NULL, other) == &mine);
+    CHECK(hasSlot());
+    endThread();
+  }).join();
+}
+#endif
+
+int main() {
+#if defined(CHRONOLOG_STM32_FREERTOS)
+  static UART_HandleTypeDef uart;                                                                       // STM32 loggers write nothing without one
+  logger.setUartHandler(&uart);
+  mock_scheduler = true;
+#endif
+  RUN(eachThreadSeesItsOwnName);
+  RUN(renameIsPickedUp);
+  RUN(shortLivedThreadsReuseSlots);
+#if defined(CHRONOLOG_STM32_FREERTOS)
+  RUN(poolRunsOut);
+  RUN(otherTlsSlotsUntouched);
+#endif
+  return TEST_RESULT();
+}
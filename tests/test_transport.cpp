@@ -0,0 +1,118 @@
+// Shared transport under contention: 16 threads log through the default ChronoLogger into a pipe on
+// fd 1, with lines longer than PIPE_BUF mixed in so the kernel splits their writes. Every line must
+// arrive whole and exactly once. Also reports what the lock costs: ns per line from 1 and from 16
+// threads, and how many writes found it held.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <map>
+#include <thread>
+
+static ChronoLogger logger("torn");
+
+// fd 1 redirected into a pipe drained by a reader that takes small bites, so long writes block
+// part way and resume.
+struct PipeCapture {
+  int         fds[2];
+  int         saved;
+  std::string out;
+  std::thread reader;
+
+  PipeCapture() {
+    fflush(stdout);
+    saved = dup(1);
+    if (pipe(fds) != 0) abort();
+    dup2(fds[1], 1);
+    reader = std::thread([this] {
+      char chunk[512];
+      ssize_t n;
+      while ((n = read(fds[0], chunk, sizeof(chunk))) > 0) out.append(chunk, (size_t)n);
+    });
+  }
+
+  std::string finish() {
+    dup2(saved, 1);
+    close(saved);
+    close(fds[1]);
+    reader.join();
+    close(fds[0]);
+    return out;
+  }
+};
+
+// Payload of line i from thread t: short, or longer than PIPE_BUF, filled with the thread's letter.
+static std::string payload(int t, int i) {
+  return std::string(i % 4 == 0 ? PIPE_BUF + 700 : 40, (char)('a' + t));
+}
+
+static double logFrom(int threads, int perThread) {                                                     // ns per line, wall clock
+  std::vector<std::thread> writers;
+  auto start = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; t++) {
+    writers.emplace_back([t, perThread] {
+      for (int i = 0; i < perThread; i++) logger.info("t%02d n%05d %s end", t, i, payload(t, i).c_str());
+    });
+  }
+  for (std::thread& w : writers) w.join();
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (threads * perThread);
+}
+
+static void sixteenThreadsNoTornLines() {
+  const int threads = 16, perThread = 400;
+  ChronoLogTransport::resetStats();
+  PipeCapture capture;
+  double ns = logFrom(threads, perThread);
+  ChronoLogTransport::Stats stats = ChronoLogTransport::stats();
+  std::string out = capture.finish();
+
+  std::map<std::pair<int, int>, int> seen;
+  size_t torn = 0, pos = 0;
+  while (pos < out.size()) {
+    size_t eol = out.find('\n', pos);
+    if (eol == std::string::npos) eol = out.size();
+    std::string line = out.substr(pos, eol - pos);
+    pos = eol + 1;
+
+    int t = -1, i = -1, used = 0;
+    size_t at = line.rfind("| t");                                                                      // The message, after the module and task columns
+    if (at == std::string::npos || sscanf(line.c_str() + at, "| t%d n%d %n", &t, &i, &used) != 2 || t < 0 || t >= threads) {
+      torn++;
+      continue;
+    }
+    std::string want = payload(t, i) + " end";
+    if (line.compare(at + used, std::string::npos, want) != 0 || line.find(" | torn ") == std::string::npos) {
+      torn++;
+      continue;
+    }
+    seen[{t, i}]++;
+  }
+
+  size_t repeated = 0;
+  for (const auto& entry : seen) repeated += entry.second != 1;
+  CHECK_EQ(torn, 0u);
+  CHECK_EQ(repeated, 0u);
+  CHECK_EQ(seen.size(), (size_t)(threads * perThread));
+  CHECK_EQ(stats.writes, (uint32_t)(threads * perThread));
+  printf("16 threads: %.0f ns/line, %u of %u writes waited for the lock\n", ns, stats.contended, stats.writes);
+}
+
+// The same lines from one thread, for the uncontended cost of the lock and the write.
+static void oneThreadBaseline() {
+  ChronoLogTransport::resetStats();
+  PipeCapture capture;
+  double ns = logFrom(1, 16 * 400);
+  ChronoLogTransport::Stats stats = ChronoLogTransport::stats();
+  std::string out = capture.finish();
+  CHECK_EQ(countLines(out), (size_t)(16 * 400));
+  CHECK_EQ(stats.contended, 0u);
+  printf("1 thread:   %.0f ns/line\n", ns);
+}
+
+int main() {
+  RUN(oneThreadBaseline);
+  RUN(sixteenThreadsNoTornLines);
+  return TEST_RESULT();
+}
@@ -0,0 +1,168 @@
+// STM32 DMA transport (CHRONOLOG_STM32_UART_DMA) against the mocked HAL in mock/stm32: buffers are
+// chained from the completion interrupt, no wait can hang when that interrupt cannot arrive, and
+// completions of other UARTs leave the port slots alone.
+
+#include "ChronoLog.h"
+#include "chronolog_test.h"
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart) { ChronoLogUartTx::txComplete(huart); }
+
+static DMA_HandleTypeDef dma = {1};
+
+static void use(UART_HandleTypeDef& uart) {
+  uart.hdmatx = &dma;
+  mock_uart   = &uart;
+}
+
+static std::string pattern(size_t len) {
+  std::string s;
+  for (size_t i = 0; i < len; i++) s += (char)('a' + i % 26);
+  return s;
+}
+
+static void linesChainBuffers() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  uart.latency = 200;                                                                                   // Slower than logging: lines pile up
+  ChronoLogger logger("uart");
+  logger.setUartHandler(&uart);
+  for (int i = 0; i < 10; i++) logger.info("line %d", i);
+  CHECK(ChronoLogUartTx::get(&uart)->flush());
+  CHECK_EQ(countLines(uart.out), 10);
+  CHECK_STR(uart.out, "line 0\n");
+  CHECK_STR(uart.out, "line 9\n");
+  CHECK(uart.out.find("line 3") < uart.out.find("line 4"));
+  CHECK_EQ(ChronoLogUartTx::get(&uart)->dropped(), 0);
+}
+
+static void shortLinesShareATransfer() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  uart.latency = 200;
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  for (int i = 0; i < 8; i++) port->write("short\n", 6);
+  CHECK(port->flush());
+  CHECK_EQ(countLines(uart.out), 8);
+  CHECK_EQ(uart.starts, 2);                                                                             // First line alone, the rest while it runs
+}
+
+static void fullBuffersWaitForCompletion() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  std::string data = pattern(5 * CHRONOLOG_UART_TX_BUF_LEN);
+  port->write(data.data(), data.size());
+  CHECK(port->flush());
+  CHECK(uart.out == data);
+  CHECK_EQ(port->dropped(), 0);
+}
+
+static void noWaitWithInterruptsMasked() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  std::string data = pattern(3 * CHRONOLOG_UART_TX_BUF_LEN);
+  mock_primask = 1;
+  port->write(data.data(), data.size());                                                                // Would spin forever on busy before
+  mock_primask = 0;
+  CHECK_EQ(port->dropped(), 1);
+  CHECK(port->flush());
+  CHECK_EQ(uart.out.size(), 2 * CHRONOLOG_UART_TX_BUF_LEN);
+  CHECK(uart.out == data.substr(0, uart.out.size()));
+}
+
+static void noWaitInInterrupt() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  std::string data = pattern(3 * CHRONOLOG_UART_TX_BUF_LEN);
+  mock_ipsr = 16 + 5;
+  port->write(data.data(), data.size());
+  mock_ipsr = 0;
+  CHECK_EQ(port->dropped(), 1);
+  CHECK(port->flush());
+  CHECK_EQ(uart.out.size(), 2 * CHRONOLOG_UART_TX_BUF_LEN);
+}
+
+static void stuckUartTimesOut() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  uart.latency = 0;                                                                                     // Completion never comes
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  std::string data = pattern(3 * CHRONOLOG_UART_TX_BUF_LEN);
+  uint32_t before = mock_tick;
+  port->write(data.data(), data.size());
+  CHECK_EQ(port->dropped(), 1);
+  CHECK(mock_tick - before >= CHRONOLOG_UART_TX_WAIT_MS);
+  CHECK(mock_tick - before < CHRONOLOG_UART_TX_WAIT_MS + 10);
+  CHECK(!port->flush());                                                                                // Bounded as well
+
+  uart.latency = 4;                                                                                     // The UART recovers
+  mock_complete(&uart);
+  CHECK(port->flush());
+  CHECK_EQ(uart.out.size(), 2 * CHRONOLOG_UART_TX_BUF_LEN);
+}
+
+static void refusedTransferIsRetried() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  uart.refuse = HAL_BUSY;                                                                               // UART owned by someone else
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  port->write("kept\n", 5);
+  uint32_t before = mock_tick;
+  CHECK(!port->flush());                                                                                // Spun forever before
+  CHECK(mock_tick - before >= CHRONOLOG_UART_TX_WAIT_MS);
+  CHECK(uart.out.empty());
+  CHECK_EQ(port->dropped(), 0);
+
+  uart.refuse = HAL_OK;
+  CHECK(port->flush());
+  CHECK(uart.out == "kept\n");
+}
+
+static void failedTransferIsDropped() {
+  static UART_HandleTypeDef uart;
+  use(uart);
+  uart.refuse = HAL_ERROR;
+  ChronoLogUartTx* port = ChronoLogUartTx::get(&uart);
+  port->write("lost\n", 5);
+  CHECK_EQ(port->dropped(), 1);
+  CHECK(port->flush());                                                                                 // Nothing left to send
+
+  uart.refuse = HAL_OK;
+  port->write("sent\n", 5);
+  CHECK(port->flush());
+  CHECK(uart.out == "sent\n");
+}
+
+// Completions of UARTs that never logged, as many as there are slots, before the log UART's first
+// line: it still gets a port instead of falling back to blocking HAL_UART_Transmit().
+static void otherUartsClaimNoPort() {
+  static UART_HandleTypeDef others[CHRONOLOG_UART_TX_PORTS];
+  for (UART_HandleTypeDef& other : others) ChronoLogUartTx::txComplete(&other);
+  for (UART_HandleTypeDef& other : others) CHECK(ChronoLogUartTx::find(&other) == nullptr);
+
+  static UART_HandleTypeDef uart;
+  use(uart);
+  ChronoLogger logger("uart");
+  logger.setUartHandler(&uart);
+  logger.info("first");
+  ChronoLogUartTx* port = ChronoLogUartTx::find(&uart);
+  CHECK(port != nullptr);
+  if (port) CHECK(port->flush());
+  CHECK(uart.starts >= 1);                                                                              // DMA, not the blocking fallback
+  CHECK_STR(uart.out, "| first\n");
+}
+
+int main() {
+  RUN(otherUartsClaimNoPort);
+  RUN(linesChainBuffers);
+  RUN(shortLinesShareATransfer);
+  RUN(fullBuffersWaitForCompletion);
+  RUN(noWaitWithInterruptsMasked);
+  RUN(noWaitInInterrupt);
+  RUN(stuckUartTimesOut);
+  RUN(refusedTransferIsRetried);
+  RUN(failedTransferIsDropped);
+  return TEST_RESULT();
+}
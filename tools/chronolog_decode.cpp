@@ -0,0 +1,310 @@
+/*
+ ====================================================================================================
+ * File:        chronolog_decode.cpp
+ * Author:      Hamas Saeed
+ * Version:     Rev_1.0.0
+ * Date:        Oct 17 2026
+ * Brief:       Host-side decoder for ChronoLog binary (CHRONOLOG_BINARY) log streams
+ * 
+ ====================================================================================================
+ * License: 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Hamas Saeed
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ * 
+ * For any inquiries, contact Hamas Saeed at hamasaeed@gmail.com
+ *
+ ====================================================================================================
+ */
+
+/*
+ * Usage: chronolog_decode [-e firmware.elf] [-s section] [input]
+ *        chronolog_decode --check-ids -e firmware.elf
+ *
+ * Reads a binary ChronoLog stream from input (stdin by default, e.g. a serial port) and prints
+ * the same text lines the target would print in text mode. Format strings placed with
+ * CHRONOLOG_STR() are looked up in the given ELF image (section "chronolog_fmt" by default).
+ *
+ * With --check-ids the image is checked for distinct strings sharing a CHRONOLOG_ID() instead;
+ * the exit status is 1 when a collision is found.
+ */
+
+#define CHRONOLOG_BINARY 1
+#include "ChronoLog.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+static bool readFile(const char* path, std::vector<uint8_t>& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) out.insert(out.end(), chunk, chunk + n);
+  fclose(f);
+  return true;
+}
+
+template <typename T>
+static T readLe(const std::vector<uint8_t>& data, size_t offset) {
+  T value = 0;
+  for (size_t i = 0; i < sizeof(T) && offset + i < data.size(); i++) value |= (T)data[offset + i] << (8 * i);
+  return value;
+}
+
+// Minimal little-endian ELF32/ELF64 section reader.
+static bool loadSection(const char* path, const char* section, std::vector<uint8_t>& out) {
+  std::vector<uint8_t> elf;
+  if (!readFile(path, elf) || elf.size() < 64 || memcmp(elf.data(), "\x7f" "ELF", 4) != 0 || elf[5] != 1) return false;
+
+  bool   is64      = (elf[4] == 2);
+  size_t shoff     = is64 ? readLe<uint64_t>(elf, 0x28) : readLe<uint32_t>(elf, 0x20);
+  size_t shentsize = readLe<uint16_t>(elf, is64 ? 0x3A : 0x2E);
+  size_t shnum     = readLe<uint16_t>(elf, is64 ? 0x3C : 0x30);
+  size_t shstrndx  = readLe<uint16_t>(elf, is64 ? 0x3E : 0x32);
+
+  auto header = [&](size_t index, uint32_t& name, uint32_t& type, size_t& offset, size_t& size) {
+    size_t at = shoff + index * shentsize;
+    name   = readLe<uint32_t>(elf, at);
+    type   = readLe<uint32_t>(elf, at + 4);
+    offset = is64 ? readLe<uint64_t>(elf, at + 0x18) : readLe<uint32_t>(elf, at + 0x10);
+    size   = is64 ? readLe<uint64_t>(elf, at + 0x20) : readLe<uint32_t>(elf, at + 0x14);
+  };
+
+  uint32_t name, type;
+  size_t   strOffset, strSize;
+  header(shstrndx, name, type, strOffset, strSize);
+
+  for (size_t i = 0; i < shnum; i++) {
+    size_t offset, size;
+    header(i, name, type, offset, size);
+    if (strOffset + name >= elf.size()) continue;
+    if (strcmp((const char*)&elf[strOffset + name], section) != 0) continue;
+    if (type == 8 /* SHT_NOBITS */ || offset + size > elf.size()) return false;
+    out.assign(elf.begin() + offset, elf.begin() + offset + size);
+    out.push_back('\0');
+    return true;
+  }
+  return false;
+}
+
+// Fetches arguments for ChronoLogFmt::render() from a LOG frame payload.
+struct FrameSource {
+  const uint8_t* p;
+  const uint8_t* end;
+  std::string    text;
+
+  uint64_t varint() {
+    uint64_t value = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+      uint8_t b = *p++;
+      value |= (uint64_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) break;
+    }
+    return value;
+  }
+
+  int64_t zigzag() {
+    uint64_t v = varint();
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+  }
+
+  template <typename T> T get() {
+    if constexpr (std::is_same<T, const char*>::value) {
+      size_t n = (size_t)varint();
+      if (n > (size_t)(end - p)) n = (size_t)(end - p);
+      text.assign((const char*)p, n);
+      p += n;
+      return text.c_str();
+    } else if constexpr (std::is_floating_point<T>::value) {
+      double d = 0;
+      if (end - p >= (ptrdiff_t)sizeof(d)) memcpy(&d, p, sizeof(d));
+      p += (end - p >= (ptrdiff_t)sizeof(d)) ? sizeof(d) : (size_t)(end - p);
+      return (T)d;
+    } else if constexpr (std::is_pointer<T>::value) {
+      return (T)(uintptr_t)varint();
+    } else {
+      return (T)zigzag();
+    }
+  }
+};
+
+class Decoder {
+public:
+  std::vector<uint8_t> section;
+
+  void feed(const uint8_t* data, size_t n) {
+    pending.insert(pending.end(), data, data + n);
+    size_t pos = 0;
+    while (pos < pending.size()) {
+      if (pending[pos] != ChronoLogBinary::SYNC) { pos++; continue; }
+      if (pending.size() - pos < 3) break;
+      size_t len = (size_t)(pending[pos + 1] & 0x7F) | ((size_t)(pending[pos + 2] & 0x7F) << 7);
+      if (pending.size() - pos < 3 + len) break;
+      frame(&pending[pos + 3], len);
+      pos += 3 + len;
+    }
+    pending.erase(pending.begin(), pending.begin() + pos);
+  }
+
+private:
+  std::vector<uint8_t>            pending;
+  std::map<uint32_t, std::string> strings;
+
+  std::string ref(FrameSource& src) {
+    uint64_t v     = src.varint();
+    uint32_t value = (uint32_t)(v >> 2);
+    switch (v & 3) {
+      case ChronoLogBinary::REF_TABLE: {
+        auto it = strings.find(value);
+        return (it != strings.end()) ? it->second : "<?" + std::to_string(value) + ">";
+      }
+      case ChronoLogBinary::REF_SECTION:
+        return (value < section.size()) ? std::string((const char*)&section[value]) : "<?fmt>";
+      case ChronoLogBinary::REF_INLINE: {
+        size_t n = (value < (size_t)(src.end - src.p)) ? value : (size_t)(src.end - src.p);
+        std::string s((const char*)src.p, n);
+        src.p += n;
+        return s;
+      }
+      default:
+        return "<?>";
+    }
+  }
+
+  void frame(const uint8_t* payload, size_t len) {
+    if (len == 0) return;
+    FrameSource src{payload + 1, payload + len, std::string()};
+
+    if (payload[0] == ChronoLogBinary::FRAME_DEF) {
+      uint32_t id = (uint32_t)src.varint();
+      strings[id].assign((const char*)src.p, (size_t)(src.end - src.p));
+      return;
+    }
+    if (payload[0] != ChronoLogBinary::FRAME_LOG || src.p >= src.end) return;
+
+    uint8_t  level     = *src.p++;
+    bool     truncated = (level & ChronoLogBinary::LEVEL_TRUNCATED) != 0;
+    uint32_t seconds   = (uint32_t)src.varint();
+    std::string module = ref(src);
+    std::string task   = ref(src);
+    std::string fmt    = ref(src);
+
+    static const char* const names[]  = {"", "FATAL", "ERROR", "WARNING", "INFO", "DEBUG"};
+    static const char* const colors[] = {"", CHRONOLOG_COLOR_FATAL, CHRONOLOG_COLOR_ERROR, CHRONOLOG_COLOR_WARN,
+                                         CHRONOLOG_COLOR_INFO, CHRONOLOG_COLOR_DEBUG};
+    level &= 0x07;
+    if (level > CHRONOLOG_LEVEL_DEBUG) level = CHRONOLOG_LEVEL_DEBUG;
+
+    char message[4096];
+    size_t n = ChronoLogFmt::render(fmt.c_str(), src, message, sizeof(message) - 1);
+    message[n] = '\0';
+
+    printf("%02u:%02u:%02u | %-15s | %s%-8s%s | %-16s | %s%s\n",
+           seconds / 3600, (seconds / 60) % 60, seconds % 60, module.c_str(), colors[level], names[level],
+           CHRONOLOG_COLOR_RESET, task.c_str(), message, truncated ? " [args truncated]" : "");
+  }
+};
+
+// Groups the chronolog_ids entries and the chronolog_fmt strings of an image by id.
+static int checkIds(const char* elfPath, const char* sectionName) {
+  std::vector<uint8_t> ids, fmt;
+  bool haveIds = loadSection(elfPath, "chronolog_ids", ids);
+  bool haveFmt = loadSection(elfPath, sectionName, fmt);
+  if (!haveIds && !haveFmt) {
+    fprintf(stderr, "chronolog_decode: no chronolog_ids or %s section in %s\n", sectionName, elfPath);
+    return 1;
+  }
+
+  std::map<uint32_t, std::set<uint32_t>>    checks;
+  std::map<uint32_t, std::set<std::string>> texts;
+  for (size_t at = 0; haveIds && at + sizeof(ChronoLogIdEntry) <= ids.size(); at += sizeof(ChronoLogIdEntry)) {
+    checks[readLe<uint32_t>(ids, at)].insert(readLe<uint32_t>(ids, at + 4));
+  }
+  for (size_t at = 0; haveFmt && at + 1 < fmt.size(); at += strlen((const char*)&fmt[at]) + 1) {
+    const char* text = (const char*)&fmt[at];
+    if (!*text) continue;
+    checks[chronoLogHash(text)].insert(chronoLogCheckHash(text));
+    texts[chronoLogHash(text)].insert(text);
+  }
+
+  int collisions = 0;
+  for (const auto& entry : checks) {
+    if (entry.second.size() < 2) continue;
+    collisions++;
+    fprintf(stderr, "chronolog_decode: id 0x%08x is shared by %zu distinct strings\n",
+            (unsigned)entry.first, entry.second.size());
+    for (const std::string& text : texts[entry.first]) fprintf(stderr, "    \"%s\"\n", text.c_str());
+  }
+  if (collisions) return 1;
+  printf("%zu ids, no collisions\n", checks.size());
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  const char* elfPath     = nullptr;
+  const char* sectionName = "chronolog_fmt";
+  const char* inputPath   = nullptr;
+  bool        check       = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-e") == 0 && i + 1 < argc)      elfPath = argv[++i];
+    else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) sectionName = argv[++i];
+    else if (strcmp(argv[i], "--check-ids") == 0)        check = true;
+    else if (argv[i][0] != '-' && !inputPath)            inputPath = argv[i];
+    else {
+      fprintf(stderr, "usage: %s [-e firmware.elf] [-s section] [input]\n"
+                      "       %s --check-ids -e firmware.elf\n", argv[0], argv[0]);
+      return 2;
+    }
+  }
+
+  if (check) {
+    if (!elfPath) {
+      fprintf(stderr, "chronolog_decode: --check-ids needs -e firmware.elf\n");
+      return 2;
+    }
+    return checkIds(elfPath, sectionName);
+  }
+
+  Decoder decoder;
+  if (elfPath && !loadSection(elfPath, sectionName, decoder.section)) {
+    fprintf(stderr, "chronolog_decode: no readable section '%s' in %s\n", sectionName, elfPath);
+    return 1;
+  }
+
+  FILE* in = inputPath ? fopen(inputPath, "rb") : stdin;
+  if (!in) {
+    perror(inputPath);
+    return 1;
+  }
+
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) {
+    decoder.feed(chunk, n);
+    fflush(stdout);
+  }
+  if (in != stdin) fclose(in);
+  return 0;
+}